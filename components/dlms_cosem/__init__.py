@@ -1,10 +1,14 @@
 import re
-from esphome import pins
+from esphome import automation, pins
 import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome.components import uart, binary_sensor
+from esphome.core import CORE
 from esphome.const import (
     CONF_ID,
+    CONF_ON_ERROR,
+    CONF_ON_VALUE,
+    CONF_TRIGGER_ID,
     CONF_AUTH,
     CONF_BAUD_RATE,
     CONF_RECEIVE_TIMEOUT,
@@ -17,8 +21,6 @@ CODEOWNERS = ["@latonita","@shammysha"]
 
 MULTI_CONF = True
 
-DEPENDENCIES = ["uart"]
-
 DEFAULTS_MAX_SENSOR_INDEX = 12
 DEFAULTS_BAUD_RATE_HANDSHAKE = 9600
 DEFAULTS_BAUD_RATE_SESSION = 9600
@@ -37,19 +39,36 @@ CONF_ADDRESS_LENGTH = "address_length"
 CONF_DELAY_BETWEEN_REQUESTS = "delay_between_requests"
 CONF_DONT_PUBLISH = "dont_publish"
 CONF_CP1251 = "cp1251"
+CONF_PUBLISH_ON_CHANGE = "publish_on_change"
+CONF_MAX_SILENCE = "max_silence"
 
 CONF_PUSH_MODE = "push_mode"
 CONF_PUSH_SHOW_LOG = "push_show_log"
 CONF_PUSH_CUSTOM_PATTERN = "push_custom_pattern"
+CONF_PUSH_MAX_NESTING = "push_max_nesting"
+CONF_PUSH_MAX_ELEMENTS = "push_max_elements"
+CONF_PUSH_MAX_PARSE_TIME = "push_max_parse_time"
+CONF_DECRYPTION_KEY = "decryption_key"
+CONF_AUTHENTICATION_KEY = "authentication_key"
 
 CONF_REBOOT_AFTER_FAILURE = "reboot_after_failure"
+CONF_TRACE_SIZE = "trace_size"
+CONF_CAPTURE_SIZE = "capture_size"
+CONF_RECEIVE_BUFFER_SIZE = "receive_buffer_size"
+CONF_LOOP_BUDGET = "loop_budget"
+CONF_COROUTINE_SESSION = "coroutine_session"
+CONF_ATTRIBUTE = "attribute"
+CONF_FAST_POLL_INTERVAL = "fast_poll_interval"
+CONF_FAST_POLL_MAX_BUS_UTILIZATION = "fast_poll_max_bus_utilization"
 
 CONF_BAUD_RATE_HANDSHAKE = "baud_rate_handshake"
+CONF_HOST_SERIAL_PORT = "host_serial_port"
 
 dlms_cosem_ns = cg.esphome_ns.namespace("dlms_cosem")
 DlmsCosem = dlms_cosem_ns.class_(
     "DlmsCosemComponent", cg.Component, uart.UARTDevice
 )
+ReadNowAction = dlms_cosem_ns.class_("ReadNowAction", automation.Action)
 
 BAUD_RATES = [300, 600, 1200, 2400, 4800, 9600, 19200]
 ADDRESS_LENGTH_ENUM = [1, 2, 4]
@@ -70,16 +89,30 @@ def obis_code(value):
     
     # Normalize to dot-separated format
     normalized = re.sub(r'[.\-:*]', '.', value)
+    if any(int(x) > 255 for x in normalized.split(".")):
+        raise cv.Invalid(f"{value} is not a valid OBIS code, each group is a byte (0..255)")
     return normalized
 
 
+def obis_bytes(value):
+    """Six OBIS groups for set_obis_code(a, b, c, d, e, f), so no string is kept on the device."""
+    return [int(x) for x in value.split(".")]
+
+
+def aes128_key(value):
+    value = cv.string_strict(value).replace(" ", "")
+    if re.match(r"^[0-9a-fA-F]{32}$", value) is None:
+        raise cv.Invalid("Key must be 32 hexadecimal characters (AES-128)")
+    return value.upper()
+
+
 def validate_meter_address(value):
     if len(value) > 15:
         raise cv.Invalid("Meter address length must be no longer than 15 characters")
     return value
 
 
-CONFIG_SCHEMA = cv.All(
+BASE_SCHEMA = (
     cv.Schema(
         {
             cv.GenerateID(): cv.declare_id(DlmsCosem),
@@ -114,19 +147,59 @@ CONFIG_SCHEMA = cv.All(
                 min=0, max=100
             ),
             cv.Optional(CONF_CP1251, default=True): cv.boolean,
+            cv.Optional(CONF_TRACE_SIZE, default=64): cv.int_range(min=0, max=4096),
+            cv.Optional(CONF_CAPTURE_SIZE, default=0): cv.int_range(min=0, max=32768),
+            cv.Optional(CONF_RECEIVE_BUFFER_SIZE): cv.int_range(min=64, max=32768),
+            cv.Optional(CONF_LOOP_BUDGET, default="10ms"): cv.All(
+                cv.positive_time_period_microseconds,
+                cv.Range(max=cv.TimePeriod(milliseconds=100)),
+            ),
+            cv.Optional(CONF_COROUTINE_SESSION, default=False): cv.boolean,
+            cv.Optional(
+                CONF_FAST_POLL_INTERVAL, default="5s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(
+                CONF_FAST_POLL_MAX_BUS_UTILIZATION, default="50%"
+            ): cv.percentage,
             cv.Optional(CONF_PUSH_MODE, default=False): cv.boolean,
             cv.Optional(CONF_PUSH_SHOW_LOG, default=False): cv.boolean,
             cv.Optional(CONF_PUSH_CUSTOM_PATTERN, default=""): cv.string,
+            cv.Optional(CONF_PUSH_MAX_NESTING, default=16): cv.int_range(min=1, max=64),
+            cv.Optional(CONF_PUSH_MAX_ELEMENTS, default=1000): cv.int_range(
+                min=1, max=65535
+            ),
+            cv.Optional(
+                CONF_PUSH_MAX_PARSE_TIME, default="30ms"
+            ): cv.All(
+                cv.positive_time_period_milliseconds,
+                cv.Range(min=cv.TimePeriod(milliseconds=1), max=cv.TimePeriod(seconds=2)),
+            ),
+            cv.Optional(CONF_DECRYPTION_KEY): aes128_key,
+            cv.Optional(CONF_AUTHENTICATION_KEY): aes128_key,
         }
     )
     .extend(cv.COMPONENT_SCHEMA)
-    .extend(uart.UART_DEVICE_SCHEMA)
 )
 
+
+def validate_serial_port(config):
+    # ESPHome UART on the boards, a tty or pty device on the host platform
+    if CORE.is_host:
+        return BASE_SCHEMA.extend(
+            {cv.Required(CONF_HOST_SERIAL_PORT): cv.string_strict}
+        )(config)
+    return BASE_SCHEMA.extend(uart.UART_DEVICE_SCHEMA)(config)
+
+
+CONFIG_SCHEMA = validate_serial_port
+
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
-    await uart.register_uart_device(var, config)
+    if CORE.is_host:
+        cg.add(var.set_host_serial_port(config[CONF_HOST_SERIAL_PORT]))
+    else:
+        await uart.register_uart_device(var, config)
 
     if flow_control_pin := config.get(CONF_FLOW_CONTROL_PIN):
         pin = await cg.gpio_pin_expression(flow_control_pin)
@@ -148,14 +221,87 @@ async def to_code(config):
     cg.add(var.set_update_interval(config[CONF_UPDATE_INTERVAL]))
     cg.add(var.set_reboot_after_failure(config[CONF_REBOOT_AFTER_FAILURE]))
     cg.add(var.set_cp1251_conversion_required(config[CONF_CP1251]))
+    cg.add(var.set_trace_size(config[CONF_TRACE_SIZE]))
+    cg.add(var.set_capture_size(config[CONF_CAPTURE_SIZE]))
+    if CONF_RECEIVE_BUFFER_SIZE in config:
+        cg.add(var.set_receive_buffer_size(config[CONF_RECEIVE_BUFFER_SIZE]))
+    cg.add(var.set_loop_budget(config[CONF_LOOP_BUDGET].total_microseconds))
+    if config[CONF_COROUTINE_SESSION]:
+        cg.add_build_flag("-DENABLE_DLMS_COSEM_COROUTINES")
+        # gcc 10 needs it on top of -std=gnu++20
+        cg.add_build_flag("-fcoroutines")
+    cg.add(
+        var.set_fast_poll(
+            config[CONF_FAST_POLL_INTERVAL],
+            config[CONF_FAST_POLL_MAX_BUS_UTILIZATION],
+        )
+    )
 
     if config[CONF_PUSH_MODE] == True:
         cg.add_build_flag("-DENABLE_DLMS_COSEM_PUSH_MODE")
         cg.add(var.set_push_mode(config[CONF_PUSH_MODE]))
         cg.add(var.set_push_show_log(config[CONF_PUSH_SHOW_LOG]))
         cg.add(var.set_push_custom_pattern_dsl(config[CONF_PUSH_CUSTOM_PATTERN]))
+        cg.add(
+            var.set_push_parse_budget(
+                config[CONF_PUSH_MAX_NESTING],
+                config[CONF_PUSH_MAX_ELEMENTS],
+                config[CONF_PUSH_MAX_PARSE_TIME],
+            )
+        )
+        if decryption_key := config.get(CONF_DECRYPTION_KEY):
+            cg.add(var.set_decryption_key(decryption_key))
+        if authentication_key := config.get(CONF_AUTHENTICATION_KEY):
+            cg.add(var.set_authentication_key(authentication_key))
     
     #cg.add_build_flag("-Wno-error=implicit-function-declaration")
     cg.add_library("GuruxDLMS", None, "https://github.com/latonita/GuruxDLMS.c")
     # Its a hard-copy of this one, which is a 2-y.o. fork of official gurux repo + platformio json lib file
     # cg.add_library("GuruxDLMS", None, "https://github.com/viric/GuruxDLMS.c#platformio")
+
+
+@automation.register_action(
+    "dlms_cosem.read_now",
+    ReadNowAction,
+    cv.Schema(
+        {
+            cv.GenerateID(): cv.use_id(DlmsCosem),
+            # a lambda must return the A.B.C.D.E.F form
+            cv.Required(CONF_OBIS_CODE): cv.templatable(obis_code),
+            cv.Optional(CONF_OBIS_CLASS, default=3): cv.one_of(1, 3, 8, int=True),
+            cv.Optional(CONF_ATTRIBUTE, default=2): cv.int_range(min=1, max=255),
+            cv.Optional(CONF_ON_VALUE): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(
+                        automation.Trigger.template(cg.float_, cg.std_string)
+                    ),
+                }
+            ),
+            cv.Optional(CONF_ON_ERROR): automation.validate_automation(
+                {
+                    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(
+                        automation.Trigger.template(cg.int_)
+                    ),
+                }
+            ),
+        }
+    ),
+)
+async def read_now_action_to_code(config, action_id, template_arg, args):
+    var = cg.new_Pvariable(action_id, template_arg)
+    await cg.register_parented(var, config[CONF_ID])
+    templ = await cg.templatable(config[CONF_OBIS_CODE], args, cg.std_string)
+    cg.add(var.set_obis_code(templ))
+    cg.add(var.set_class_id(config[CONF_OBIS_CLASS]))
+    cg.add(var.set_attribute(config[CONF_ATTRIBUTE]))
+    for conf in config.get(CONF_ON_VALUE, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID])
+        cg.add(var.set_value_trigger(trigger))
+        await automation.build_automation(
+            trigger, [(cg.float_, "x"), (cg.std_string, "text")], conf
+        )
+    for conf in config.get(CONF_ON_ERROR, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID])
+        cg.add(var.set_error_trigger(trigger))
+        await automation.build_automation(trigger, [(cg.int_, "error")], conf)
+    return var
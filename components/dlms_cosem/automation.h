@@ -0,0 +1,49 @@
+#pragma once
+
+#include "esphome/core/automation.h"
+#include "dlms_cosem.h"
+
+#include <cmath>
+#include <string>
+
+namespace esphome {
+namespace dlms_cosem {
+
+// dlms_cosem.read_now: queues DlmsCosemComponent::read_now(), sensors with the OBIS code get the value.
+// on_value gets the raw value (NAN if not a number) and its text, on_error the DLMS error code.
+template<typename... Ts> class ReadNowAction : public Action<Ts...>, public Parented<DlmsCosemComponent> {
+ public:
+  TEMPLATABLE_VALUE(std::string, obis_code)
+  void set_class_id(uint16_t class_id) { this->class_id_ = class_id; }
+  void set_attribute(uint8_t attribute) { this->attribute_ = attribute; }
+  void set_value_trigger(Trigger<float, std::string> *trigger) { this->value_trigger_ = trigger; }
+  void set_error_trigger(Trigger<int> *trigger) { this->error_trigger_ = trigger; }
+
+  void play(Ts... x) override {
+    const auto obis = this->obis_code_.value(x...);
+    DlmsCosemComponent::ReadNowCallback callback = nullptr;
+    if (this->value_trigger_ != nullptr || this->error_trigger_ != nullptr) {
+      callback = [this](int error, double value, const char *text) { this->report_(error, value, text); };
+    }
+    if (!this->parent_->read_now(obis.c_str(), this->class_id_, this->attribute_, std::move(callback)))
+      this->report_(DLMS_ERROR_CODE_INVALID_PARAMETER, NAN, "");
+  }
+
+ protected:
+  void report_(int error, double value, const char *text) {
+    if (error == DLMS_ERROR_CODE_OK) {
+      if (this->value_trigger_ != nullptr)
+        this->value_trigger_->trigger(static_cast<float>(value), text);
+    } else if (this->error_trigger_ != nullptr) {
+      this->error_trigger_->trigger(error);
+    }
+  }
+
+  uint16_t class_id_{3};
+  uint8_t attribute_{2};
+  Trigger<float, std::string> *value_trigger_{nullptr};
+  Trigger<int> *error_trigger_{nullptr};
+};
+
+}  // namespace dlms_cosem
+}  // namespace esphome
@@ -2,6 +2,7 @@
 
 #include "axdr_parser.h"
 #include "esphome/core/log.h"
+#include "esphome/core/hal.h"
 #include "esphome/core/helpers.h"
 #include <cstring>
 #include <sstream>
@@ -209,17 +210,49 @@ bool AxdrStreamParser::skip_sequence_(uint8_t type) {
 
 bool AxdrStreamParser::parse_data_(uint8_t type, uint8_t depth) { return skip_data_(type); }
 
+bool AxdrStreamParser::check_budget_(uint8_t depth) {
+  if (this->budget_exceeded_)
+    return false;
+  const char *reason = nullptr;
+  if (depth > this->budget_.max_depth) {
+    reason = "nesting depth";
+  } else if (++this->frame_elements_ > this->budget_.max_elements) {
+    reason = "element count";
+  } else if (micros() - this->frame_start_us_ > this->budget_.max_time_us) {
+    reason = "parse time";
+  }
+  if (reason == nullptr)
+    return true;
+
+  ESP_LOGW(TAG, "Push frame exceeds %s limit at position %d, abandoning it", reason, this->buffer_->position);
+  this->budget_exceeded_ = true;
+  this->stats_.budget_aborts++;
+  return false;
+}
+
 bool AxdrStreamParser::parse_sequence_(uint8_t type, uint8_t depth) {
   uint8_t elements_count = read_byte_();
   if (elements_count == 0xFF) {
     ESP_LOGVV(TAG, "Invalid sequence length at position %d", this->buffer_->position - 1);
     return false;
   }
+  // every element takes at least one byte
+  if (elements_count > this->buffer_->size - this->buffer_->position) {
+    ESP_LOGV(TAG, "%s announces %d elements, only %d bytes left",
+             (type == DLMS_DATA_TYPE_STRUCTURE) ? "STRUCTURE" : "ARRAY", elements_count,
+             this->buffer_->size - this->buffer_->position);
+    return false;
+  }
 
   uint8_t elements_consumed = 0;
+  if (depth > this->stats_.max_depth)
+    this->stats_.max_depth = depth;
 
   while (elements_consumed < elements_count) {
+    if (!this->check_budget_(depth))
+      return false;
     uint32_t original_position = this->buffer_->position;
+    this->stats_.elements++;
 
     if (try_match_patterns_(elements_consumed)) {
       uint8_t used = this->last_pattern_elements_consumed_ ? this->last_pattern_elements_consumed_ : 1;
@@ -257,6 +290,13 @@ bool AxdrStreamParser::parse_element_(uint8_t type, uint8_t depth) {
   }
 }
 
+void AxdrStreamParser::begin_frame() {
+  this->frame_start_us_ = micros();
+  this->frame_elements_ = 0;
+  this->budget_exceeded_ = false;
+  this->stats_.frames++;
+}
+
 size_t AxdrStreamParser::parse() {
   if (this->buffer_ == nullptr || this->buffer_->size == 0) {
     ESP_LOGV(TAG, "Buffer is null or empty");
@@ -264,6 +304,9 @@ size_t AxdrStreamParser::parse() {
   }
 
   ESP_LOGI(TAG, "Starting fast AXDR parsing of %d bytes", this->buffer_->size);
+  const uint32_t start_us = micros();
+  const uint32_t start_pos = this->buffer_->position;
+  this->objects_found_ = 0;
 
   // Skip to notification flag 0x0F
   while (this->buffer_->position < this->buffer_->size) {
@@ -299,6 +342,17 @@ size_t AxdrStreamParser::parse() {
   if (!success) {
     ESP_LOGV(TAG, "Some errors occurred parsing AXDR data");
   }
+  if (this->budget_exceeded_) {
+    // nothing after an abandoned frame is trustworthy
+    this->buffer_->position = this->buffer_->size;
+  }
+
+  const uint32_t now = micros();
+  this->stats_.objects += this->objects_found_;
+  this->stats_.bytes += this->buffer_->position - start_pos;
+  this->stats_.total_us += now - start_us;
+  if (now - this->frame_start_us_ > this->stats_.max_us)
+    this->stats_.max_us = now - this->frame_start_us_;
 
   ESP_LOGI(TAG, "Fast parsing completed, processed %d bytes", this->buffer_->position);
   return this->objects_found_;
@@ -406,6 +460,8 @@ bool AxdrStreamParser::match_pattern_(uint8_t elem_idx, const AxdrDescriptorPatt
             v > MAX_CLASS_ID)
           return false;
         cap.class_id = v;
+        if (step.param_u8_b == UNTAGGED_ELEMENT)
+          consume_one();
         break;
       }
       case AxdrTokenType::EXPECT_OBIS6_TAGGED: {
@@ -427,6 +483,8 @@ bool AxdrStreamParser::match_pattern_(uint8_t elem_idx, const AxdrDescriptorPatt
           return false;
         cap.obis = &this->buffer_->data[this->buffer_->position];
         this->buffer_->position += 6;
+        if (step.param_u8_b == UNTAGGED_ELEMENT)
+          consume_one();
         break;
       }
       case AxdrTokenType::EXPECT_ATTR8_UNTAGGED: {
@@ -434,6 +492,8 @@ bool AxdrStreamParser::match_pattern_(uint8_t elem_idx, const AxdrDescriptorPatt
         if (a == 0)
           return false;
         //        cap.attr_id = a;
+        if (step.param_u8_b == UNTAGGED_ELEMENT)
+          consume_one();
         break;
       }
       case AxdrTokenType::EXPECT_VALUE_GENERIC: {
@@ -504,6 +564,7 @@ bool AxdrStreamParser::try_match_patterns_(uint8_t elem_idx) {
   for (const auto &p : pats) {
     uint8_t consumed = 0;
     uint32_t saved_position = buffer_->position;
+    this->stats_.pattern_attempts++;
     if (match_pattern_(elem_idx, p, consumed)) {
       this->last_pattern_elements_consumed_ = consumed;
       return true;
@@ -518,7 +579,7 @@ void AxdrStreamParser::register_pattern_dsl(const char *name, const std::string
   AxdrDescriptorPattern pat{name, priority, {}, 0};
   // DSL tokens separated by commas, optional spaces. Supported atoms:
   // F   : must be first element in sequence
-  // C   : raw class_id (uint16 payload, no type tag)
+  // C   : raw class_id (uint16 payload, no type tag), counts as one structure element like O and A
   // TC  : tagged class_id (type tag UINT16 + uint16 payload)
   // O   : raw OBIS (6 bytes payload, no type tag)
   // TO  : tagged OBIS (type tag OCTET_STRING + length=6 + 6 bytes)
@@ -569,16 +630,16 @@ void AxdrStreamParser::register_pattern_dsl(const char *name, const std::string
     if (tok == "F") {
       pat.steps.push_back({AxdrTokenType::EXPECT_TO_BE_FIRST});
     } else if (tok == "C") {
-      pat.steps.push_back({AxdrTokenType::EXPECT_CLASS_ID_UNTAGGED});
+      pat.steps.push_back({AxdrTokenType::EXPECT_CLASS_ID_UNTAGGED, 0, UNTAGGED_ELEMENT});
     } else if (tok == "TC") {
       pat.steps.push_back({AxdrTokenType::EXPECT_TYPE_EXACT, (uint8_t) DLMS_DATA_TYPE_UINT16});
       pat.steps.push_back({AxdrTokenType::EXPECT_CLASS_ID_UNTAGGED});
     } else if (tok == "O") {
-      pat.steps.push_back({AxdrTokenType::EXPECT_OBIS6_UNTAGGED});
+      pat.steps.push_back({AxdrTokenType::EXPECT_OBIS6_UNTAGGED, 0, UNTAGGED_ELEMENT});
     } else if (tok == "TO") {
       pat.steps.push_back({AxdrTokenType::EXPECT_OBIS6_TAGGED});
     } else if (tok == "A") {
-      pat.steps.push_back({AxdrTokenType::EXPECT_ATTR8_UNTAGGED});
+      pat.steps.push_back({AxdrTokenType::EXPECT_ATTR8_UNTAGGED, 0, UNTAGGED_ELEMENT});
     } else if (tok == "TA") {
       pat.steps.push_back({AxdrTokenType::EXPECT_TYPE_U_I_8});
       pat.steps.push_back({AxdrTokenType::EXPECT_ATTR8_UNTAGGED});
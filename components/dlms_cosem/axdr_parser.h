@@ -22,6 +22,8 @@ using CosemObjectFoundCallback =
                        uint8_t value_len, const int8_t *scaler, const uint8_t *unit)>;
 
 constexpr uint8_t PUT_BYTE_BACK = 1;
+// param_u8_b of an untagged step that stands for a whole structure element (C, O, A in the DSL)
+constexpr uint8_t UNTAGGED_ELEMENT = 1;
 
 enum class AxdrTokenType : uint8_t {
   EXPECT_TO_BE_FIRST,
@@ -79,6 +81,25 @@ class AxdrPatternRegistry {
   std::vector<AxdrDescriptorPattern> patterns_{};
 };
 
+struct AxdrParserStats {
+  uint32_t frames{0};           // telegrams, see begin_frame()
+  uint32_t objects{0};
+  uint32_t bytes{0};
+  uint32_t elements{0};          // sequence elements visited
+  uint32_t pattern_attempts{0};  // match_pattern_ calls
+  uint8_t max_depth{0};
+  uint32_t total_us{0};
+  uint32_t max_us{0};            // slowest telegram
+  uint32_t budget_aborts{0};     // frames abandoned for exceeding the parse budget
+};
+
+// Upper bounds for one telegram, however many parse() calls it takes; a telegram exceeding any of them is abandoned
+struct AxdrParseBudget {
+  uint8_t max_depth{16};
+  uint16_t max_elements{1000};
+  uint32_t max_time_us{30000};
+};
+
 class AxdrStreamParser {
   gxByteBuffer *buffer_;
   CosemObjectFoundCallback callback_;
@@ -87,6 +108,13 @@ class AxdrStreamParser {
 
   AxdrPatternRegistry registry_{};
   uint8_t last_pattern_elements_consumed_{0};
+  AxdrParserStats stats_{};
+  AxdrParseBudget budget_{};
+  uint32_t frame_start_us_{0};
+  uint32_t frame_elements_{0};
+  bool budget_exceeded_{false};
+
+  bool check_budget_(uint8_t depth);
 
   uint8_t peek_byte_();
   uint8_t read_byte_();
@@ -110,9 +138,13 @@ class AxdrStreamParser {
  public:
   AxdrStreamParser(gxByteBuffer *buf, CosemObjectFoundCallback callback, bool show_log)
       : buffer_(buf), callback_(callback), show_log_(show_log) {}
+  // starts a telegram: the parse budget and per-telegram statistics cover every parse() call until the next one
+  void begin_frame();
   size_t parse();
   void register_pattern_dsl(const char *name, const std::string &dsl, int priority = 10);
   void clear_patterns() { registry_.clear(); }
+  const AxdrParserStats &stats() const { return stats_; }
+  void set_budget(const AxdrParseBudget &budget) { budget_ = budget; }
 };
 
 
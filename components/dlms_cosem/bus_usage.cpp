@@ -0,0 +1,21 @@
+#include "bus_usage.h"
+
+namespace esphome {
+namespace dlms_cosem {
+
+BusUsage BusUsage::buses_[BusUsage::MAX_BUSES];
+
+BusUsage *BusUsage::get(const void *bus) {
+  for (auto &b : buses_) {
+    if (b.bus == bus)
+      return &b;
+    if (b.bus == nullptr) {
+      b.bus = bus;
+      return &b;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace dlms_cosem
+}  // namespace esphome
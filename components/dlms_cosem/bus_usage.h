@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace dlms_cosem {
+
+/**
+ * Time accounting of one UART bus, shared by all meters on it. Counters only grow;
+ * every component keeps its own snapshot and reports the difference over its own interval.
+ * TX and RX time is derived from byte counts at the current baud rate (10 bits per byte).
+ */
+struct BusUsage {
+  const void *bus{nullptr};
+  uint8_t meters{0};
+  uint64_t tx_us{0};
+  uint64_t rx_us{0};
+  uint64_t turnaround_us{0};  // request sent, waiting for the first reply byte
+  uint64_t contention_us{0};  // waiting for another meter to release the bus
+  uint64_t session_us{0};     // bus held by a session
+  uint32_t sessions{0};
+
+  // entry for bus, created on first use; nullptr once all slots are taken
+  static BusUsage *get(const void *bus);
+
+  static uint32_t byte_time_us(size_t bytes, uint32_t baud_rate) {
+    return baud_rate ? (uint32_t) ((uint64_t) bytes * 10 * 1000000 / baud_rate) : 0;
+  }
+
+ protected:
+  static constexpr size_t MAX_BUSES = 4;
+  static BusUsage buses_[MAX_BUSES];
+};
+
+}  // namespace dlms_cosem
+}  // namespace esphome
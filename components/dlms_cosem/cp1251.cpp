@@ -0,0 +1,97 @@
+#include "cp1251.h"
+
+#include <cstring>
+
+namespace esphome {
+namespace dlms_cosem {
+
+namespace {
+
+struct Utf8Seq {
+  uint8_t len;
+  uint8_t bytes[CP1251_UTF8_MAX_BYTES];
+};
+
+// UTF-8 for 0x80..0xFF, the unassigned 0x98 becomes U+FFFD
+const Utf8Seq CP1251_HIGH[128] = {
+    {2, {0xD0, 0x82, 0x00}}, {2, {0xD0, 0x83, 0x00}}, {3, {0xE2, 0x80, 0x9A}}, {2, {0xD1, 0x93, 0x00}},  // 0x80
+    {3, {0xE2, 0x80, 0x9E}}, {3, {0xE2, 0x80, 0xA6}}, {3, {0xE2, 0x80, 0xA0}}, {3, {0xE2, 0x80, 0xA1}},  // 0x84
+    {3, {0xE2, 0x82, 0xAC}}, {3, {0xE2, 0x80, 0xB0}}, {2, {0xD0, 0x89, 0x00}}, {3, {0xE2, 0x80, 0xB9}},  // 0x88
+    {2, {0xD0, 0x8A, 0x00}}, {2, {0xD0, 0x8C, 0x00}}, {2, {0xD0, 0x8B, 0x00}}, {2, {0xD0, 0x8F, 0x00}},  // 0x8C
+    {2, {0xD1, 0x92, 0x00}}, {3, {0xE2, 0x80, 0x98}}, {3, {0xE2, 0x80, 0x99}}, {3, {0xE2, 0x80, 0x9C}},  // 0x90
+    {3, {0xE2, 0x80, 0x9D}}, {3, {0xE2, 0x80, 0xA2}}, {3, {0xE2, 0x80, 0x93}}, {3, {0xE2, 0x80, 0x94}},  // 0x94
+    {3, {0xEF, 0xBF, 0xBD}}, {3, {0xE2, 0x84, 0xA2}}, {2, {0xD1, 0x99, 0x00}}, {3, {0xE2, 0x80, 0xBA}},  // 0x98
+    {2, {0xD1, 0x9A, 0x00}}, {2, {0xD1, 0x9C, 0x00}}, {2, {0xD1, 0x9B, 0x00}}, {2, {0xD1, 0x9F, 0x00}},  // 0x9C
+    {2, {0xC2, 0xA0, 0x00}}, {2, {0xD0, 0x8E, 0x00}}, {2, {0xD1, 0x9E, 0x00}}, {2, {0xD0, 0x88, 0x00}},  // 0xA0
+    {2, {0xC2, 0xA4, 0x00}}, {2, {0xD2, 0x90, 0x00}}, {2, {0xC2, 0xA6, 0x00}}, {2, {0xC2, 0xA7, 0x00}},  // 0xA4
+    {2, {0xD0, 0x81, 0x00}}, {2, {0xC2, 0xA9, 0x00}}, {2, {0xD0, 0x84, 0x00}}, {2, {0xC2, 0xAB, 0x00}},  // 0xA8
+    {2, {0xC2, 0xAC, 0x00}}, {2, {0xC2, 0xAD, 0x00}}, {2, {0xC2, 0xAE, 0x00}}, {2, {0xD0, 0x87, 0x00}},  // 0xAC
+    {2, {0xC2, 0xB0, 0x00}}, {2, {0xC2, 0xB1, 0x00}}, {2, {0xD0, 0x86, 0x00}}, {2, {0xD1, 0x96, 0x00}},  // 0xB0
+    {2, {0xD2, 0x91, 0x00}}, {2, {0xC2, 0xB5, 0x00}}, {2, {0xC2, 0xB6, 0x00}}, {2, {0xC2, 0xB7, 0x00}},  // 0xB4
+    {2, {0xD1, 0x91, 0x00}}, {3, {0xE2, 0x84, 0x96}}, {2, {0xD1, 0x94, 0x00}}, {2, {0xC2, 0xBB, 0x00}},  // 0xB8
+    {2, {0xD1, 0x98, 0x00}}, {2, {0xD0, 0x85, 0x00}}, {2, {0xD1, 0x95, 0x00}}, {2, {0xD1, 0x97, 0x00}},  // 0xBC
+    {2, {0xD0, 0x90, 0x00}}, {2, {0xD0, 0x91, 0x00}}, {2, {0xD0, 0x92, 0x00}}, {2, {0xD0, 0x93, 0x00}},  // 0xC0
+    {2, {0xD0, 0x94, 0x00}}, {2, {0xD0, 0x95, 0x00}}, {2, {0xD0, 0x96, 0x00}}, {2, {0xD0, 0x97, 0x00}},  // 0xC4
+    {2, {0xD0, 0x98, 0x00}}, {2, {0xD0, 0x99, 0x00}}, {2, {0xD0, 0x9A, 0x00}}, {2, {0xD0, 0x9B, 0x00}},  // 0xC8
+    {2, {0xD0, 0x9C, 0x00}}, {2, {0xD0, 0x9D, 0x00}}, {2, {0xD0, 0x9E, 0x00}}, {2, {0xD0, 0x9F, 0x00}},  // 0xCC
+    {2, {0xD0, 0xA0, 0x00}}, {2, {0xD0, 0xA1, 0x00}}, {2, {0xD0, 0xA2, 0x00}}, {2, {0xD0, 0xA3, 0x00}},  // 0xD0
+    {2, {0xD0, 0xA4, 0x00}}, {2, {0xD0, 0xA5, 0x00}}, {2, {0xD0, 0xA6, 0x00}}, {2, {0xD0, 0xA7, 0x00}},  // 0xD4
+    {2, {0xD0, 0xA8, 0x00}}, {2, {0xD0, 0xA9, 0x00}}, {2, {0xD0, 0xAA, 0x00}}, {2, {0xD0, 0xAB, 0x00}},  // 0xD8
+    {2, {0xD0, 0xAC, 0x00}}, {2, {0xD0, 0xAD, 0x00}}, {2, {0xD0, 0xAE, 0x00}}, {2, {0xD0, 0xAF, 0x00}},  // 0xDC
+    {2, {0xD0, 0xB0, 0x00}}, {2, {0xD0, 0xB1, 0x00}}, {2, {0xD0, 0xB2, 0x00}}, {2, {0xD0, 0xB3, 0x00}},  // 0xE0
+    {2, {0xD0, 0xB4, 0x00}}, {2, {0xD0, 0xB5, 0x00}}, {2, {0xD0, 0xB6, 0x00}}, {2, {0xD0, 0xB7, 0x00}},  // 0xE4
+    {2, {0xD0, 0xB8, 0x00}}, {2, {0xD0, 0xB9, 0x00}}, {2, {0xD0, 0xBA, 0x00}}, {2, {0xD0, 0xBB, 0x00}},  // 0xE8
+    {2, {0xD0, 0xBC, 0x00}}, {2, {0xD0, 0xBD, 0x00}}, {2, {0xD0, 0xBE, 0x00}}, {2, {0xD0, 0xBF, 0x00}},  // 0xEC
+    {2, {0xD1, 0x80, 0x00}}, {2, {0xD1, 0x81, 0x00}}, {2, {0xD1, 0x82, 0x00}}, {2, {0xD1, 0x83, 0x00}},  // 0xF0
+    {2, {0xD1, 0x84, 0x00}}, {2, {0xD1, 0x85, 0x00}}, {2, {0xD1, 0x86, 0x00}}, {2, {0xD1, 0x87, 0x00}},  // 0xF4
+    {2, {0xD1, 0x88, 0x00}}, {2, {0xD1, 0x89, 0x00}}, {2, {0xD1, 0x8A, 0x00}}, {2, {0xD1, 0x8B, 0x00}},  // 0xF8
+    {2, {0xD1, 0x8C, 0x00}}, {2, {0xD1, 0x8D, 0x00}}, {2, {0xD1, 0x8E, 0x00}}, {2, {0xD1, 0x8F, 0x00}},  // 0xFC
+};
+
+}  // namespace
+
+size_t cp1251_to_utf8(const uint8_t *src, size_t len, char *dst, size_t dst_size) {
+  if (dst_size == 0)
+    return 0;
+  const size_t cap = dst_size - 1;
+  size_t in = 0;
+  size_t out = 0;
+
+  while (in < len) {
+    uint8_t c = src[in];
+    if (c < 0x80) {
+      // ASCII fast path, only tried from an ASCII byte so Cyrillic text does not pay for it
+      while (in + sizeof(uint32_t) <= len && out + sizeof(uint32_t) <= cap) {
+        uint32_t word;
+        memcpy(&word, src + in, sizeof(word));
+        if (word & 0x80808080u)
+          break;
+        memcpy(dst + out, &word, sizeof(word));
+        in += sizeof(word);
+        out += sizeof(word);
+      }
+      if (in >= len)
+        break;
+      c = src[in];
+    }
+
+    if (c < 0x80) {
+      if (out + 1 > cap)
+        break;
+      dst[out++] = (char) c;
+    } else {
+      const Utf8Seq &seq = CP1251_HIGH[c - 0x80];
+      if (out + seq.len > cap)
+        break;
+      memcpy(dst + out, seq.bytes, seq.len);
+      out += seq.len;
+    }
+    in++;
+  }
+
+  dst[out] = '\0';
+  return out;
+}
+
+}  // namespace dlms_cosem
+}  // namespace esphome
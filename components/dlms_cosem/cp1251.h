@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace dlms_cosem {
+
+// Longest UTF-8 sequence a single CP1251 byte turns into
+static constexpr size_t CP1251_UTF8_MAX_BYTES = 3;
+
+/**
+ * Transcodes CP1251 to UTF-8 in one pass, ASCII runs are copied a word at a time.
+ * Writes at most dst_size - 1 bytes plus a terminating NUL, never splitting a sequence,
+ * and returns the number of bytes written. dst must not overlap src.
+ */
+size_t cp1251_to_utf8(const uint8_t *src, size_t len, char *dst, size_t dst_size);
+
+}  // namespace dlms_cosem
+}  // namespace esphome
@@ -0,0 +1,287 @@
+#ifdef ENABLE_DLMS_COSEM_PUSH_MODE
+
+#include "dlms_cipher.h"
+#include "esphome/core/log.h"
+#include <cstring>
+
+namespace esphome {
+namespace dlms_cosem {
+
+constexpr const char *TAG = "dlms_cosem.cipher";
+
+static constexpr uint8_t SC_AUTHENTICATION = 0x10;
+static constexpr uint8_t SC_ENCRYPTION = 0x20;
+static constexpr uint8_t SC_COMPRESSION = 0x80;
+static constexpr uint8_t SC_SUITE_MASK = 0x0F;
+
+static inline void inc32(uint8_t *counter) {
+  for (int i = 15; i >= 12; i--)
+    if (++counter[i] != 0)
+      break;
+}
+
+#ifndef USE_ESP32
+// clang-format off
+static const uint8_t AES_SBOX[256] = {
+  0x63, 0x7c, 0x77, 0x7b, 0xf2, 0x6b, 0x6f, 0xc5, 0x30, 0x01, 0x67, 0x2b, 0xfe, 0xd7, 0xab, 0x76,
+  0xca, 0x82, 0xc9, 0x7d, 0xfa, 0x59, 0x47, 0xf0, 0xad, 0xd4, 0xa2, 0xaf, 0x9c, 0xa4, 0x72, 0xc0,
+  0xb7, 0xfd, 0x93, 0x26, 0x36, 0x3f, 0xf7, 0xcc, 0x34, 0xa5, 0xe5, 0xf1, 0x71, 0xd8, 0x31, 0x15,
+  0x04, 0xc7, 0x23, 0xc3, 0x18, 0x96, 0x05, 0x9a, 0x07, 0x12, 0x80, 0xe2, 0xeb, 0x27, 0xb2, 0x75,
+  0x09, 0x83, 0x2c, 0x1a, 0x1b, 0x6e, 0x5a, 0xa0, 0x52, 0x3b, 0xd6, 0xb3, 0x29, 0xe3, 0x2f, 0x84,
+  0x53, 0xd1, 0x00, 0xed, 0x20, 0xfc, 0xb1, 0x5b, 0x6a, 0xcb, 0xbe, 0x39, 0x4a, 0x4c, 0x58, 0xcf,
+  0xd0, 0xef, 0xaa, 0xfb, 0x43, 0x4d, 0x33, 0x85, 0x45, 0xf9, 0x02, 0x7f, 0x50, 0x3c, 0x9f, 0xa8,
+  0x51, 0xa3, 0x40, 0x8f, 0x92, 0x9d, 0x38, 0xf5, 0xbc, 0xb6, 0xda, 0x21, 0x10, 0xff, 0xf3, 0xd2,
+  0xcd, 0x0c, 0x13, 0xec, 0x5f, 0x97, 0x44, 0x17, 0xc4, 0xa7, 0x7e, 0x3d, 0x64, 0x5d, 0x19, 0x73,
+  0x60, 0x81, 0x4f, 0xdc, 0x22, 0x2a, 0x90, 0x88, 0x46, 0xee, 0xb8, 0x14, 0xde, 0x5e, 0x0b, 0xdb,
+  0xe0, 0x32, 0x3a, 0x0a, 0x49, 0x06, 0x24, 0x5c, 0xc2, 0xd3, 0xac, 0x62, 0x91, 0x95, 0xe4, 0x79,
+  0xe7, 0xc8, 0x37, 0x6d, 0x8d, 0xd5, 0x4e, 0xa9, 0x6c, 0x56, 0xf4, 0xea, 0x65, 0x7a, 0xae, 0x08,
+  0xba, 0x78, 0x25, 0x2e, 0x1c, 0xa6, 0xb4, 0xc6, 0xe8, 0xdd, 0x74, 0x1f, 0x4b, 0xbd, 0x8b, 0x8a,
+  0x70, 0x3e, 0xb5, 0x66, 0x48, 0x03, 0xf6, 0x0e, 0x61, 0x35, 0x57, 0xb9, 0x86, 0xc1, 0x1d, 0x9e,
+  0xe1, 0xf8, 0x98, 0x11, 0x69, 0xd9, 0x8e, 0x94, 0x9b, 0x1e, 0x87, 0xe9, 0xce, 0x55, 0x28, 0xdf,
+  0x8c, 0xa1, 0x89, 0x0d, 0xbf, 0xe6, 0x42, 0x68, 0x41, 0x99, 0x2d, 0x0f, 0xb0, 0x54, 0xbb, 0x16,
+};
+// clang-format on
+
+static inline uint8_t xtime(uint8_t x) { return (uint8_t) ((x << 1) ^ ((x & 0x80) ? 0x1B : 0x00)); }
+#endif
+
+void DlmsCipher::set_decryption_key(const uint8_t *key) {
+#ifdef USE_ESP32
+  mbedtls_aes_setkey_enc(&this->aes_ctx_, key, KEY_SIZE * 8);
+#else
+  static const uint8_t RCON[10] = {0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1B, 0x36};
+  memcpy(this->round_keys_, key, KEY_SIZE);
+  for (int i = 4; i < 44; i++) {
+    uint8_t t[4];
+    memcpy(t, &this->round_keys_[(i - 1) * 4], 4);
+    if (i % 4 == 0) {
+      uint8_t t0 = t[0];
+      t[0] = AES_SBOX[t[1]] ^ RCON[i / 4 - 1];
+      t[1] = AES_SBOX[t[2]];
+      t[2] = AES_SBOX[t[3]];
+      t[3] = AES_SBOX[t0];
+    }
+    for (int j = 0; j < 4; j++)
+      this->round_keys_[i * 4 + j] = this->round_keys_[(i - 4) * 4 + j] ^ t[j];
+  }
+#endif
+  uint8_t zero[16]{};
+  this->aes_encrypt_block_(zero, this->h_);
+  this->has_ek_ = true;
+}
+
+void DlmsCipher::set_authentication_key(const uint8_t *key) {
+  memcpy(this->ak_, key, KEY_SIZE);
+  this->has_ak_ = true;
+}
+
+#ifdef USE_ESP32
+void DlmsCipher::aes_encrypt_block_(const uint8_t *in, uint8_t *out) {
+  mbedtls_aes_crypt_ecb(&this->aes_ctx_, MBEDTLS_AES_ENCRYPT, in, out);
+}
+
+void DlmsCipher::aes_ctr_(uint8_t *counter, uint8_t *data, size_t len) {
+  // mbedtls increments the whole 128-bit counter; with a 96-bit IV this only differs from
+  // GCM's inc32 after 2^32 blocks
+  size_t nc_off = 0;
+  uint8_t stream_block[16];
+  mbedtls_aes_crypt_ctr(&this->aes_ctx_, len, &nc_off, counter, stream_block, data, data);
+}
+#else
+void DlmsCipher::aes_encrypt_block_(const uint8_t *in, uint8_t *out) {
+  uint8_t s[16];
+  for (int i = 0; i < 16; i++)
+    s[i] = in[i] ^ this->round_keys_[i];
+
+  for (int round = 1; round <= 10; round++) {
+    uint8_t t[16];
+    // SubBytes + ShiftRows
+    for (int c = 0; c < 4; c++)
+      for (int r = 0; r < 4; r++)
+        t[c * 4 + r] = AES_SBOX[s[((c + r) % 4) * 4 + r]];
+    // MixColumns (not in the last round)
+    if (round < 10) {
+      for (int c = 0; c < 4; c++) {
+        uint8_t *col = &t[c * 4];
+        uint8_t a0 = col[0], a1 = col[1], a2 = col[2], a3 = col[3];
+        uint8_t all = a0 ^ a1 ^ a2 ^ a3;
+        col[0] ^= all ^ xtime(a0 ^ a1);
+        col[1] ^= all ^ xtime(a1 ^ a2);
+        col[2] ^= all ^ xtime(a2 ^ a3);
+        col[3] ^= all ^ xtime(a3 ^ a0);
+      }
+    }
+    const uint8_t *rk = &this->round_keys_[round * 16];
+    for (int i = 0; i < 16; i++)
+      s[i] = t[i] ^ rk[i];
+  }
+  memcpy(out, s, 16);
+}
+
+void DlmsCipher::aes_ctr_(uint8_t *counter, uint8_t *data, size_t len) {
+  uint8_t ks[16];
+  while (len > 0) {
+    this->aes_encrypt_block_(counter, ks);
+    inc32(counter);
+    size_t n = len < 16 ? len : 16;
+    for (size_t i = 0; i < n; i++)
+      data[i] ^= ks[i];
+    data += n;
+    len -= n;
+  }
+}
+#endif
+
+// x = x * H in GF(2^128), NIST SP 800-38D bit order
+void DlmsCipher::ghash_mul_(uint8_t *x) const {
+  uint64_t vh = 0, vl = 0, zh = 0, zl = 0;
+  for (int i = 0; i < 8; i++) {
+    vh = (vh << 8) | this->h_[i];
+    vl = (vl << 8) | this->h_[i + 8];
+  }
+  for (int i = 0; i < 128; i++) {
+    if ((x[i >> 3] >> (7 - (i & 7))) & 1) {
+      zh ^= vh;
+      zl ^= vl;
+    }
+    bool lsb = vl & 1;
+    vl = (vl >> 1) | (vh << 63);
+    vh >>= 1;
+    if (lsb)
+      vh ^= 0xE100000000000000ULL;
+  }
+  for (int i = 7; i >= 0; i--) {
+    x[i] = (uint8_t) zh;
+    x[i + 8] = (uint8_t) zl;
+    zh >>= 8;
+    zl >>= 8;
+  }
+}
+
+void DlmsCipher::ghash_update_(uint8_t *y, const uint8_t *data, size_t len) const {
+  while (len > 0) {
+    size_t n = len < 16 ? len : 16;
+    for (size_t i = 0; i < n; i++)
+      y[i] ^= data[i];
+    this->ghash_mul_(y);
+    data += n;
+    len -= n;
+  }
+}
+
+bool DlmsCipher::gcm_decrypt_(const uint8_t *iv, const uint8_t *aad, size_t aad_len, uint8_t *data, size_t len,
+                              const uint8_t *tag) {
+  uint8_t counter[16];
+  memcpy(counter, iv, 12);
+  counter[12] = 0;
+  counter[13] = 0;
+  counter[14] = 0;
+  counter[15] = 1;
+
+  if (tag != nullptr) {
+    uint8_t s[16]{};
+    this->ghash_update_(s, aad, aad_len);
+    this->ghash_update_(s, data, len);
+    uint64_t bits_a = (uint64_t) aad_len * 8;
+    uint64_t bits_c = (uint64_t) len * 8;
+    for (int i = 0; i < 8; i++) {
+      s[7 - i] ^= (uint8_t) (bits_a >> (i * 8));
+      s[15 - i] ^= (uint8_t) (bits_c >> (i * 8));
+    }
+    this->ghash_mul_(s);
+
+    uint8_t ek0[16];
+    this->aes_encrypt_block_(counter, ek0);
+    uint8_t diff = 0;
+    for (size_t i = 0; i < TAG_SIZE; i++)
+      diff |= s[i] ^ ek0[i] ^ tag[i];
+    if (diff != 0)
+      return false;
+  }
+
+  inc32(counter);
+  this->aes_ctr_(counter, data, len);
+  return true;
+}
+
+DlmsCipher::Result DlmsCipher::decrypt_in_place(uint8_t *apdu, size_t len, size_t &plain_len) {
+  plain_len = 0;
+  if (!is_ciphered(apdu, len))
+    return Result::NOT_CIPHERED;
+  // ciphered with the dedicated key of an association, which a listener never sees
+  if (apdu[0] == DLMS_GENERAL_DED_CIPHERING) {
+    ESP_LOGW(TAG, "general-ded-ciphering APDU dropped: it needs the dedicated key of its association, "
+                  "decryption_key is the global one");
+    return Result::UNSUPPORTED;
+  }
+
+  // tag, system-title (length-prefixed), length, security control, invocation counter, ciphertext [, tag]
+  size_t pos = 1;
+  if (pos >= len)
+    return Result::MALFORMED;
+  uint8_t st_len = apdu[pos++];
+  if (st_len != 8 || pos + st_len >= len)
+    return Result::MALFORMED;
+  const uint8_t *system_title = &apdu[pos];
+  pos += st_len;
+
+  size_t content_len = apdu[pos++];
+  if (content_len & 0x80) {
+    uint8_t n = content_len & 0x7F;
+    if (n == 0 || n > 2 || pos + n > len)
+      return Result::MALFORMED;
+    content_len = 0;
+    while (n--)
+      content_len = (content_len << 8) | apdu[pos++];
+  }
+  if (content_len < 5 || pos + content_len > len)
+    return Result::MALFORMED;
+
+  uint8_t sc = apdu[pos];
+  if ((sc & SC_SUITE_MASK) != 0 || (sc & SC_COMPRESSION) || !(sc & SC_ENCRYPTION)) {
+    ESP_LOGW(TAG, "Unsupported security control byte 0x%02X", sc);
+    return Result::UNSUPPORTED;
+  }
+
+  uint8_t iv[12];
+  memcpy(iv, system_title, 8);
+  memcpy(iv + 8, &apdu[pos + 1], 4);
+  this->last_ic_ = ((uint32_t) apdu[pos + 1] << 24) | ((uint32_t) apdu[pos + 2] << 16) |
+                   ((uint32_t) apdu[pos + 3] << 8) | apdu[pos + 4];
+
+  uint8_t *ciphertext = &apdu[pos + 5];
+  size_t ct_len = content_len - 5;
+  const uint8_t *tag = nullptr;
+  if (sc & SC_AUTHENTICATION) {
+    if (ct_len < TAG_SIZE)
+      return Result::MALFORMED;
+    ct_len -= TAG_SIZE;
+    // the key is part of the GCM AAD: without it the tag can't be checked and the content can't be trusted
+    if (!this->has_ak_) {
+      if (!this->warned_no_ak_) {
+        ESP_LOGW(TAG, "Authenticated APDUs received, but no authentication_key is configured; dropping them");
+        this->warned_no_ak_ = true;
+      }
+      return Result::AUTH_FAILED;
+    }
+    tag = ciphertext + ct_len;
+  }
+
+  uint8_t aad[1 + KEY_SIZE];
+  aad[0] = sc;
+  memcpy(aad + 1, this->ak_, KEY_SIZE);
+
+  if (!this->gcm_decrypt_(iv, aad, sizeof(aad), ciphertext, ct_len, tag)) {
+    ESP_LOGW(TAG, "Authentication tag mismatch, IC=%u", this->last_ic_);
+    return Result::AUTH_FAILED;
+  }
+
+  memmove(apdu, ciphertext, ct_len);
+  plain_len = ct_len;
+  return Result::OK;
+}
+
+}  // namespace dlms_cosem
+}  // namespace esphome
+
+#endif  // ENABLE_DLMS_COSEM_PUSH_MODE
@@ -0,0 +1,79 @@
+#pragma once
+#ifdef ENABLE_DLMS_COSEM_PUSH_MODE
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef USE_ESP32
+#include <mbedtls/aes.h>
+#endif
+
+namespace esphome {
+namespace dlms_cosem {
+
+static constexpr uint8_t DLMS_GENERAL_GLO_CIPHERING = 0xDB;
+static constexpr uint8_t DLMS_GENERAL_DED_CIPHERING = 0xDC;
+
+/**
+ * Security suite 0 (AES-GCM-128) decryption of general-glo-ciphering APDUs with the global key.
+ * General-ded-ciphering APDUs are recognised but rejected as UNSUPPORTED: their dedicated key is agreed
+ * per association and is not known here.
+ *
+ * Works in place: the tag is verified over the ciphertext first, then the ciphertext is decrypted
+ * and the plaintext APDU is moved to the start of the ciphered one. Nothing is copied elsewhere.
+ * On ESP32 the AES block and CTR operations go through mbedtls, which drives the hardware AES
+ * engine; elsewhere a small software AES-128 is used. GHASH is done in software everywhere.
+ * APDUs with the authentication bit set are only accepted with an authentication key to check the tag.
+ */
+class DlmsCipher {
+ public:
+  enum class Result : uint8_t { OK, NOT_CIPHERED, MALFORMED, UNSUPPORTED, AUTH_FAILED };
+
+#ifdef USE_ESP32
+  DlmsCipher() { mbedtls_aes_init(&this->aes_ctx_); }
+  ~DlmsCipher() { mbedtls_aes_free(&this->aes_ctx_); }
+#endif
+
+  void set_decryption_key(const uint8_t *key);
+  void set_authentication_key(const uint8_t *key);
+  bool has_key() const { return this->has_ek_; }
+
+  static bool is_ciphered(const uint8_t *apdu, size_t len) {
+    return len > 0 && (apdu[0] == DLMS_GENERAL_GLO_CIPHERING || apdu[0] == DLMS_GENERAL_DED_CIPHERING);
+  }
+
+  // apdu[0, len) is one ciphered APDU; on OK, apdu[0, plain_len) holds the plaintext APDU
+  Result decrypt_in_place(uint8_t *apdu, size_t len, size_t &plain_len);
+
+  uint32_t last_invocation_counter() const { return this->last_ic_; }
+
+ protected:
+  static constexpr size_t KEY_SIZE = 16;
+  static constexpr size_t TAG_SIZE = 12;
+
+  bool gcm_decrypt_(const uint8_t *iv, const uint8_t *aad, size_t aad_len, uint8_t *data, size_t len,
+                    const uint8_t *tag);
+
+  void aes_encrypt_block_(const uint8_t *in, uint8_t *out);
+  void aes_ctr_(uint8_t *counter, uint8_t *data, size_t len);
+  void ghash_mul_(uint8_t *x) const;
+  void ghash_update_(uint8_t *y, const uint8_t *data, size_t len) const;
+
+#ifdef USE_ESP32
+  mbedtls_aes_context aes_ctx_{};
+#else
+  uint8_t round_keys_[176]{};
+#endif
+  uint8_t h_[16]{};
+
+  uint8_t ak_[KEY_SIZE]{};
+  bool has_ek_{false};
+  bool has_ak_{false};
+  bool warned_no_ak_{false};
+  uint32_t last_ic_{0};
+};
+
+}  // namespace dlms_cosem
+}  // namespace esphome
+
+#endif  // ENABLE_DLMS_COSEM_PUSH_MODE
@@ -4,8 +4,11 @@
 #include "esphome/core/application.h"
 #include "esphome/core/helpers.h"
 #include "esphome/core/log.h"
+#include <cmath>
+#include <cstring>
 #include <sstream>
 #include <ranges>
+#include <vector>
 #include "dlms_cosem_helpers.h"
 namespace esphome {
 namespace dlms_cosem {
@@ -112,7 +115,8 @@ uint8_t baud_rate_to_byte(uint32_t baud) {
 
 void DlmsCosemComponent::set_baud_rate_(uint32_t baud_rate) {
   ESP_LOGV(TAG, "Setting baud rate %u bps", baud_rate);
-  iuart_->update_baudrate(baud_rate);
+  this->current_baud_rate_ = baud_rate;
+  this->port_->set_baud_rate(baud_rate);
 }
 
 void DlmsCosemComponent::set_server_address(uint16_t address) { this->server_address_ = address; };
@@ -145,6 +149,15 @@ uint16_t DlmsCosemComponent::update_server_address(uint16_t logicalAddress, uint
   return this->server_address_;
 }
 
+// Points a Gurux byte buffer at arena memory. Such a buffer must never be passed to bb_capacity() or bb_clear().
+static void attach_arena_buffer(gxByteBuffer *bb, uint8_t *data, size_t size) {
+  BYTE_BUFFER_INIT(bb);
+  bb->data = data;
+  bb->capacity = size;
+  bb->size = 0;
+  bb->position = 0;
+}
+
 void DlmsCosemComponent::setup() {
   ESP_LOGD(TAG, "setup");
 
@@ -152,28 +165,56 @@ void DlmsCosemComponent::setup() {
           this->auth_required_ ? DLMS_AUTHENTICATION_LOW : DLMS_AUTHENTICATION_NONE,
           this->auth_required_ ? this->password_.c_str() : NULL, DLMS_INTERFACE_TYPE_HDLC);
 
-  this->buffers_.init(this->is_push_mode() ? DEFAULT_IN_BUF_SIZE_PUSH : DEFAULT_IN_BUF_SIZE);
+  size_t rx_size = this->rx_buffer_size_;
+  if (rx_size == 0)
+    rx_size = this->is_push_mode() ? DEFAULT_IN_BUF_SIZE_PUSH : DEFAULT_IN_BUF_SIZE;
+  // push mode receives the next telegram while the previous one is parsed
+  this->arena_size_ = this->is_push_mode() ? 2 * rx_size : rx_size;
+  this->arena_ = make_unique<uint8_t[]>(this->arena_size_);
+  this->buffers_.init(this->arena_.get(), rx_size);
+  this->trace_.init(this->trace_size_);
 
   this->indicate_transmission(false);
 
-#ifdef USE_ESP32
-  iuart_ = make_unique<DlmsCosemUart>(*static_cast<uart::IDFUARTComponent *>(this->parent_));
-#endif
-
-#if USE_ESP8266
-  iuart_ = make_unique<DlmsCosemUart>(*static_cast<uart::ESP8266UartComponent *>(this->parent_));
-#endif
   if (this->flow_control_pin_ != nullptr) {
     this->flow_control_pin_->setup();
   }
+#if defined(USE_ESP32) || defined(USE_ESP8266)
+  if (this->port_ == nullptr) {
+    this->port_ = make_unique<UartPort>(this->parent_, this->flow_control_pin_);
+  }
+#endif
+  if (this->port_ == nullptr) {
+    ESP_LOGE(TAG, "No serial port to the meter");
+    this->mark_failed();
+    return;
+  }
+  if (this->capture_size_ > 0) {
+    auto capture = make_unique<CapturePort>(std::move(this->port_), this->capture_size_);
+    this->capture_ = capture.get();
+    this->port_ = std::move(capture);
+  }
 
   this->set_baud_rate_(this->baud_rate_handshake_);
 
+  this->bus_usage_ = BusUsage::get(this->port_->bus_id());
+  if (this->bus_usage_ == nullptr) {
+    ESP_LOGW(TAG, "Too many UART buses, bus usage covers this meter only");
+    this->bus_usage_ = &this->bus_usage_own_;
+  }
+  this->bus_usage_->meters++;
+  this->bus_snapshot_ms_ = millis();
+
 #ifdef ENABLE_DLMS_COSEM_PUSH_MODE
   if (this->is_push_mode()) {
     CosemObjectFoundCallback fn = [this](auto... args) { (void) this->set_sensor_value(args...); };
 
     this->axdr_parser_ = new AxdrStreamParser(&this->buffers_.in, fn, this->push_show_log_);
+    this->axdr_parser_->set_budget(
+        {this->push_max_depth_, this->push_max_elements_, this->push_max_parse_time_ms_ * 1000});
+    this->push_assembler_.set_cipher(&this->push_cipher_);
+    attach_arena_buffer(&this->push_rx_.buf, this->arena_.get() + rx_size, rx_size);
+    this->build_push_index_();
 
     // default patterns
     this->axdr_parser_->register_pattern_dsl("HAN-DTM", "F,TO,TVOSDTM");
@@ -213,6 +254,7 @@ void DlmsCosemComponent::setup() {
   this->set_timeout(BOOT_WAIT_S * 1000, [this]() {
     ESP_LOGD(TAG, "Boot timeout, component is ready to use");
     this->clear_rx_buffers_();
+    this->state_entered_us_ = micros();
     this->set_next_state_(State::IDLE);
   });
 }
@@ -227,22 +269,80 @@ void DlmsCosemComponent::dump_config() {
   ESP_LOGCONFIG(TAG, "  Server address: %d", this->server_address_);
   ESP_LOGCONFIG(TAG, "  Authentication: %s", this->auth_required_ == DLMS_AUTHENTICATION_NONE ? "None" : "Low");
   ESP_LOGCONFIG(TAG, "  P*ssword: %s", this->password_.c_str());
+#ifdef ENABLE_DLMS_COSEM_PUSH_MODE
+  if (this->is_push_mode()) {
+    ESP_LOGCONFIG(TAG, "  Push decryption: %s", this->push_cipher_.has_key() ? "AES-GCM-128 (suite 0)" : "None");
+  }
+#endif
+  ESP_LOGCONFIG(TAG, "  Receive buffer: %u bytes (%u bytes allocated)", (unsigned) this->buffers_.in.capacity,
+                (unsigned) this->arena_size_);
+  ESP_LOGCONFIG(TAG, "  Loop budget: %u us", (unsigned) this->loop_budget_us_);
+#ifdef ENABLE_DLMS_COSEM_COROUTINES
+  ESP_LOGCONFIG(TAG, "  Session: coroutine, frame pool %u bytes", (unsigned) CoroutineFramePool::capacity());
+#endif
+  if (this->has_fast_poll_()) {
+    ESP_LOGCONFIG(TAG, "  Fast poll: every %u ms, bus utilization up to %.0f%%",
+                  (unsigned) this->fast_poll_interval_ms_, this->fast_poll_max_utilization_ * 100.0f);
+  }
   ESP_LOGCONFIG(TAG, "  Sensors:");
   for (const auto &sensors : sensors_) {
     auto &s = sensors.second;
-    ESP_LOGCONFIG(TAG, "    OBIS code: %s, Name: %s", s->get_obis_code().c_str(), s->get_sensor_name().c_str());
+    ESP_LOGCONFIG(TAG, "    OBIS code: %s, Name: %s", s->get_obis_code().c_str(), s->get_sensor_name());
   }
+  // map nodes: key, value and a red-black tree node header
+  const size_t map_bytes = this->sensors_.size() * (sizeof(SensorMap::value_type) + 4 * sizeof(void *));
+  const size_t buffer_bytes =
+      this->arena_size_ + this->capture_size_ + this->trace_size_ * sizeof(SessionTrace::Record);
+  ESP_LOGCONFIG(TAG, "  RAM: component %u bytes, buffers %u bytes, sensor map ~%u bytes", (unsigned) sizeof(*this),
+                (unsigned) buffer_bytes, (unsigned) map_bytes);
+  ESP_LOGCONFIG(TAG, "  RAM per sensor, entity included: numeric %u bytes, text %u bytes",
+                (unsigned) sizeof(DlmsCosemSensor),
+#ifdef USE_TEXT_SENSOR
+                (unsigned) sizeof(DlmsCosemTextSensor)
+#else
+                0u
+#endif
+  );
+}
+
+#ifdef USE_HOST
+void DlmsCosemComponent::set_host_serial_port(const std::string &path) {
+  auto port = make_unique<PosixSerialPort>(path);
+  if (port->open())
+    this->port_ = std::move(port);
 }
+#endif
+
+#ifdef ENABLE_DLMS_COSEM_PUSH_MODE
+void DlmsCosemComponent::set_decryption_key(const std::string &hex_key) {
+  uint8_t key[16];
+  if (hex_key.size() != 32 || !parse_hex(hex_key, key, sizeof(key))) {
+    ESP_LOGE(TAG, "Decryption key must be 32 hex characters");
+    return;
+  }
+  this->push_cipher_.set_decryption_key(key);
+}
+
+void DlmsCosemComponent::set_authentication_key(const std::string &hex_key) {
+  uint8_t key[16];
+  if (hex_key.size() != 32 || !parse_hex(hex_key, key, sizeof(key))) {
+    ESP_LOGE(TAG, "Authentication key must be 32 hex characters");
+    return;
+  }
+  this->push_cipher_.set_authentication_key(key);
+}
+#endif
 
 void DlmsCosemComponent::register_sensor(DlmsCosemSensorBase *sensor) {
-  this->sensors_.insert({sensor->get_obis_code(), sensor});
+  this->sensors_.insert({sensor->get_obis_key(), sensor});
 }
 
 void DlmsCosemComponent::abort_mission_() {
 #ifdef ENABLE_DLMS_COSEM_PUSH_MODE
   if (this->is_push_mode()) {
     ESP_LOGV(TAG, "Push mode error, returning to listening");
-    this->clear_rx_buffers_();
+    this->buffers_.in.size = 0;
+    this->buffers_.in.position = 0;
     this->set_next_state_(State::IDLE);
     return;
   }
@@ -270,6 +370,45 @@ void DlmsCosemComponent::loop() {
   if (!this->is_ready() || this->state_ == State::NOT_INITIALIZED)
     return;
 
+  const uint32_t loop_start_us = micros();
+  const State loop_state_before = this->state_;
+
+#ifdef ENABLE_DLMS_COSEM_PUSH_MODE
+  if (this->is_push_mode()) {
+    this->push_receive_();
+  }
+#endif
+
+  // Run-to-completion: keep stepping while the engine makes progress without waiting
+  // for the meter, a delay or the bus, up to the time budget.
+  for (;;) {
+    const State state_before = this->state_;
+    this->step_();
+    this->account_state_change_(state_before);
+    // COMMS_TX sends and PUBLISH publishes one item per step without changing state
+    bool progress = this->state_ != state_before || this->state_ == State::COMMS_TX || this->state_ == State::PUBLISH;
+    if (!progress || micros() - loop_start_us >= this->loop_budget_us_)
+      break;
+  }
+
+  this->account_loop_time_(loop_state_before, loop_start_us);
+
+  // a session (or a push telegram coming in) wants loop() called as often as possible
+  bool active = this->state_ != State::IDLE;
+#ifdef ENABLE_DLMS_COSEM_PUSH_MODE
+  active |= this->push_rx_.receiving;
+#endif
+  if (active != this->high_freq_active_) {
+    if (active) {
+      this->high_freq_.start();
+    } else {
+      this->high_freq_.stop();
+    }
+    this->high_freq_active_ = active;
+  }
+}
+
+void DlmsCosemComponent::step_() {
   switch (this->state_) {
     case State::IDLE: {
       this->update_last_rx_time_();
@@ -281,27 +420,33 @@ void DlmsCosemComponent::loop() {
 
 #ifdef ENABLE_DLMS_COSEM_PUSH_MODE
 
-      // Push mode listening logic
-      if (this->is_push_mode()) {
-        if (this->available() > 0) {
-          // Set up for receiving push data
-          memset(this->buffers_.in.data, 0, buffers_.in.capacity);
-          this->buffers_.in.size = 0;
-          // read what we can then move forward to avoid buffer overflow
-          this->receive_frame_raw_();
+      // Push mode: take over a telegram received in the background
+      if (this->is_push_mode() && this->push_rx_.ready) {
+        std::swap(this->push_rx_.buf, this->buffers_.in);
+        this->push_rx_.ready = false;
 
-          ESP_LOGV(TAG, "Push mode: incoming data detected");
-          this->stats_.connections_tried_++;
-          this->loop_state_.session_started_ms = millis();
-
-          this->indicate_transmission(true);
+        ESP_LOGV(TAG, "Push mode: telegram received, len=%d", this->buffers_.in.size);
+        this->stats_.connections_tried_++;
+        this->trace_.add(SessionTrace::Event::PUSH, 0, this->buffers_.in.size, this->stats_.connections_tried_);
+        this->loop_state_.session_started_ms = millis();
+        this->indicate_connection(true);
+        this->set_next_state_(State::PUSH_DATA_PROCESS);
+      }
+#endif
 
-          reading_state_.next_state = State::PUSH_DATA_PROCESS;
-          reading_state_.mission_critical = false;  // Never critical in push mode
-          this->set_next_state_(State::COMMS_RX);
+      if (!this->is_push_mode()) {
+        if (this->update_pending_) {
+          ESP_LOGD(TAG, "Starting data collection postponed by a short session");
+          this->start_session_(SessionKind::SCHEDULED);
+        } else if (this->read_now_count_ > 0) {
+          // on-demand reads that came after the previous session had finished reading
+          ESP_LOGD(TAG, "Starting session for %u on-demand read(s)", this->read_now_count_);
+          this->start_session_(SessionKind::READ_NOW);
+        } else if (this->fast_poll_until_ms_ != 0 && this->fast_poll_due_(millis())) {
+          this->stats_.fast_poll_sessions_++;
+          this->start_session_(SessionKind::FAST_POLL);
         }
       }
-#endif
 
 
     } break;
@@ -309,11 +454,20 @@ void DlmsCosemComponent::loop() {
     case State::TRY_LOCK_BUS: {
       this->log_state_();
       if (this->try_lock_uart_session_()) {
+        if (this->lock_waiting_) {
+          this->bus_usage_->contention_us += (uint64_t) (millis() - this->lock_wait_started_ms_) * 1000;
+          this->lock_waiting_ = false;
+        }
+        this->bus_locked_us_ = micros();
         this->indicate_session(true);
         this->indicate_connection(true);
         this->set_next_state_(State::OPEN_SESSION);
       } else {
         ESP_LOGV(TAG, "UART Bus is busy, waiting ...");
+        if (!this->lock_waiting_) {
+          this->lock_wait_started_ms_ = millis();
+          this->lock_waiting_ = true;
+        }
         this->set_next_state_delayed_(1000, State::TRY_LOCK_BUS);
       }
     } break;
@@ -331,6 +485,7 @@ void DlmsCosemComponent::loop() {
       if (buffers_.has_more_messages_to_send()) {
         send_dlms_messages_();
       } else {
+        this->reply_wait_started_us_ = micros();
         this->set_next_state_(State::COMMS_RX);
       }
     } break;
@@ -343,10 +498,17 @@ void DlmsCosemComponent::loop() {
       //  this->send_frame_(CMD_CLOSE_SESSION, sizeof(CMD_CLOSE_SESSION));
       if (!this->is_push_mode()) {
         this->unlock_uart_session_();
+        this->session_stats_report_();
       }
+#ifdef ENABLE_DLMS_COSEM_COROUTINES
+      this->script_.reset();
+#endif
+      this->fail_read_now_(DLMS_ERROR_CODE_HARDWARE_FAULT);
       this->set_next_state_(State::IDLE);
       this->report_failure(true);
       this->stats_dump();
+      this->timing_dump();
+      this->publish_diagnostics_();
     } break;
 
     case State::OPEN_SESSION: {
@@ -409,6 +571,12 @@ void DlmsCosemComponent::loop() {
       this->handle_disconnect_req_();
     } break;
 
+#ifdef ENABLE_DLMS_COSEM_COROUTINES
+    case State::SESSION_SCRIPT: {
+      this->handle_session_script_();
+    } break;
+#endif
+
 #ifdef ENABLE_DLMS_COSEM_PUSH_MODE
     case State::PUSH_DATA_PROCESS: {
       this->handle_push_data_process_();
@@ -424,36 +592,58 @@ void DlmsCosemComponent::loop() {
   }
 }
 
+void DlmsCosemComponent::account_state_change_(State state_before) {
+  if (this->state_ == state_before)
+    return;
+  const uint32_t now = micros();
+  this->state_timing_[static_cast<size_t>(state_before)].add(now - this->state_entered_us_);
+  this->trace_.add(SessionTrace::Event::STATE, static_cast<uint8_t>(state_before), static_cast<uint16_t>(this->state_),
+                   now - this->state_entered_us_);
+  this->state_entered_us_ = now;
+}
+
+void DlmsCosemComponent::account_loop_time_(State state_before, uint32_t loop_start_us) {
+  if (state_before == State::IDLE && this->state_ == State::IDLE)
+    return;  // nothing happened
+
+  const uint32_t spent = micros() - loop_start_us;
+  this->loop_timing_.add(spent);
+  if (spent > this->loop_max_us_)
+    this->loop_max_us_ = spent;
+  if (spent > SLOW_LOOP_US)
+    this->slow_loops_++;
+}
+
+void DlmsCosemComponent::trace_dump() const { this->trace_.dump(TAG, STATE_COUNT); }
+
+void DlmsCosemComponent::capture_dump() const {
+  if (this->capture_ == nullptr) {
+    ESP_LOGW(TAG, "Traffic capture is disabled, set capture_size");
+    return;
+  }
+  this->capture_->dump(TAG);
+}
+
 void DlmsCosemComponent::handle_comms_rx_() {
   this->log_state_();
 
   if (this->check_rx_timeout_()) {
-    if (this->is_push_mode()) {
-      ESP_LOGI(TAG, "Push data reception completed (timeout reached)");
-    } else {
-      ESP_LOGE(TAG, "RX timeout.");
-      this->has_error = true;
-      this->dlms_reading_state_.last_error = DLMS_ERROR_CODE_HARDWARE_FAULT;
-      this->stats_.invalid_frames_ += reading_state_.err_invalid_frames;
+    ESP_LOGE(TAG, "RX timeout.");
+    // the state the reply was for tells which request went unanswered; state_ is always COMMS_RX here
+    this->trace_.add(SessionTrace::Event::TIMEOUT, static_cast<uint8_t>(this->reading_state_.next_state), 0,
+                     millis() - this->last_rx_time_);
+    if (!reading_state_.mission_critical && this->retry_request_()) {
+      reading_state_.err_invalid_frames++;
+      return;
     }
+    this->has_error = true;
+    this->dlms_reading_state_.last_error = DLMS_ERROR_CODE_HARDWARE_FAULT;
+    this->stats_.invalid_frames_ += reading_state_.err_invalid_frames;
 
     this->indicate_connection(false);
     this->indicate_transmission(false);
 
-    if (this->is_push_mode()) {
-#ifdef ENABLE_DLMS_COSEM_PUSH_MODE
-
-      // check if we received any data at all
-      this->indicate_connection(true);
-      if (this->buffers_.in.size > 0) {
-        ESP_LOGV(TAG, "Push mode RX data avail, len=%d", this->buffers_.in.size);
-        this->set_next_state_(State::PUSH_DATA_PROCESS);
-      } else {
-        ESP_LOGV(TAG, "Push mode RX timeout, no data, idling");
-        this->set_next_state_(State::IDLE);
-      }
-#endif
-    } else if (reading_state_.mission_critical) {
+    if (reading_state_.mission_critical) {
       ESP_LOGE(TAG, "Mission critical RX timeout.");
       this->abort_mission_();
     } else {
@@ -464,16 +654,6 @@ void DlmsCosemComponent::handle_comms_rx_() {
     return;
   }
 
-#ifdef ENABLE_DLMS_COSEM_PUSH_MODE
-
-  if (this->is_push_mode()) {
-    received_frame_size_ = this->receive_frame_raw_();
-    // this->update_last_rx_time_();
-    //  keep reading until timeout
-    return;
-  }
-#endif
-
   // the following basic algorithm to be implemented to read DLMS packet
   // first version, no retries
   // 1. receive proper hdlc frame
@@ -499,9 +679,25 @@ void DlmsCosemComponent::handle_comms_rx_() {
               buffers_.reply.complete);
   }
 
+  if (dlms_is_access_result(ret)) {
+    // a valid reply with an error for the object: nothing to send again
+    ESP_LOGW(TAG, "Access result %d %s", ret, dlms_error_to_string(ret));
+    this->trace_.add(SessionTrace::Event::ERROR, static_cast<uint8_t>(this->state_), 0, ret);
+    this->dlms_reading_state_.last_error = ret;
+    if (reading_state_.mission_critical) {
+      this->abort_mission_();
+      return;
+    }
+    this->set_next_state_(reading_state_.next_state);
+    return;
+  }
+
   if (ret != DLMS_ERROR_CODE_OK && ret != DLMS_ERROR_CODE_FALSE) {
     ESP_LOGE(TAG, "dlms_getData2 failed. ret %d %s", ret, dlms_error_to_string(ret));
+    this->trace_.add(SessionTrace::Event::ERROR, static_cast<uint8_t>(this->state_), 0, ret);
     this->reading_state_.err_invalid_frames++;
+    if (!reading_state_.mission_critical && this->retry_request_())
+      return;
     this->set_next_state_(reading_state_.next_state);
     return;
   }
@@ -509,6 +705,11 @@ void DlmsCosemComponent::handle_comms_rx_() {
   if (buffers_.reply.complete == 0) {
     ESP_LOGD(TAG, "DLMS Reply not complete, need more HDLC frames. "
                   "Continue reading.");
+    // the frame is in reply.data now, the next one can start at the beginning of the buffer
+    if (buffers_.in.position >= buffers_.in.size) {
+      buffers_.in.size = 0;
+      buffers_.in.position = 0;
+    }
     // data in multiple frames.
     // we just keep reading until full reply is received.
     return;  // keep reading
@@ -517,7 +718,7 @@ void DlmsCosemComponent::handle_comms_rx_() {
   this->update_last_rx_time_();
   this->set_next_state_(reading_state_.next_state);
 
-  auto parse_ret = this->dlms_reading_state_.parser_fn();
+  auto parse_ret = this->parse_reply_(this->dlms_reading_state_.request);
   this->dlms_reading_state_.last_error = parse_ret;
 
   if (parse_ret == DLMS_ERROR_CODE_OK) {
@@ -525,13 +726,8 @@ void DlmsCosemComponent::handle_comms_rx_() {
 
   } else {
     ESP_LOGE(TAG, "DLMS parser fn error %d %s", parse_ret, dlms_error_to_string(parse_ret));
+    this->trace_.add(SessionTrace::Event::ERROR, static_cast<uint8_t>(this->state_), 0, parse_ret);
 
-#ifdef ENABLE_DLMS_COSEM_PUSH_MODE
-    if (this->is_push_mode()) {
-      ESP_LOGV(TAG, "Push mode parse error, returning to listening");
-      this->set_next_state_(State::IDLE);
-    } else 
-#endif    
     if (reading_state_.mission_critical) {
       this->abort_mission_();
     }
@@ -543,10 +739,26 @@ void DlmsCosemComponent::handle_comms_rx_() {
 void DlmsCosemComponent::handle_open_session_() {
   this->stats_.connections_tried_++;
   this->loop_state_.session_started_ms = millis();
+  this->loop_state_.session = {};
   this->log_state_();
   this->clear_rx_buffers_();
-  this->loop_state_.request_iter = this->sensors_.begin();
-
+  if (this->capture_ != nullptr)
+    this->capture_->restart();
+  this->loop_state_.request_iter =
+      this->session_kind_ == SessionKind::READ_NOW ? this->sensors_.end() : this->sensors_.begin();
+  this->loop_state_.request = nullptr;
+  this->loop_state_.read_now_active = false;
+
+#ifdef ENABLE_DLMS_COSEM_COROUTINES
+  this->script_.reset();  // left suspended by a session that could not send a request
+  this->script_ = start_session_script(this->coroutine_frames_, [this]() { return this->session_script_(); });
+  if (this->script_) {
+    this->set_next_state_(State::SESSION_SCRIPT);
+    return;
+  }
+  ESP_LOGW(TAG, "Session script frame of %u bytes does not fit the %u byte pool, using the state machine",
+           (unsigned) this->coroutine_frames_.last_request(), (unsigned) CoroutineFramePool::capacity());
+#endif
   this->set_next_state_(State::BUFFERS_REQ);
 
   // if (false) {
@@ -585,77 +797,165 @@ void DlmsCosemComponent::handle_association_req_() {
 void DlmsCosemComponent::handle_association_rcv_() {
   // check the reply and go to next stage
   // todo smth with aarq reply
-  this->set_next_state_(State::DATA_ENQ_UNIT);
+  this->set_next_state_(this->select_next_request_() ? State::DATA_ENQ_UNIT : State::SESSION_RELEASE);
+}
+
+// Picks the object the session reads next into loop_state_.request, false when there is none left.
+// The DATA_* states only ever look at loop_state_.request, so the read order is decided here alone.
+bool DlmsCosemComponent::select_next_request_() {
+  auto &ls = this->loop_state_;
+  if (ls.request != nullptr && ls.request_iter != this->sensors_.end()) {
+    // sensors sharing an OBIS code are served by one read
+    ls.request_iter = this->sensors_.upper_bound(ls.request_iter->first);
+  }
+  ls.request = nullptr;
+  ls.read_now_active = this->read_now_count_ > 0;
+  if (ls.read_now_active) {
+    ls.read_now = std::move(this->read_now_queue_[this->read_now_head_]);
+    this->read_now_head_ = (this->read_now_head_ + 1) % READ_NOW_QUEUE_SIZE;
+    this->read_now_count_--;
+    return true;
+  }
+  if (this->session_kind_ == SessionKind::FAST_POLL) {
+    const uint32_t now = millis();
+    while (ls.request_iter != this->sensors_.end() && !ls.request_iter->second->is_fast_polled(now))
+      ls.request_iter = this->sensors_.upper_bound(ls.request_iter->first);
+  }
+  ls.request = ls.request_iter != this->sensors_.end() ? ls.request_iter->second : nullptr;
+  return ls.request != nullptr;
 }
 
 void DlmsCosemComponent::handle_data_enq_unit_() {
   this->log_state_();
-  if (this->loop_state_.request_iter == this->sensors_.end()) {
+  if (!this->loop_state_.read_now_active && this->loop_state_.request == nullptr) {
     ESP_LOGD(TAG, "All requests done");
     this->set_next_state_(State::SESSION_RELEASE);
     return;
   }
 
-  auto req = this->loop_state_.request_iter->first;
-  auto sens = this->loop_state_.request_iter->second;
-  auto type = sens->get_obis_class();
-
-  ESP_LOGD(TAG, "OBIS code: %s, Sensor: %s", req.c_str(), sens->get_sensor_name().c_str());
-
-  // request units for numeric sensors only and only once
-  if (sens->get_type() == SensorType::SENSOR && type == DLMS_OBJECT_TYPE_REGISTER && !sens->has_got_scale_and_unit()) {
-    // if (type == DLMS_OBJECT_TYPE_REGISTER)
-    //        if (sens->get_attribute() != 2) {
-    this->buffers_.gx_attribute = 3;
-    this->prepare_and_send_dlms_data_unit_request(req.c_str(), type);
+  this->begin_object_();
+  if (this->object_needs_units_()) {
+    this->prepare_and_send_dlms_data_unit_request();
   } else {
-    // units not working so far... so we are requesting just data
     this->set_next_state_(State::DATA_ENQ);
   }
 }
 
 void DlmsCosemComponent::handle_data_enq_() {
   this->log_state_();
-  if (this->loop_state_.request_iter == this->sensors_.end()) {
+  if (!this->loop_state_.read_now_active && this->loop_state_.request == nullptr) {
     ESP_LOGD(TAG, "All requests done");
     this->set_next_state_(State::SESSION_RELEASE);
     return;
   }
 
-  auto req = this->loop_state_.request_iter->first;
-  auto sens = this->loop_state_.request_iter->second;
-  auto type = sens->get_obis_class();
-  auto units_were_requested =
-      (sens->get_type() == SensorType::SENSOR && type == DLMS_OBJECT_TYPE_REGISTER && !sens->has_got_scale_and_unit());
-  if (units_were_requested) {
-    auto ret = this->set_sensor_scale_and_unit(static_cast<DlmsCosemSensor *>(sens));
-  }
-
-  this->buffers_.gx_attribute = 2;
-  this->prepare_and_send_dlms_data_request(req.c_str(), type, !units_were_requested);
+  auto units_were_requested = this->object_needs_units_();
+  if (units_were_requested)
+    this->set_sensor_scale_and_unit(static_cast<DlmsCosemSensor *>(this->loop_state_.request));
+  this->prepare_and_send_dlms_data_request(!units_were_requested);
 }
 
 void DlmsCosemComponent::handle_data_recv_() {
   this->log_state_();
   this->set_next_state_(State::DATA_NEXT);
+  this->object_done_();
+}
+
+void DlmsCosemComponent::begin_object_() {
+  auto &ls = this->loop_state_;
+  ls.object_started_ms = millis();
+  ls.object_retries = 0;
+  if (!ls.read_now_active)
+    ESP_LOGD(TAG, "OBIS code: %s, Sensor: %s", ls.request->get_obis_code().c_str(), ls.request->get_sensor_name());
+}
+
+// scaler and unit for numeric register sensors only and only once; read_now gives the raw value
+bool DlmsCosemComponent::object_needs_units_() const {
+  const auto &ls = this->loop_state_;
+  if (ls.read_now_active)
+    return false;
+  const auto *sens = ls.request;
+  return sens->get_type() == SensorType::SENSOR && sens->get_obis_class() == DLMS_OBJECT_TYPE_REGISTER &&
+         !sens->has_got_scale_and_unit();
+}
 
-  auto req = this->loop_state_.request_iter->first;
-  auto sens = this->loop_state_.request_iter->second;
+// the Gurux object and attribute of the next request; reg_init false keeps the register the unit
+// request set up
+int DlmsCosemComponent::prepare_object_request_(bool units, bool reg_init, DlmsRequest *request) {
+  const auto &ls = this->loop_state_;
+  ObisString obis;
+  int type;
+  if (ls.read_now_active) {
+    obis = obis_to_string(ls.read_now.obis);
+    type = ls.read_now.class_id;
+    this->buffers_.gx_attribute = ls.read_now.attribute;
+  } else {
+    obis = ls.request->get_obis_code();
+    type = ls.request->get_obis_class();
+    this->buffers_.gx_attribute = units ? 3 : 2;
+  }
+  *request = type == DLMS_OBJECT_TYPE_CLOCK ? DlmsRequest::READ_CLOCK : DlmsRequest::READ_REGISTER;
+
+  int ret = DLMS_ERROR_CODE_OK;
+  if (type == DLMS_OBJECT_TYPE_CLOCK) {
+    ret = cosem_init(BASE(this->buffers_.gx_clock), (DLMS_OBJECT_TYPE) type, obis.c_str());
+  } else if (reg_init) {
+    ret = cosem_init(BASE(this->buffers_.gx_register), (DLMS_OBJECT_TYPE) type, obis.c_str());
+  }
+  if (ret != DLMS_ERROR_CODE_OK)
+    ESP_LOGE(TAG, "cosem_init error %d '%s'", ret, dlms_error_to_string(ret));
+  return ret;
+}
+
+// the value request is answered
+void DlmsCosemComponent::object_done_() {
+  if (this->loop_state_.read_now_active) {
+    this->finish_read_now_();
+  } else {
+    this->object_read_(this->loop_state_.request);
+  }
+}
+
+// the reply to the data request for sens is in buffers_: value, telemetry, fast polling
+void DlmsCosemComponent::object_read_(DlmsCosemSensorBase *sens) {
+  auto req = sens->get_obis_code();
   auto ret = this->set_sensor_value(sens, req.c_str());
+  sens->telemetry().record(millis() - this->loop_state_.object_started_ms, this->dlms_reading_state_.last_error,
+                           this->reading_state_.err_invalid_frames, this->loop_state_.object_retries);
+  this->loop_state_.session.objects++;
+  if (ret != DLMS_ERROR_CODE_OK) {
+    this->loop_state_.session.objects_failed++;
+    return;
+  }
+
+#ifdef USE_SENSOR
+  if (sens->get_type() == SensorType::SENSOR) {
+    const uint32_t now = millis();
+    if (auto *trigger = static_cast<DlmsCosemSensor *>(sens)->check_fast_poll(now))
+      this->trigger_fast_poll_(*trigger, now);
+  }
+#endif
+  if (this->session_kind_ != SessionKind::SCHEDULED)
+    sens->publish();
 }
 
 void DlmsCosemComponent::handle_data_next_() {
   this->log_state_();
-  this->loop_state_.request_iter = this->sensors_.upper_bound(this->loop_state_.request_iter->first);
-  if (this->loop_state_.request_iter != this->sensors_.end()) {
+  if (this->select_next_request_()) {
     this->set_next_state_delayed_(this->delay_between_requests_ms_, State::DATA_ENQ_UNIT);
   } else {
     this->set_next_state_delayed_(this->delay_between_requests_ms_, State::SESSION_RELEASE);
   }
 }
 
+void DlmsCosemComponent::start_publish_() {
+  // short sessions have published their sensors already
+  this->loop_state_.sensor_iter =
+      this->session_kind_ == SessionKind::SCHEDULED ? this->sensors_.begin() : this->sensors_.end();
+}
+
 void DlmsCosemComponent::handle_session_release_() {
-  this->loop_state_.sensor_iter = this->sensors_.begin();
+  this->start_publish_();
 
   this->log_state_();
   ESP_LOGD(TAG, "Session release request");
@@ -672,6 +972,86 @@ void DlmsCosemComponent::handle_disconnect_req_() {
   this->prepare_and_send_dlms_disconnect();
 }
 
+#ifdef ENABLE_DLMS_COSEM_COROUTINES
+// co_await request_(): sends the request and resumes once COMMS_RX is done with the reply, giving its error.
+// A mission critical request that fails aborts the session, and the script is destroyed where it waits.
+struct DlmsCosemComponent::ScriptRequest {
+  DlmsCosemComponent *parent;
+  DlmsRequest request;
+  bool mission_critical;
+
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> /*script*/) noexcept {
+    this->parent->send_dlms_req_and_next(this->request, State::SESSION_SCRIPT, this->mission_critical);
+  }
+  int await_resume() const noexcept { return this->parent->dlms_reading_state_.last_error; }
+};
+
+// co_await delay_(): the WAIT state, nothing to wait for when ms is 0
+struct DlmsCosemComponent::ScriptDelay {
+  DlmsCosemComponent *parent;
+  uint32_t ms;
+
+  bool await_ready() const noexcept { return this->ms == 0; }
+  void await_suspend(std::coroutine_handle<> /*script*/) noexcept {
+    this->parent->set_next_state_delayed_(this->ms, State::SESSION_SCRIPT);
+  }
+  void await_resume() const noexcept {}
+};
+
+DlmsCosemComponent::ScriptRequest DlmsCosemComponent::request_(DlmsRequest request, bool mission_critical) {
+  return {this, request, mission_critical};
+}
+
+DlmsCosemComponent::ScriptDelay DlmsCosemComponent::delay_(uint32_t ms) { return {this, ms}; }
+
+void DlmsCosemComponent::handle_session_script_() {
+  if (!this->script_) {
+    this->abort_mission_();
+    return;
+  }
+  if (this->script_.resume())
+    this->script_.reset();
+}
+
+// The session of the BUFFERS_REQ..DISCONNECT_REQ states, step by step, with the same per-object helpers.
+// The states stay: builds without coroutine_session have no -fcoroutines, and a script whose frame
+// does not fit the pool falls back to them.
+SessionTask DlmsCosemComponent::session_script_() {
+  auto &ls = this->loop_state_;
+  co_await this->request_(DlmsRequest::SNRM, true);
+  co_await this->request_(DlmsRequest::AARQ);
+
+  bool more = this->select_next_request_();
+  while (more) {
+    this->begin_object_();
+    DlmsRequest request;
+    const bool units = this->object_needs_units_();
+    if (units) {
+      if (this->prepare_object_request_(true, true, &request) == DLMS_ERROR_CODE_OK)
+        co_await this->request_(request);
+      this->set_sensor_scale_and_unit(static_cast<DlmsCosemSensor *>(ls.request));
+    }
+    if (this->prepare_object_request_(false, !units, &request) == DLMS_ERROR_CODE_OK) {
+      co_await this->request_(request);
+      this->object_done_();
+    }
+    more = this->select_next_request_();
+    co_await this->delay_(this->delay_between_requests_ms_);
+  }
+  ESP_LOGD(TAG, "All requests done");
+
+  this->start_publish_();
+  if (this->auth_required_) {
+    ESP_LOGD(TAG, "Session release request");
+    co_await this->request_(DlmsRequest::RELEASE);
+  }
+  ESP_LOGD(TAG, "Disconnect request");
+  co_await this->request_(DlmsRequest::DISCONNECT);
+  this->set_next_state_(State::PUBLISH);
+}
+#endif  // ENABLE_DLMS_COSEM_COROUTINES
+
 #ifdef ENABLE_DLMS_COSEM_PUSH_MODE
 void DlmsCosemComponent::handle_push_data_process_() {
   this->log_state_();
@@ -679,7 +1059,75 @@ void DlmsCosemComponent::handle_push_data_process_() {
   this->loop_state_.sensor_iter = this->sensors_.begin();
   this->set_next_state_(State::PUBLISH);
   this->process_push_data();
-  this->clear_rx_buffers_();
+  // don't touch the UART here: the next telegram may already be arriving into push_rx_
+  this->buffers_.in.size = 0;
+  this->buffers_.in.position = 0;
+}
+
+void DlmsCosemComponent::push_receive_() {
+  auto &rx = this->push_rx_;
+  int available = this->port_->available();
+
+  if (available > 0) {
+    if (!rx.receiving) {
+      if (rx.ready) {
+        ESP_LOGW(TAG, "Push telegram dropped: previous one is still being processed");
+        this->stats_.push_dropped_++;
+        rx.ready = false;
+      }
+      rx.buf.size = 0;
+      rx.buf.position = 0;
+      rx.receiving = true;
+      rx.overflow = false;
+      rx.started_ms = millis();
+      if (this->capture_ != nullptr)
+        this->capture_->restart();
+      this->push_assembler_.reset();
+      this->indicate_transmission(true);
+    }
+
+    while (available > 0) {
+      size_t room = rx.buf.capacity - rx.buf.size;
+      if (room == 0 || rx.overflow) {
+        if (!rx.overflow) {
+          ESP_LOGW(TAG, "Push telegram larger than %u bytes, dropping it", (unsigned) rx.buf.capacity);
+          this->stats_.push_overflows_++;
+          rx.overflow = true;
+        }
+        uint8_t scratch[32];
+        size_t n = std::min((size_t) available, sizeof(scratch));
+        this->port_->read_array(scratch, n);
+        available -= n;
+        continue;
+      }
+      size_t n = std::min((size_t) available, room);
+      this->port_->read_array(rx.buf.data + rx.buf.size, n);
+      this->bus_usage_->rx_us += BusUsage::byte_time_us(n, this->current_baud_rate_);
+      rx.buf.size += n;
+      available -= n;
+      if (rx.buf.size > this->stats_.push_peak_bytes_)
+        this->stats_.push_peak_bytes_ = rx.buf.size;
+      this->push_assembler_.feed(&rx.buf);
+    }
+    rx.last_rx_ms = millis();
+    return;
+  }
+
+  if (!rx.receiving || millis() - rx.last_rx_ms < this->receive_timeout_ms_)
+    return;
+
+  // silence on the line: telegram is complete. The meter held the bus for all of it, dropped or not.
+  rx.receiving = false;
+  this->indicate_transmission(false);
+  this->bus_usage_->session_us += (uint64_t) (rx.last_rx_ms - rx.started_ms) * 1000;
+  this->bus_usage_->sessions++;
+  if (rx.overflow)
+    return;  // already counted in push_overflows_, push_dropped_ is for busy drops only
+  this->push_assembler_.finish(&rx.buf);
+  if (rx.buf.size > 0) {
+    this->stats_.push_telegrams_++;
+    rx.ready = true;
+  }
 }
 #endif
 
@@ -694,7 +1142,16 @@ void DlmsCosemComponent::handle_publish_() {
     }
     this->loop_state_.sensor_iter++;
   } else {
+    if (!this->is_push_mode()) {
+      this->session_stats_report_();
+    } else {
+      this->stats_.last_session_ms_ = millis() - this->loop_state_.session_started_ms;
+    }
     this->stats_dump();
+    this->timing_dump();
+    if (!this->is_push_mode()) {
+      this->telemetry_dump();
+    }
     if (this->crc_errors_per_session_sensor_ != nullptr) {
       this->crc_errors_per_session_sensor_->publish_state(this->stats_.crc_errors_per_session());
     }
@@ -702,6 +1159,7 @@ void DlmsCosemComponent::handle_publish_() {
     if (!this->is_push_mode()) {
       this->unlock_uart_session_();
     }
+    this->publish_diagnostics_();
     this->set_next_state_(State::IDLE);
     ESP_LOGD(TAG, "Total time: %u ms", millis() - this->loop_state_.session_started_ms);
   }
@@ -716,14 +1174,81 @@ void DlmsCosemComponent::update() {
 #endif
 
   if (this->state_ != State::IDLE) {
+    if (this->session_kind_ != SessionKind::SCHEDULED) {
+      this->update_pending_ = true;
+      return;
+    }
     ESP_LOGD(TAG, "Starting data collection impossible - component not ready");
     return;
   }
   ESP_LOGD(TAG, "Starting data collection");
+  this->start_session_(SessionKind::SCHEDULED);
+}
+
+void DlmsCosemComponent::start_session_(SessionKind kind) {
+  this->session_kind_ = kind;
+  if (kind == SessionKind::SCHEDULED)
+    this->update_pending_ = false;
   this->has_error = false;
   this->set_next_state_(State::TRY_LOCK_BUS);
 }
 
+void DlmsCosemComponent::trigger_fast_poll_(const FastPollTrigger &trigger, uint32_t now) {
+  const uint32_t until = (now + trigger.duration_ms) | 1;  // 0 means no burst
+  size_t objects = 0;
+  for (uint64_t key : trigger.targets) {
+    auto range = this->sensors_.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it)
+      it->second->set_fast_poll_until(until);
+    objects += range.first != range.second;
+  }
+  if (objects == 0) {
+    ESP_LOGV(TAG, "Fast poll event, but no sensor reads its objects");
+    return;
+  }
+  if (this->fast_poll_until_ms_ == 0) {
+    ESP_LOGD(TAG, "Fast polling %u object(s) for %u ms", (unsigned) objects, trigger.duration_ms);
+    this->stats_.fast_poll_bursts_++;
+    this->fast_poll_started_ms_ = now;
+    this->fast_poll_last_ms_ = now;  // this session has just read them
+    this->fast_poll_bus_us_ = this->bus_usage_->session_us;
+    this->fast_poll_until_ms_ = until;
+  } else if ((int32_t) (until - this->fast_poll_until_ms_) > 0) {
+    this->fast_poll_until_ms_ = until;
+  }
+}
+
+bool DlmsCosemComponent::has_fast_poll_() const {
+#ifdef USE_SENSOR
+  for (const auto &it : this->sensors_) {
+    if (it.second->get_type() == SensorType::SENSOR && static_cast<DlmsCosemSensor *>(it.second)->has_fast_poll())
+      return true;
+  }
+#endif
+  return false;
+}
+
+bool DlmsCosemComponent::fast_poll_due_(uint32_t now) {
+  if ((int32_t) (this->fast_poll_until_ms_ - now) <= 0) {
+    ESP_LOGD(TAG, "Fast polling finished after %u ms", now - this->fast_poll_started_ms_);
+    this->fast_poll_until_ms_ = 0;
+    return false;
+  }
+  if (now - this->fast_poll_last_ms_ < this->fast_poll_interval_ms_)
+    return false;
+  this->fast_poll_last_ms_ = now;
+
+  // share of the burst the bus has been held by sessions, this meter's and others'
+  const uint64_t held_us = this->bus_usage_->session_us - this->fast_poll_bus_us_;
+  const uint64_t burst_us = (uint64_t) (now - this->fast_poll_started_ms_) * 1000;
+  if (held_us > burst_us * this->fast_poll_max_utilization_) {
+    ESP_LOGV(TAG, "Fast poll skipped, bus utilization %.0f%%", 100.0f * held_us / burst_us);
+    this->stats_.fast_poll_capped_++;
+    return false;
+  }
+  return true;
+}
+
 bool char2float(const char *str, float &value) {
   char *end;
   value = strtof(str, &end);
@@ -742,9 +1267,8 @@ void DlmsCosemComponent::set_next_state_delayed_(uint32_t ms, State next_state)
   }
 }
 
-void DlmsCosemComponent::InOutBuffers::init(size_t default_in_buf_size) {
-  BYTE_BUFFER_INIT(&in);
-  bb_capacity(&in, default_in_buf_size);
+void DlmsCosemComponent::InOutBuffers::init(uint8_t *in_data, size_t in_size) {
+  attach_arena_buffer(&in, in_data, in_size);
   mes_init(&out_msg);
   reply_init(&reply);
   this->reset();
@@ -754,6 +1278,7 @@ void DlmsCosemComponent::InOutBuffers::reset() {
   mes_clear(&out_msg);
   reply_clear(&reply);
   reply.complete = 1;
+  get_result_valid = false;
   out_msg_index = 0;
   out_msg_data_pos = 0;
   in.size = 0;
@@ -761,94 +1286,112 @@ void DlmsCosemComponent::InOutBuffers::reset() {
   //  amount_in = 0;
 }
 
-void DlmsCosemComponent::InOutBuffers::check_and_grow_input(uint16_t more_data) {
-  const uint16_t GROW_EPSILON = 20;
-  if (in.size + more_data > in.capacity) {
-    ESP_LOGVV(TAG0, "Growing input buffer from %d to %d", in.capacity, in.size + more_data + GROW_EPSILON);
-    bb_capacity(&in, in.size + more_data + GROW_EPSILON);
-  }
-}
-
 void DlmsCosemComponent::prepare_and_send_dlms_buffers() {
-  auto make = [this]() {
-    ESP_LOGD(TAG0, "cl_snrmRequest %p ", this->buffers_.out_msg.data);
-    return cl_snrmRequest(&this->dlms_settings_, &this->buffers_.out_msg);
-  };
-  auto parse = [this]() { return cl_parseUAResponse(&this->dlms_settings_, &this->buffers_.reply.data); };
-  this->send_dlms_req_and_next(make, parse, State::BUFFERS_RCV, true);
+  this->send_dlms_req_and_next(DlmsRequest::SNRM, State::BUFFERS_RCV, true);
 }
 
 void DlmsCosemComponent::prepare_and_send_dlms_aarq() {
-  auto make = [this]() { return cl_aarqRequest(&this->dlms_settings_, &this->buffers_.out_msg); };
-  auto parse = [this]() { return cl_parseAAREResponse(&this->dlms_settings_, &this->buffers_.reply.data); };
-  this->send_dlms_req_and_next(make, parse, State::ASSOCIATION_RCV);
+  this->send_dlms_req_and_next(DlmsRequest::AARQ, State::ASSOCIATION_RCV);
 }
 
-void DlmsCosemComponent::prepare_and_send_dlms_data_unit_request(const char *obis, int type) {
-  auto ret = cosem_init(BASE(this->buffers_.gx_register), (DLMS_OBJECT_TYPE) type, obis);
-  if (ret != DLMS_ERROR_CODE_OK) {
-    ESP_LOGE(TAG, "cosem_init error %d '%s'", ret, dlms_error_to_string(ret));
+void DlmsCosemComponent::prepare_and_send_dlms_data_unit_request() {
+  DlmsRequest request;
+  if (this->prepare_object_request_(true, true, &request) != DLMS_ERROR_CODE_OK) {
     this->set_next_state_(State::DATA_ENQ);
     return;
   }
 
-  auto make = [this]() {
-    return cl_read(&this->dlms_settings_, BASE(this->buffers_.gx_register), this->buffers_.gx_attribute,
-                   &this->buffers_.out_msg);
-  };
-  auto parse = [this]() {
-    return cl_updateValue(&this->dlms_settings_, BASE(this->buffers_.gx_register), this->buffers_.gx_attribute,
-                          &this->buffers_.reply.dataValue);
-  };
-  this->send_dlms_req_and_next(make, parse, State::DATA_ENQ, false, false);
+  this->send_dlms_req_and_next(request, State::DATA_ENQ, false, false);
 }
 
-void DlmsCosemComponent::prepare_and_send_dlms_data_request(const char *obis, int type, bool reg_init) {
-  int ret = DLMS_ERROR_CODE_OK;
-  if (type == DLMS_OBJECT_TYPE_CLOCK) {
-    ret = cosem_init(BASE(this->buffers_.gx_clock), (DLMS_OBJECT_TYPE) type, obis);
-  } else if (reg_init) {
-    ret = cosem_init(BASE(this->buffers_.gx_register), (DLMS_OBJECT_TYPE) type, obis);
-  }
-  if (ret != DLMS_ERROR_CODE_OK) {
-    ESP_LOGE(TAG, "cosem_init error %d '%s'", ret, dlms_error_to_string(ret));
+void DlmsCosemComponent::prepare_and_send_dlms_data_request(bool reg_init) {
+  DlmsRequest request;
+  if (this->prepare_object_request_(false, reg_init, &request) != DLMS_ERROR_CODE_OK) {
     this->set_next_state_(State::DATA_NEXT);
     return;
   }
 
-  auto make = [this, type]() {
-    return (type == DLMS_OBJECT_TYPE_CLOCK)
-               ? cl_read(&this->dlms_settings_, BASE(this->buffers_.gx_clock), this->buffers_.gx_attribute,
-                         &this->buffers_.out_msg)
-               : cl_read(&this->dlms_settings_, BASE(this->buffers_.gx_register), this->buffers_.gx_attribute,
-                         &this->buffers_.out_msg);
-  };
-  auto parse = [this, type]() {
-    return (type == DLMS_OBJECT_TYPE_CLOCK)
-               ? cl_updateValue(&this->dlms_settings_, BASE(this->buffers_.gx_clock), this->buffers_.gx_attribute,
-                                &this->buffers_.reply.dataValue)
-               : cl_updateValue(&this->dlms_settings_, BASE(this->buffers_.gx_register), this->buffers_.gx_attribute,
-                                &this->buffers_.reply.dataValue);
-  };
-  this->send_dlms_req_and_next(make, parse, State::DATA_RECV);
+  this->send_dlms_req_and_next(request, State::DATA_RECV);
 }
 
 void DlmsCosemComponent::prepare_and_send_dlms_release() {
-  auto make = [this]() { return cl_releaseRequest(&this->dlms_settings_, &this->buffers_.out_msg); };
-  auto parse = []() { return DLMS_ERROR_CODE_OK; };
-  this->send_dlms_req_and_next(make, parse, State::DISCONNECT_REQ);
+  this->send_dlms_req_and_next(DlmsRequest::RELEASE, State::DISCONNECT_REQ);
 }
 
 void DlmsCosemComponent::prepare_and_send_dlms_disconnect() {
-  auto make = [this]() { return cl_disconnectRequest(&this->dlms_settings_, &this->buffers_.out_msg); };
-  auto parse = []() { return DLMS_ERROR_CODE_OK; };
-  this->send_dlms_req_and_next(make, parse, State::PUBLISH);
+  this->send_dlms_req_and_next(DlmsRequest::DISCONNECT, State::PUBLISH);
+}
+
+int DlmsCosemComponent::make_request_(DlmsRequest request) {
+  switch (request) {
+    case DlmsRequest::SNRM:
+      ESP_LOGD(TAG0, "cl_snrmRequest %p ", this->buffers_.out_msg.data);
+      return cl_snrmRequest(&this->dlms_settings_, &this->buffers_.out_msg);
+    case DlmsRequest::AARQ:
+      return cl_aarqRequest(&this->dlms_settings_, &this->buffers_.out_msg);
+    case DlmsRequest::READ_REGISTER:
+      return cl_read(&this->dlms_settings_, BASE(this->buffers_.gx_register), this->buffers_.gx_attribute,
+                     &this->buffers_.out_msg);
+    case DlmsRequest::READ_CLOCK:
+      return cl_read(&this->dlms_settings_, BASE(this->buffers_.gx_clock), this->buffers_.gx_attribute,
+                     &this->buffers_.out_msg);
+    case DlmsRequest::RELEASE:
+      return cl_releaseRequest(&this->dlms_settings_, &this->buffers_.out_msg);
+    case DlmsRequest::DISCONNECT:
+      return cl_disconnectRequest(&this->dlms_settings_, &this->buffers_.out_msg);
+    default:
+      return DLMS_ERROR_CODE_OK;
+  }
+}
+
+int DlmsCosemComponent::parse_reply_(DlmsRequest request) {
+  switch (request) {
+    case DlmsRequest::SNRM:
+      return cl_parseUAResponse(&this->dlms_settings_, &this->buffers_.reply.data);
+    case DlmsRequest::AARQ:
+      return cl_parseAAREResponse(&this->dlms_settings_, &this->buffers_.reply.data);
+    case DlmsRequest::READ_REGISTER:
+    case DlmsRequest::READ_CLOCK:
+      return this->parse_get_response_(request);
+    default:
+      return DLMS_ERROR_CODE_OK;
+  }
+}
+
+// Sends the current request again after its reply timed out or came in corrupted. HDLC keeps the
+// same N(S), so a meter that did get the request answers the repeated frame with its last reply.
+// Only while nothing of the reply has been accepted: a half-received multi-frame reply can't be asked again.
+bool DlmsCosemComponent::retry_request_() {
+  if (this->reading_state_.tries_counter + 1 >= this->reading_state_.tries_max || this->buffers_.reply.data.size > 0)
+    return false;
+  this->reading_state_.tries_counter++;
+  this->loop_state_.session.retries++;
+  this->loop_state_.object_retries++;
+  ESP_LOGW(TAG, "No valid reply, sending the request again (%u of %u)", this->reading_state_.tries_counter,
+           this->reading_state_.tries_max - 1);
+  this->clear_rx_buffers_();
+  this->buffers_.out_msg_index = 0;
+  this->buffers_.out_msg_data_pos = 0;
+  this->set_next_state_(State::COMMS_TX);
+  return true;
+}
+
+// GET values are read straight from the reply buffer, the same way push values are. What the
+// decoder does not handle (compact arrays and the like) still goes through cl_updateValue().
+int DlmsCosemComponent::parse_get_response_(DlmsRequest request) {
+  auto &b = this->buffers_;
+  b.get_result_valid = dlms_parse_data_value(b.reply.data.data, b.reply.data.size, &b.get_result);
+  if (b.get_result_valid) {
+    ESP_LOGVV(TAG, "GET response: %s, %u bytes", dlms_data_type_to_string(b.get_result.type), b.get_result.length);
+    return DLMS_ERROR_CODE_OK;
+  }
+  gxObject *object = request == DlmsRequest::READ_CLOCK ? BASE(b.gx_clock) : BASE(b.gx_register);
+  return cl_updateValue(&this->dlms_settings_, object, b.gx_attribute, &b.reply.dataValue);
 }
 
-void DlmsCosemComponent::send_dlms_req_and_next(DlmsRequestMaker maker, DlmsResponseParser parser, State next_state,
-                                                bool mission_critical, bool clear_buffer) {
-  dlms_reading_state_.maker_fn = maker;
-  dlms_reading_state_.parser_fn = parser;
+void DlmsCosemComponent::send_dlms_req_and_next(DlmsRequest request, State next_state, bool mission_critical,
+                                                bool clear_buffer) {
+  dlms_reading_state_.request = request;
   dlms_reading_state_.next_state = next_state;
   dlms_reading_state_.mission_critical = mission_critical;
   dlms_reading_state_.reply_is_complete = false;
@@ -857,20 +1400,20 @@ void DlmsCosemComponent::send_dlms_req_and_next(DlmsRequestMaker maker, DlmsResp
   // if (clear_buffer) {
   buffers_.reset();
   // }
-  int ret = DLMS_ERROR_CODE_OK;
-  if (maker != nullptr) {
-    ret = maker();
-    if (ret != DLMS_ERROR_CODE_OK) {
-      ESP_LOGE(TAG, "Error in DLSM request maker function %d '%s'", ret, dlms_error_to_string(ret));
-      this->set_next_state_(State::IDLE);
-      return;
-    }
+  int ret = this->make_request_(request);
+  if (ret != DLMS_ERROR_CODE_OK) {
+    ESP_LOGE(TAG, "Error in DLSM request maker function %d '%s'", ret, dlms_error_to_string(ret));
+    this->set_next_state_(State::IDLE);
+    return;
   }
 
   reading_state_ = {};
-  //  reading_state_.read_fn = read_fn;
   reading_state_.mission_critical = mission_critical;
-  reading_state_.tries_max = 1;  // retries;
+  reading_state_.tries_max = 1;
+  // object reads are sent again when the reply is lost; session setup and release are not
+  if ((request == DlmsRequest::READ_REGISTER || request == DlmsRequest::READ_CLOCK) &&
+      !this->loop_state_.read_now_active && this->loop_state_.request != nullptr)
+    reading_state_.tries_max += this->loop_state_.request->get_request_retries();
   reading_state_.tries_counter = 0;
   //  reading_state_.check_crc = check_crc;
   reading_state_.next_state = next_state;
@@ -893,6 +1436,8 @@ void DlmsCosemComponent::process_push_data() {
   size_t total_objects = 0;
   size_t iterations = 0;
 
+  // one budget for the telegram, not for each parse() call
+  this->axdr_parser_->begin_frame();
   while (this->buffers_.in.position < this->buffers_.in.size) {
     auto before = this->buffers_.in.position;
     auto parsed_now = this->axdr_parser_->parse();
@@ -915,48 +1460,55 @@ void DlmsCosemComponent::process_push_data() {
            static_cast<unsigned>(this->buffers_.in.position), static_cast<unsigned>(total_size));
 }
 
+void DlmsCosemComponent::build_push_index_() {
+  this->push_index_.reserve(this->sensors_.size());
+  for (const auto &entry : this->sensors_)
+    this->push_index_.add(entry.first, entry.second);
+  this->push_index_.build();
+}
+
 int DlmsCosemComponent::set_sensor_value(uint16_t class_id, const uint8_t *obis_code, DLMS_DATA_TYPE value_type,
                                          const uint8_t *value_buffer_ptr, uint8_t value_length, const int8_t *scaler,
                                          const uint8_t *unit) {
-  static char obis_buf[32];
-  auto er = hlp_getLogicalNameToString(obis_code, obis_buf);
+  auto range = this->push_index_.find(obis_code);
+  if (range.empty()) {
+    ESP_LOGVV(TAG, "No sensor found for OBIS code: '%u.%u.%u.%u.%u.%u'", obis_code[0], obis_code[1], obis_code[2],
+              obis_code[3], obis_code[4], obis_code[5]);
+    return DLMS_ERROR_CODE_OK;
+  }
 
-  std::string obis_str(obis_buf);
+  // decoded once for all sensors of this OBIS code
+  DlmsNumber number;
+  dlms_data_as_number(value_type, value_buffer_ptr, value_length, &number);
+  if (scaler != nullptr)
+    number.scale(*scaler);
 
-  auto range = this->sensors_.equal_range(obis_str);
   int found_count = 0;
-  for (auto it = range.first; it != range.second; ++it) {
-    DlmsCosemSensorBase *sensor = it->second;
+  for (DlmsCosemSensorBase *sensor : range) {
     if (!sensor->shall_we_publish()) {
       continue;
     }
-    ESP_LOGD(TAG, "Found sensor for OBIS code %s: '%s' ", obis_buf, sensor->get_sensor_name().c_str());
+    ESP_LOGD(TAG, "Found sensor for OBIS code %s: '%s' ", sensor->get_obis_code().c_str(),
+             sensor->get_sensor_name());
     found_count++;
 
 #ifdef USE_SENSOR
     if (sensor->get_type() == SensorType::SENSOR) {
-      float val = dlms_data_as_float(value_type, value_buffer_ptr, value_length);
-      if (scaler != nullptr) {
-        float scale = pow(10, *scaler);
-        val *= scale;
-      }
-      static_cast<DlmsCosemSensor *>(sensor)->set_value(val);
+      static_cast<DlmsCosemSensor *>(sensor)->set_value(number);
     }
 #endif
 
 #ifdef USE_TEXT_SENSOR
     if (sensor->get_type() == SensorType::TEXT_SENSOR) {
-      auto val = dlms_data_as_string(value_type, value_buffer_ptr, value_length);
-      static_cast<DlmsCosemTextSensor *>(sensor)->set_value(val.c_str(), this->cp1251_conversion_required_);
+      char buf[DLMS_VALUE_STRING_SIZE];
+      size_t len = dlms_data_to_chars(buf, sizeof(buf), value_type, value_buffer_ptr, value_length);
+      static_cast<DlmsCosemTextSensor *>(sensor)->set_value(buf, len, value_type, this->cp1251_conversion_required_);
     }
 #endif
   }
 
-  if (found_count == 0) {
-    ESP_LOGVV(TAG, "No sensor found for OBIS code: '%s'", (char *) obis_buf);
-  } else {
-    ESP_LOGVV(TAG, "Updated %d sensors for OBIS code: '%s'", found_count, (char *) obis_buf);
-  }
+  ESP_LOGVV(TAG, "Updated %d sensors for OBIS code: '%u.%u.%u.%u.%u.%u'", found_count, obis_code[0], obis_code[1],
+            obis_code[2], obis_code[3], obis_code[4], obis_code[5]);
 
   return DLMS_ERROR_CODE_OK;
 }
@@ -967,6 +1519,16 @@ int DlmsCosemComponent::set_sensor_scale_and_unit(DlmsCosemSensor *sensor) {
   ESP_LOGD(TAG, "set_sensor_scale_and_unit");
   if (!buffers_.reply.complete)
     return DLMS_ERROR_CODE_FALSE;
+  if (this->dlms_reading_state_.last_error != DLMS_ERROR_CODE_OK)
+    return this->dlms_reading_state_.last_error;  // asked again next session
+  if (this->buffers_.get_result_valid) {
+    int8_t scaler;
+    uint8_t unit;
+    if (!dlms_parse_scaler_unit(this->buffers_.reply.data.data, this->buffers_.get_result, &scaler, &unit))
+      return DLMS_ERROR_CODE_FALSE;
+    sensor->set_scale_and_unit(scaler, unit, obj_getUnitAsString(unit));
+    return DLMS_ERROR_CODE_OK;
+  }
   auto vt = buffers_.reply.dataType;
   ESP_LOGD(TAG, "DLMS_DATA_TYPE: %s (%d)", dlms_data_type_to_string(vt), vt);
   if (vt != 0) {
@@ -981,11 +1543,73 @@ int DlmsCosemComponent::set_sensor_scale_and_unit(DlmsCosemSensor *sensor) {
   return DLMS_ERROR_CODE_OK;
 }
 
+// Integer variants are taken from their own union member, var_toInteger() would cut them to int
+static DlmsNumber variant_as_number(dlmsVARIANT *var) {
+  DlmsNumber n;
+  switch (var->vt) {
+    case DLMS_DATA_TYPE_BOOLEAN:
+      n.mantissa = var->boolVal;
+      break;
+    case DLMS_DATA_TYPE_ENUM:
+    case DLMS_DATA_TYPE_UINT8:
+      n.mantissa = var->bVal;
+      break;
+    case DLMS_DATA_TYPE_INT8:
+      n.mantissa = var->cVal;
+      break;
+    case DLMS_DATA_TYPE_UINT16:
+      n.mantissa = var->uiVal;
+      break;
+    case DLMS_DATA_TYPE_INT16:
+      n.mantissa = var->iVal;
+      break;
+    case DLMS_DATA_TYPE_UINT32:
+      n.mantissa = (uint32_t) var->ulVal;
+      break;
+    case DLMS_DATA_TYPE_INT32:
+      n.mantissa = (int32_t) var->lVal;
+      break;
+    case DLMS_DATA_TYPE_INT64:
+      n.mantissa = var->llVal;
+      break;
+    case DLMS_DATA_TYPE_UINT64:
+      if (var->ullVal > (unsigned long long) INT64_MAX) {
+        n.mantissa = (int64_t) (var->ullVal / 10);
+        n.exponent = 1;
+      } else {
+        n.mantissa = (int64_t) var->ullVal;
+      }
+      break;
+    case DLMS_DATA_TYPE_FLOAT32:
+      n.is_real = true;
+      n.real = var->fltVal;
+      break;
+    case DLMS_DATA_TYPE_FLOAT64:
+      n.is_real = true;
+      n.real = var->dblVal;
+      break;
+    default:
+      n.mantissa = var_toInteger(var);
+      break;
+  }
+  return n;
+}
+
 int DlmsCosemComponent::set_sensor_value(DlmsCosemSensorBase *sensor, const char *obis) {
   if (!buffers_.reply.complete || !sensor->shall_we_publish()) {
     return this->dlms_reading_state_.last_error;
   }
 
+  if (this->buffers_.get_result_valid) {
+    if (this->dlms_reading_state_.last_error == DLMS_ERROR_CODE_OK) {
+      this->set_sensor_value_from_get_result_(sensor, obis);
+    } else {
+      ESP_LOGD(TAG, "OBIS code: %s, access result %d %s", obis, this->dlms_reading_state_.last_error,
+               dlms_error_to_string(this->dlms_reading_state_.last_error));
+    }
+    return this->dlms_reading_state_.last_error;
+  }
+
   auto vt = buffers_.reply.dataType;
   auto object_class = sensor->get_obis_class();
   ESP_LOGD(TAG, "Class: %d, OBIS code: %s, DLMS_DATA_TYPE: %s (%d)", object_class, obis, dlms_data_type_to_string(vt),
@@ -1002,15 +1626,10 @@ int DlmsCosemComponent::set_sensor_value(DlmsCosemSensorBase *sensor, const char
         auto var = &this->buffers_.gx_register.value;
         auto scale = static_cast<DlmsCosemSensor *>(sensor)->get_scale();
         auto unit = static_cast<DlmsCosemSensor *>(sensor)->get_unit();
-        if (vt == DLMS_DATA_TYPE_FLOAT32 || vt == DLMS_DATA_TYPE_FLOAT64) {
-          float val = var_toDouble(var);
-          ESP_LOGD(TAG, "OBIS code: %s, Value: %f, Scale: %f, Unit: %s", obis, val, scale, unit);
-          static_cast<DlmsCosemSensor *>(sensor)->set_value(val);
-        } else {
-          int val = var_toInteger(var);
-          ESP_LOGD(TAG, "OBIS code: %s, Value: %d, Scale: %f, Unit: %s", obis, val, scale, unit);
-          static_cast<DlmsCosemSensor *>(sensor)->set_value(val);
-        }
+        DlmsNumber number = variant_as_number(var);
+        ESP_LOGD(TAG, "OBIS code: %s, Value: %f, Scale: %d, Unit: %d", obis, number.to_double(), scale, unit);
+        number.scale(scale);
+        static_cast<DlmsCosemSensor *>(sensor)->set_value(number);
       } else {
         ESP_LOGW(TAG, "Wrong OBIS class. Regular numberic sensors can only "
                       "handle Data (class 1), Registers (class = 3) and Extended Registers (class = 4)");
@@ -1030,7 +1649,8 @@ int DlmsCosemComponent::set_sensor_value(DlmsCosemSensorBase *sensor, const char
         strftime(obis_datetime_str, sizeof(obis_datetime_str), "%Y-%m-%d %H:%M:%S", &tm_val);
 
         ESP_LOGD(TAG, "OBIS code: %s, Clock: %s", obis, obis_datetime_str);
-        static_cast<DlmsCosemTextSensor *>(sensor)->set_value(obis_datetime_str, this->cp1251_conversion_required_);
+        static_cast<DlmsCosemTextSensor *>(sensor)->set_value(obis_datetime_str, DLMS_DATA_TYPE_DATETIME,
+                                                              this->cp1251_conversion_required_);
         return this->dlms_reading_state_.last_error;
       }
 
@@ -1049,9 +1669,10 @@ int DlmsCosemComponent::set_sensor_value(DlmsCosemSensorBase *sensor, const char
 
         if ((object_class == DLMS_OBJECT_TYPE_DATA) || (object_class == DLMS_OBJECT_TYPE_REGISTER) ||
             (object_class == DLMS_OBJECT_TYPE_EXTENDED_REGISTER)) {
-          auto data_as_string = dlms_data_as_string(vt, arr->data, arr->size);
-          static_cast<DlmsCosemTextSensor *>(sensor)->set_value(data_as_string.c_str(),
-                                                                this->cp1251_conversion_required_);
+          char buf[DLMS_VALUE_STRING_SIZE];
+          uint8_t data_len = std::min<size_t>(arr->size - 1, 127);  // without the terminator added above
+          size_t len = dlms_data_to_chars(buf, sizeof(buf), vt, arr->data, data_len);
+          static_cast<DlmsCosemTextSensor *>(sensor)->set_value(buf, len, vt, this->cp1251_conversion_required_);
         } else {
           ESP_LOGW(TAG, "Wrong OBIS class. We can only handle Data (class 1), Registers (class = 3), Extended "
                         "Registers (class = 4), and Clock (class = 8) for text sensors.");
@@ -1065,6 +1686,185 @@ int DlmsCosemComponent::set_sensor_value(DlmsCosemSensorBase *sensor, const char
   return this->dlms_reading_state_.last_error;
 }
 
+void DlmsCosemComponent::set_sensor_value_from_get_result_(DlmsCosemSensorBase *sensor, const char *obis) {
+  const auto &res = this->buffers_.get_result;
+  const uint8_t *value = this->buffers_.reply.data.data + res.offset;
+  const uint8_t value_length = std::min<uint16_t>(res.length, UINT8_MAX);
+  auto object_class = sensor->get_obis_class();
+  ESP_LOGD(TAG, "Class: %d, OBIS code: %s, DLMS_DATA_TYPE: %s (%d)", object_class, obis,
+           dlms_data_type_to_string(res.type), res.type);
+
+#ifdef USE_SENSOR
+  if (sensor->get_type() == SensorType::SENSOR) {
+    if ((object_class != DLMS_OBJECT_TYPE_DATA) && (object_class != DLMS_OBJECT_TYPE_REGISTER) &&
+        (object_class != DLMS_OBJECT_TYPE_EXTENDED_REGISTER)) {
+      ESP_LOGW(TAG, "Wrong OBIS class. Regular numberic sensors can only "
+                    "handle Data (class 1), Registers (class = 3) and Extended Registers (class = 4)");
+      return;
+    }
+    DlmsNumber number;
+    if (!dlms_data_as_number(res.type, value, value_length, &number)) {
+      ESP_LOGW(TAG, "OBIS code: %s, %s is not a number", obis, dlms_data_type_to_string(res.type));
+      return;
+    }
+    auto scale = static_cast<DlmsCosemSensor *>(sensor)->get_scale();
+    ESP_LOGD(TAG, "OBIS code: %s, Value: %f, Scale: %d", obis, number.to_double(), scale);
+    number.scale(scale);
+    static_cast<DlmsCosemSensor *>(sensor)->set_value(number);
+  }
+#endif  // USE_SENSOR
+
+#ifdef USE_TEXT_SENSOR
+  if (sensor->get_type() == SensorType::TEXT_SENSOR) {
+    auto vt = res.type;
+    if (object_class == DLMS_OBJECT_TYPE_CLOCK) {
+      // Clock::time is a date-time sent as a 12-byte octet string
+      if (vt == DLMS_DATA_TYPE_OCTET_STRING && value_length == 12)
+        vt = DLMS_DATA_TYPE_DATETIME;
+    } else if ((object_class != DLMS_OBJECT_TYPE_DATA) && (object_class != DLMS_OBJECT_TYPE_REGISTER) &&
+               (object_class != DLMS_OBJECT_TYPE_EXTENDED_REGISTER)) {
+      ESP_LOGW(TAG, "Wrong OBIS class. We can only handle Data (class 1), Registers (class = 3), Extended "
+                    "Registers (class = 4), and Clock (class = 8) for text sensors.");
+      return;
+    }
+    char buf[DLMS_VALUE_STRING_SIZE];
+    size_t len = dlms_data_to_chars(buf, sizeof(buf), vt, value, value_length);
+    ESP_LOGD(TAG, "OBIS code: %s, Value: %s", obis, buf);
+    static_cast<DlmsCosemTextSensor *>(sensor)->set_value(buf, len, vt, this->cp1251_conversion_required_);
+  }
+#endif  // USE_TEXT_SENSOR
+}
+
+bool DlmsCosemComponent::read_now(const char *obis, uint16_t class_id, uint8_t attribute, ReadNowCallback callback) {
+  if (this->is_push_mode()) {
+    ESP_LOGW(TAG, "read_now(%s): not available in push mode", obis);
+    return false;
+  }
+  // gx_register/gx_clock are the only request objects, see prepare_and_send_dlms_data_request()
+  if (class_id != DLMS_OBJECT_TYPE_DATA && class_id != DLMS_OBJECT_TYPE_REGISTER && class_id != DLMS_OBJECT_TYPE_CLOCK) {
+    ESP_LOGW(TAG, "read_now(%s): class %u not supported", obis, class_id);
+    return false;
+  }
+  ReadNowRequest req;
+  if (!obis_parse(obis, req.obis)) {
+    ESP_LOGW(TAG, "read_now: invalid OBIS code '%s'", obis);
+    return false;
+  }
+  if (this->read_now_count_ == READ_NOW_QUEUE_SIZE) {
+    ESP_LOGW(TAG, "read_now(%s): %u requests already waiting", obis, READ_NOW_QUEUE_SIZE);
+    return false;
+  }
+  req.class_id = class_id;
+  req.attribute = attribute;
+  req.callback = std::move(callback);
+  this->read_now_queue_[(this->read_now_head_ + this->read_now_count_) % READ_NOW_QUEUE_SIZE] = std::move(req);
+  this->read_now_count_++;
+  ESP_LOGD(TAG, "read_now(%s): queued, %u waiting", obis, this->read_now_count_);
+
+  if (this->state_ == State::IDLE)
+    this->start_session_(SessionKind::READ_NOW);
+  return true;
+}
+
+// read_now() result from a value the library decoded
+static void read_now_value_from_variant(dlmsVARIANT *var, double *value, char *text, size_t size) {
+  switch (var->vt) {
+    case DLMS_DATA_TYPE_BOOLEAN:
+    case DLMS_DATA_TYPE_ENUM:
+    case DLMS_DATA_TYPE_INT8:
+    case DLMS_DATA_TYPE_UINT8:
+    case DLMS_DATA_TYPE_INT16:
+    case DLMS_DATA_TYPE_UINT16:
+    case DLMS_DATA_TYPE_INT32:
+    case DLMS_DATA_TYPE_UINT32:
+    case DLMS_DATA_TYPE_INT64:
+    case DLMS_DATA_TYPE_UINT64:
+    case DLMS_DATA_TYPE_FLOAT32:
+    case DLMS_DATA_TYPE_FLOAT64:
+      *value = variant_as_number(var).to_double();
+      break;
+    case DLMS_DATA_TYPE_OCTET_STRING:
+    case DLMS_DATA_TYPE_STRING:
+    case DLMS_DATA_TYPE_STRING_UTF8:
+      // same text as the decoded path gives
+      if (var->byteArr != nullptr) {
+        dlms_data_to_chars(text, size, var->vt, var->byteArr->data, std::min<uint32_t>(var->byteArr->size, UINT8_MAX));
+        return;
+      }
+      break;
+    default:
+      break;
+  }
+  gxByteBuffer out;
+  BYTE_BUFFER_INIT(&out);
+  if (var_toString(var, &out) == DLMS_ERROR_CODE_OK && out.size > 0) {
+    const size_t n = std::min<size_t>(out.size, size - 1);
+    memcpy(text, out.data, n);
+    text[n] = '\0';
+  }
+  bb_clear(&out);
+}
+
+void DlmsCosemComponent::finish_read_now_() {
+  auto &rn = this->loop_state_.read_now;
+  this->loop_state_.read_now_active = false;
+  this->loop_state_.session.objects++;
+
+  const auto obis = obis_to_string(rn.obis);
+  int error = this->dlms_reading_state_.last_error;
+  double value = NAN;
+  char text[DLMS_VALUE_STRING_SIZE] = "";
+  const auto &res = this->buffers_.get_result;
+  if (error == DLMS_ERROR_CODE_OK && this->buffers_.reply.complete && this->buffers_.get_result_valid) {
+    const uint8_t *data = this->buffers_.reply.data.data + res.offset;
+    const uint8_t length = std::min<uint16_t>(res.length, UINT8_MAX);
+    auto vt = res.type;
+    if (rn.class_id == DLMS_OBJECT_TYPE_CLOCK && vt == DLMS_DATA_TYPE_OCTET_STRING && length == 12)
+      vt = DLMS_DATA_TYPE_DATETIME;
+    DlmsNumber number;
+    if (dlms_data_as_number(vt, data, length, &number))
+      value = number.to_double();
+    dlms_data_to_chars(text, sizeof(text), vt, data, length);
+  } else if (error == DLMS_ERROR_CODE_OK && this->buffers_.reply.complete) {
+    // parse_get_response_() left it to cl_updateValue(): take the variant the library decoded
+    read_now_value_from_variant(&this->buffers_.reply.dataValue, &value, text, sizeof(text));
+  }
+  if (error != DLMS_ERROR_CODE_OK) {
+    this->loop_state_.session.objects_failed++;
+    ESP_LOGW(TAG, "read_now(%s): error %d '%s'", obis.c_str(), error, dlms_error_to_string(error));
+  } else {
+    ESP_LOGI(TAG, "read_now(%s), attribute %u: %s", obis.c_str(), rn.attribute, text);
+  }
+
+  if (rn.attribute == 2) {
+    auto range = this->sensors_.equal_range(obis_pack(rn.obis));
+    for (auto it = range.first; it != range.second; ++it) {
+      auto *sensor = it->second;
+      if (sensor->get_obis_class() == rn.class_id && this->set_sensor_value(sensor, obis.c_str()) == DLMS_ERROR_CODE_OK)
+        sensor->publish();
+    }
+  }
+
+  if (rn.callback)
+    rn.callback(error, value, text);
+  rn.callback = nullptr;
+}
+
+void DlmsCosemComponent::fail_read_now_(int error) {
+  auto &ls = this->loop_state_;
+  if (ls.read_now_active && ls.read_now.callback)
+    ls.read_now.callback(error, NAN, "");
+  ls.read_now_active = false;
+  ls.read_now.callback = nullptr;
+  for (; this->read_now_count_ > 0; this->read_now_count_--) {
+    auto &req = this->read_now_queue_[this->read_now_head_];
+    if (req.callback)
+      req.callback(error, NAN, "");
+    req.callback = nullptr;
+    this->read_now_head_ = (this->read_now_head_ + 1) % READ_NOW_QUEUE_SIZE;
+  }
+}
+
 void DlmsCosemComponent::indicate_transmission(bool transmission_on) {
 #ifdef USE_BINARY_SENSOR
   if (this->transmission_binary_sensor_) {
@@ -1095,16 +1895,13 @@ void DlmsCosemComponent::send_dlms_messages_() {
 
   int bytes_to_send = buffer->size - buffers_.out_msg_data_pos;
   if (bytes_to_send > 0) {
+    if (buffers_.out_msg_data_pos == 0)
+      this->trace_.add_frame(SessionTrace::Event::TX, buffer->data, buffer->size);
     if (bytes_to_send > MAX_BYTES_IN_ONE_SHOT)
       bytes_to_send = MAX_BYTES_IN_ONE_SHOT;
 
-    if (this->flow_control_pin_ != nullptr)
-      this->flow_control_pin_->digital_write(true);
-
-    this->write_array(buffer->data + buffers_.out_msg_data_pos, bytes_to_send);
-
-    if (this->flow_control_pin_ != nullptr)
-      this->flow_control_pin_->digital_write(false);
+    this->port_->write_array(buffer->data + buffers_.out_msg_data_pos, bytes_to_send);
+    this->loop_state_.session.bytes_sent += bytes_to_send;
 
     ESP_LOGVV(TAG, "TX: %s", format_hex_pretty(buffer->data + buffers_.out_msg_data_pos, bytes_to_send).c_str());
 
@@ -1112,6 +1909,10 @@ void DlmsCosemComponent::send_dlms_messages_() {
     buffers_.out_msg_data_pos += bytes_to_send;
   }
   if (buffers_.out_msg_data_pos >= buffer->size) {
+    this->loop_state_.session.frames_sent++;
+    this->last_tx_bytes_ = buffer->size;
+    if (buffer->size > this->stats_.tx_peak_bytes_)
+      this->stats_.tx_peak_bytes_ = buffer->size;
     buffers_.out_msg_index++;
   }
 }
@@ -1120,15 +1921,35 @@ size_t DlmsCosemComponent::receive_frame_(FrameStopFunction stop_fn) {
   const uint32_t read_time_limit_ms = 45;
   size_t ret_val;
 
-  auto count_available = this->available();
+  auto count_available = this->port_->available();
   if (count_available <= 0)
     return 0;
 
+  if (this->reply_wait_started_us_ != 0) {
+    // the request was still leaving the UART for a while after the wait started
+    uint32_t waited = micros() - this->reply_wait_started_us_;
+    uint32_t draining = BusUsage::byte_time_us(this->last_tx_bytes_, this->current_baud_rate_);
+    this->bus_usage_->turnaround_us += waited > draining ? waited - draining : 0;
+    this->reply_wait_started_us_ = 0;
+  }
+
   uint32_t read_start = millis();
   uint8_t *p;
 
   // ESP_LOGVV(TAG, "avail RX: %d", count_available);
-  buffers_.check_and_grow_input(count_available);
+  if ((size_t) count_available > this->buffers_.in_room()) {
+    if (this->buffers_.in_room() == 0) {
+      ESP_LOGW(TAG, "Reply does not fit the %u byte receive buffer, dropping it (see receive_buffer_size)",
+               (unsigned) this->buffers_.in.capacity);
+      this->stats_.rx_overflows_++;
+      this->trace_.add(SessionTrace::Event::ERROR, static_cast<uint8_t>(this->state_), this->buffers_.in.size,
+                       DLMS_ERROR_CODE_OUTOFMEMORY);
+      this->buffers_.in.size = 0;
+      this->buffers_.in.position = 0;
+      return 0;
+    }
+    count_available = this->buffers_.in_room();
+  }
 
   while (count_available-- > 0) {
     if (millis() - read_start > read_time_limit_ms) {
@@ -1136,10 +1957,11 @@ size_t DlmsCosemComponent::receive_frame_(FrameStopFunction stop_fn) {
     }
 
     p = &this->buffers_.in.data[this->buffers_.in.size];
-    if (!iuart_->read_one_byte(p)) {
+    if (!this->port_->read_byte(p)) {
       return 0;
     }
     this->buffers_.in.size++;
+    this->loop_state_.session.bytes_received++;
     // this->buffers_.amount_in++;
 
     if (stop_fn(this->buffers_.in.data, this->buffers_.in.size)) {
@@ -1148,6 +1970,10 @@ size_t DlmsCosemComponent::receive_frame_(FrameStopFunction stop_fn) {
       //      this->buffers_.in.size).c_str());
       ESP_LOGVV(TAG, "RX: %s", format_hex_pretty(this->buffers_.in.data, this->buffers_.in.size).c_str());
       ret_val = this->buffers_.in.size;
+      if (ret_val > this->stats_.rx_peak_bytes_)
+        this->stats_.rx_peak_bytes_ = ret_val;
+      this->loop_state_.session.frames_received++;
+      this->trace_.add_frame(SessionTrace::Event::RX, this->buffers_.in.data, ret_val);
 
       // this->buffers_.amount_in = 0;
       this->update_last_rx_time_();
@@ -1169,15 +1995,6 @@ size_t DlmsCosemComponent::receive_frame_hdlc_() {
   return receive_frame_(frame_end_check_hdlc);
 }
 
-#ifdef ENABLE_DLMS_COSEM_PUSH_MODE
-size_t DlmsCosemComponent::receive_frame_raw_() {
-  auto frame_end_check_timeout = [](uint8_t *b, size_t s) {
-    return false;  // never stop by content, only by timeout
-  };
-  return receive_frame_(frame_end_check_timeout);
-}
-#endif
-
 #ifdef IEC_HANDSHAKE
 size_t DlmsCosemComponent::receive_frame_ascii_() {
   // "data<CR><LF>"
@@ -1194,7 +2011,7 @@ size_t DlmsCosemComponent::receive_frame_ascii_() {
 #endif
 
 void DlmsCosemComponent::clear_rx_buffers_() {
-  int available = this->available();
+  int available = this->port_->available();
   if (available > 0) {
     ESP_LOGVV(TAG, "Cleaning garbage from UART input buffer: %d bytes", available);
   }
@@ -1202,10 +2019,9 @@ void DlmsCosemComponent::clear_rx_buffers_() {
   int len;
   while (available > 0) {
     len = std::min(available, (int) buffers_.in.capacity);
-    this->read_array(this->buffers_.in.data, len);
+    this->port_->read_array(this->buffers_.in.data, len);
     available -= len;
   }
-  memset(this->buffers_.in.data, 0, buffers_.in.capacity);
   this->buffers_.in.size = 0;
   this->buffers_.in.position = 0;
 }
@@ -1248,6 +2064,8 @@ const LogString *DlmsCosemComponent::state_to_string(State state) {
       return LOG_STR("SESSION_RELEASE");
     case State::DISCONNECT_REQ:
       return LOG_STR("DISCONNECT_REQ");
+    case State::SESSION_SCRIPT:
+      return LOG_STR("SESSION_SCRIPT");
     case State::PUBLISH:
       return LOG_STR("PUBLISH");
 #ifdef ENABLE_DLMS_COSEM_PUSH_MODE
@@ -1270,6 +2088,184 @@ void DlmsCosemComponent::log_state_(State *next_state) {
   }
 }
 
+void DlmsCosemComponent::session_stats_report_() {
+  const auto &s = this->loop_state_.session;
+  uint32_t elapsed = millis() - this->loop_state_.session_started_ms;
+
+  this->stats_.frames_sent_ += s.frames_sent;
+  this->stats_.frames_received_ += s.frames_received;
+  this->stats_.bytes_sent_ += s.bytes_sent;
+  this->stats_.bytes_received_ += s.bytes_received;
+  this->stats_.objects_read_ += s.objects;
+  this->stats_.objects_failed_ += s.objects_failed;
+  this->stats_.retries_ += s.retries;
+  this->stats_.last_session_ms_ = elapsed;
+
+  if (s.objects == 0)
+    return;
+  ESP_LOGD(TAG, "Session: %u ms, %u objects (%u failed), %u ms/object, %u retries", elapsed, s.objects,
+           s.objects_failed, elapsed / s.objects, s.retries);
+  ESP_LOGD(TAG, "Session: %u/%u frames, %u/%u bytes sent/received, %.1f frames and %u bytes per object",
+           s.frames_sent, s.frames_received, s.bytes_sent, s.bytes_received,
+           (float) (s.frames_sent + s.frames_received) / s.objects, (s.bytes_sent + s.bytes_received) / s.objects);
+}
+
+void DlmsCosemComponent::publish_diagnostics_() {
+#ifdef USE_SENSOR
+  auto *s = this->diagnostic_sensors_[static_cast<size_t>(DiagnosticSensorType::SESSION_TIME)];
+  if (s != nullptr)
+    s->publish_state(this->stats_.last_session_ms_);
+  s = this->diagnostic_sensors_[static_cast<size_t>(DiagnosticSensorType::LOOP_TIME_MAX)];
+  if (s != nullptr)
+    s->publish_state(this->loop_max_us_ / 1000.0f);
+  s = this->diagnostic_sensors_[static_cast<size_t>(DiagnosticSensorType::RX_BUFFER_PEAK)];
+  if (s != nullptr)
+    s->publish_state(this->is_push_mode() ? this->stats_.push_peak_bytes_ : this->stats_.rx_peak_bytes_);
+  s = this->diagnostic_sensors_[static_cast<size_t>(DiagnosticSensorType::TX_BUFFER_PEAK)];
+  if (s != nullptr)
+    s->publish_state(this->stats_.tx_peak_bytes_);
+#endif
+  this->loop_max_us_ = 0;
+  this->publish_bus_usage_();
+
+#ifdef USE_TEXT_SENSOR
+  if (this->object_stats_text_sensor_ == nullptr || this->is_push_mode())
+    return;
+  // slowest objects first, then any object with errors; fits a 255 char state
+  std::vector<const DlmsCosemSensorBase *> objs;
+  for (auto it = this->sensors_.begin(); it != this->sensors_.end(); it = this->sensors_.upper_bound(it->first)) {
+    if (it->second->telemetry().reads > 0)
+      objs.push_back(it->second);
+  }
+  std::sort(objs.begin(), objs.end(), [](const DlmsCosemSensorBase *a, const DlmsCosemSensorBase *b) {
+    return a->telemetry().ewma_rtt_ms > b->telemetry().ewma_rtt_ms;
+  });
+  std::string out;
+  char item[64];
+  for (size_t i = 0; i < objs.size(); i++) {
+    const auto &t = objs[i]->telemetry();
+    if (i >= 3 && t.error_count() == 0)
+      continue;
+    int n = snprintf(item, sizeof(item), "%s%s %ums err %u", out.empty() ? "" : "; ", objs[i]->get_obis_code().c_str(),
+                     (uint32_t) t.ewma_rtt_ms, t.error_count());
+    if (n < 0 || out.size() + n > 255)
+      break;
+    out += item;
+  }
+  this->object_stats_text_sensor_->publish_state(out);
+#endif
+}
+
+void DlmsCosemComponent::publish_bus_usage_() {
+  const auto &now = *this->bus_usage_;
+  const auto &was = this->bus_snapshot_;
+  const uint32_t now_ms = millis();
+  const float window_us = (now_ms - this->bus_snapshot_ms_) * 1000.0f;
+  if (window_us <= 0)
+    return;
+
+  auto percent = [window_us](uint64_t a, uint64_t b) { return std::min(100.0f, (a - b) * 100.0f / window_us); };
+  float held = percent(now.session_us, was.session_us);
+  uint32_t sessions = now.sessions - was.sessions;
+  float max_rate = NAN;
+  if (sessions > 0 && now.meters > 0) {
+    float avg_session_us = (float) (now.session_us - was.session_us) / sessions;
+    max_rate = 3600e6f / (avg_session_us * now.meters);
+  }
+
+  ESP_LOGV(TAG, "Bus held / tx / rx / turnaround ...... %.1f / %.1f / %.1f / %.1f %%", held,
+           percent(now.tx_us, was.tx_us), percent(now.rx_us, was.rx_us),
+           percent(now.turnaround_us, was.turnaround_us));
+  ESP_LOGV(TAG, "Bus contention / max polls per hour .. %.1f %% / %.0f", percent(now.contention_us, was.contention_us),
+           max_rate);
+
+#ifdef USE_SENSOR
+  auto publish = [this](DiagnosticSensorType type, float value) {
+    auto *s = this->diagnostic_sensors_[static_cast<size_t>(type)];
+    if (s != nullptr)
+      s->publish_state(value);
+  };
+  publish(DiagnosticSensorType::BUS_UTILIZATION, held);
+  publish(DiagnosticSensorType::BUS_IDLE, 100.0f - held);
+  publish(DiagnosticSensorType::BUS_TX, percent(now.tx_us, was.tx_us));
+  publish(DiagnosticSensorType::BUS_RX, percent(now.rx_us, was.rx_us));
+  publish(DiagnosticSensorType::BUS_TURNAROUND, percent(now.turnaround_us, was.turnaround_us));
+  publish(DiagnosticSensorType::BUS_CONTENTION, percent(now.contention_us, was.contention_us));
+  publish(DiagnosticSensorType::BUS_MAX_POLL_RATE, max_rate);
+#endif
+
+  this->bus_snapshot_ = now;
+  this->bus_snapshot_ms_ = now_ms;
+}
+
+const ObjectTelemetry *DlmsCosemComponent::get_object_telemetry(const std::string &obis) const {
+  uint8_t bytes[6];
+  if (!obis_parse(obis.c_str(), bytes))
+    return nullptr;
+  auto it = this->sensors_.find(obis_pack(bytes));
+  return it == this->sensors_.end() ? nullptr : &it->second->telemetry();
+}
+
+std::string DlmsCosemComponent::object_telemetry_json() const {
+  std::string out = "[";
+  char buf[192];
+  for (auto it = this->sensors_.begin(); it != this->sensors_.end(); it = this->sensors_.upper_bound(it->first)) {
+    const auto &t = it->second->telemetry();
+    snprintf(buf, sizeof(buf),
+             "%s{\"obis\":\"%s\",\"reads\":%u,\"rtt\":%u,\"ewma\":%.1f,\"max\":%u,"
+             "\"frame_errors\":%u,\"retries\":%u,\"errors\":{",
+             out.size() > 1 ? "," : "", it->second->get_obis_code().c_str(), t.reads, t.last_rtt_ms, t.ewma_rtt_ms, t.max_rtt_ms,
+             t.frame_errors, t.retries);
+    out += buf;
+    bool first = true;
+    for (const auto &e : t.errors) {
+      if (e.count == 0)
+        continue;
+      snprintf(buf, sizeof(buf), "%s\"%d\":%u", first ? "" : ",", e.code, e.count);
+      out += buf;
+      first = false;
+    }
+    if (t.other_errors > 0) {
+      snprintf(buf, sizeof(buf), "%s\"other\":%u", first ? "" : ",", t.other_errors);
+      out += buf;
+    }
+    out += "}}";
+  }
+  out += "]";
+  return out;
+}
+
+void DlmsCosemComponent::telemetry_dump() {
+  ESP_LOGV(TAG, "Objects: reads, last / avg / max RTT ms, frame errors, retries, errors");
+  for (auto it = this->sensors_.begin(); it != this->sensors_.end(); it = this->sensors_.upper_bound(it->first)) {
+    const auto &t = it->second->telemetry();
+    if (t.reads == 0)
+      continue;
+    ESP_LOGV(TAG, "  %-18s %u, %u / %u / %u, %u, %u, %u", it->second->get_obis_code().c_str(), t.reads,
+             t.last_rtt_ms, (uint32_t) t.ewma_rtt_ms, t.max_rtt_ms, t.frame_errors, t.retries, t.error_count());
+    for (const auto &e : t.errors) {
+      if (e.count > 0)
+        ESP_LOGV(TAG, "    error %d %s: %u", e.code, dlms_error_to_string(e.code), e.count);
+    }
+  }
+}
+
+void DlmsCosemComponent::timing_dump() {
+  char hist[64];
+  ESP_LOGV(TAG, "Time per state: count, avg / max us, <8us/<64us/<512us/<4ms/<33ms/<262ms/<2s/more");
+  for (size_t i = 0; i < STATE_COUNT; i++) {
+    const auto &h = this->state_timing_[i];
+    if (h.count == 0)
+      continue;
+    ESP_LOGV(TAG, "  %-18s %u, %u / %u, %s", LOG_STR_ARG(state_to_string(static_cast<State>(i))), h.count,
+             h.avg_us(), h.max_us, h.format_buckets(hist, sizeof(hist)));
+  }
+  const auto &l = this->loop_timing_;
+  ESP_LOGV(TAG, "  %-18s %u, %u / %u, %s", "loop()", l.count, l.avg_us(), l.max_us,
+           l.format_buckets(hist, sizeof(hist)));
+  ESP_LOGV(TAG, "Loops over %u ms ..................... %u", SLOW_LOOP_US / 1000, this->slow_loops_);
+}
+
 void DlmsCosemComponent::stats_dump() {
   ESP_LOGV(TAG, "============================================");
   ESP_LOGV(TAG, "Data collection and publishing finished.");
@@ -1279,21 +2275,71 @@ void DlmsCosemComponent::stats_dump() {
   ESP_LOGV(TAG, "Total number of CRC errors recovered . %u", this->stats_.crc_errors_recovered_);
   ESP_LOGV(TAG, "CRC errors per session ............... %f", this->stats_.crc_errors_per_session());
   ESP_LOGV(TAG, "Number of failures ................... %u", this->stats_.failures_);
+  if (!this->is_push_mode()) {
+    ESP_LOGV(TAG, "Objects read / failed ................ %u / %u", this->stats_.objects_read_,
+             this->stats_.objects_failed_);
+    ESP_LOGV(TAG, "Requests sent again .................. %u", this->stats_.retries_);
+    ESP_LOGV(TAG, "Frames sent / received ............... %u / %u", this->stats_.frames_sent_,
+             this->stats_.frames_received_);
+    ESP_LOGV(TAG, "Bytes sent / received ................ %u / %u", this->stats_.bytes_sent_,
+             this->stats_.bytes_received_);
+    ESP_LOGV(TAG, "Last session time .................... %u ms", this->stats_.last_session_ms_);
+    ESP_LOGV(TAG, "Largest frame sent / received ........ %u / %u of %u bytes", this->stats_.tx_peak_bytes_,
+             this->stats_.rx_peak_bytes_, (unsigned) this->buffers_.in.capacity);
+    ESP_LOGV(TAG, "Replies over receive buffer .......... %u", this->stats_.rx_overflows_);
+    if (this->has_fast_poll_()) {
+      ESP_LOGV(TAG, "Fast poll bursts / sessions / capped . %u / %u / %u", this->stats_.fast_poll_bursts_,
+               this->stats_.fast_poll_sessions_, this->stats_.fast_poll_capped_);
+    }
+  }
+#ifdef ENABLE_DLMS_COSEM_PUSH_MODE
+  if (this->is_push_mode()) {
+    auto &ps = this->push_assembler_.stats();
+    ESP_LOGV(TAG, "Push telegrams received .............. %u", this->stats_.push_telegrams_);
+    ESP_LOGV(TAG, "Push telegrams dropped (busy) ........ %u", this->stats_.push_dropped_);
+    ESP_LOGV(TAG, "Push telegrams overflowed ............ %u", this->stats_.push_overflows_);
+    ESP_LOGV(TAG, "Push telegrams assembled ............. %u", ps.telegrams);
+    ESP_LOGV(TAG, "Push telegrams dropped ............... %u", ps.telegrams_dropped);
+    ESP_LOGV(TAG, "HDLC frames / HCS / FCS errors ....... %u / %u / %u", ps.frames, ps.hcs_errors, ps.fcs_errors);
+    ESP_LOGV(TAG, "HDLC segment sequence errors ......... %u", ps.sequence_errors);
+    ESP_LOGV(TAG, "Block transfer blocks / errors ....... %u / %u", ps.blocks, ps.block_errors);
+    ESP_LOGV(TAG, "Decrypted APDUs / errors ............. %u / %u", ps.decrypted, ps.decrypt_errors);
+    ESP_LOGV(TAG, "Largest push reception ............... %u bytes", this->stats_.push_peak_bytes_);
+    if (this->axdr_parser_ != nullptr) {
+      auto &as = this->axdr_parser_->stats();
+      ESP_LOGV(TAG, "AXDR frames / objects / bytes ........ %u / %u / %u", as.frames, as.objects, as.bytes);
+      ESP_LOGV(TAG, "AXDR time total / slowest frame ...... %u / %u us", as.total_us, as.max_us);
+      if (as.objects > 0)
+        ESP_LOGV(TAG, "AXDR time per object ................. %u ns", (uint32_t) (1000ull * as.total_us / as.objects));
+      if (as.elements > 0)
+        ESP_LOGV(TAG, "AXDR pattern attempts per element .... %.1f", (float) as.pattern_attempts / as.elements);
+      ESP_LOGV(TAG, "AXDR max nesting depth ............... %u", as.max_depth);
+      ESP_LOGV(TAG, "AXDR frames over parse budget ........ %u", as.budget_aborts);
+    }
+  }
+#endif
   ESP_LOGV(TAG, "============================================");
 }
 
 bool DlmsCosemComponent::try_lock_uart_session_() {
-  if (AnyObjectLocker::try_lock(this->parent_)) {
-    ESP_LOGV(TAG, "UART bus %p locked by %s", this->parent_, this->tag_.c_str());
+  const void *bus = this->port_->bus_id();
+  if (AnyObjectLocker::try_lock(bus)) {
+    ESP_LOGV(TAG, "UART bus %p locked by %s", bus, this->tag_.c_str());
     return true;
   }
-  ESP_LOGV(TAG, "UART bus %p busy", this->parent_);
+  ESP_LOGV(TAG, "UART bus %p busy", bus);
   return false;
 }
 
 void DlmsCosemComponent::unlock_uart_session_() {
-  AnyObjectLocker::unlock(this->parent_);
-  ESP_LOGV(TAG, "UART bus %p released by %s", this->parent_, this->tag_.c_str());
+  auto *bus = this->bus_usage_;
+  bus->session_us += micros() - this->bus_locked_us_;
+  bus->sessions++;
+  bus->tx_us += BusUsage::byte_time_us(this->loop_state_.session.bytes_sent, this->current_baud_rate_);
+  bus->rx_us += BusUsage::byte_time_us(this->loop_state_.session.bytes_received, this->current_baud_rate_);
+  this->reply_wait_started_us_ = 0;
+  AnyObjectLocker::unlock(this->port_->bus_id());
+  ESP_LOGV(TAG, "UART bus %p released by %s", this->port_->bus_id(), this->tag_.c_str());
 }
 
 uint8_t DlmsCosemComponent::next_obj_id_ = 0;
@@ -1,8 +1,11 @@
 #pragma once
 
-#include "esphome/components/uart/uart.h"
 #include "esphome/core/component.h"
 
+#if defined(USE_ESP32) || defined(USE_ESP8266)
+#include "esphome/components/uart/uart.h"
+#endif
+
 #ifdef USE_SENSOR
 #include "esphome/components/sensor/sensor.h"
 #endif
@@ -12,14 +15,22 @@
 #endif
 
 #include <cstdint>
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
 #include <string>
 
+#include "bus_usage.h"
 #include "dlms_cosem_sensor.h"
-#include "dlms_cosem_uart.h"
+#include "dlms_cosem_port.h"
+#include "dlms_cosem_timing.h"
+#include "obis_index.h"
+#include "port_capture.h"
 #include "object_locker.h"
+#include "push_assembler.h"
+#include "session_coro.h"
+#include "session_trace.h"
 
 //##include "gxignore-arduino.h"
 
@@ -37,19 +48,50 @@ static const size_t DEFAULT_IN_BUF_SIZE = 256;
 static const size_t DEFAULT_IN_BUF_SIZE_PUSH = 2048;
 static const size_t MAX_OUT_BUF_SIZE = 128;
 
-using SensorMap = std::multimap<std::string, DlmsCosemSensorBase *>;
-
-using FrameStopFunction = std::function<bool(uint8_t *buf, size_t size)>;
-using ReadFunction = std::function<size_t()>;
-
-using DlmsRequestMaker = std::function<int()>;
-using DlmsResponseParser = std::function<int()>;
+// keyed by the packed OBIS code, see obis_pack()
+using SensorMap = std::multimap<uint64_t, DlmsCosemSensorBase *>;
+
+using FrameStopFunction = bool (*)(uint8_t *buf, size_t size);
+
+// What the session engine sends next; make_request_() builds it, parse_reply_() handles the reply.
+// A plain tag instead of callables keeps the per-request path free of heap operations.
+enum class DlmsRequest : uint8_t {
+  NONE,
+  SNRM,
+  AARQ,
+  READ_REGISTER,  // buffers_.gx_register, attribute buffers_.gx_attribute
+  READ_CLOCK,     // buffers_.gx_clock, attribute buffers_.gx_attribute
+  RELEASE,
+  DISCONNECT,
+};
 
 #ifdef ENABLE_DLMS_COSEM_PUSH_MODE
 class AxdrStreamParser;
 #endif
 
+enum class DiagnosticSensorType : uint8_t {
+  SESSION_TIME,   // ms, last session (pull) or last telegram processing (push)
+  LOOP_TIME_MAX,  // ms, longest loop() since previous publication
+  // UART bus shared with other meters, % of the time since previous publication
+  BUS_UTILIZATION,  // held by any meter's session
+  BUS_IDLE,
+  BUS_TX,
+  BUS_RX,
+  BUS_TURNAROUND,     // waiting for replies
+  BUS_CONTENTION,     // this meter waiting for the bus
+  BUS_MAX_POLL_RATE,  // polls per hour each meter could get at the recent average session time
+  // bytes, since boot
+  RX_BUFFER_PEAK,  // most of the receive buffer a reply or push telegram has used
+  TX_BUFFER_PEAK,  // largest request frame
+  COUNT,
+};
+
+#if defined(USE_ESP32) || defined(USE_ESP8266)
 class DlmsCosemComponent : public PollingComponent, public uart::UARTDevice {
+#else
+// no ESPHome UART off-device, the meter is reached through set_port()/set_host_serial_port()
+class DlmsCosemComponent : public PollingComponent {
+#endif
  public:
   DlmsCosemComponent() : tag_(generateTag()){};
 
@@ -76,8 +118,37 @@ class DlmsCosemComponent : public PollingComponent, public uart::UARTDevice {
   void set_receive_timeout_ms(uint32_t timeout) { this->receive_timeout_ms_ = timeout; };
   void set_delay_between_requests_ms(uint32_t delay) { this->delay_between_requests_ms_ = delay; };
   void set_flow_control_pin(GPIOPin *flow_control_pin) { this->flow_control_pin_ = flow_control_pin; };
+  // replaces the UART as byte stream to the meter, must be called before setup()
+  void set_port(std::unique_ptr<DlmsCosemPort> port) { this->port_ = std::move(port); }
+#ifdef USE_HOST
+  void set_host_serial_port(const std::string &path);
+#endif
 
   void register_sensor(DlmsCosemSensorBase *sensor);
+#ifdef USE_SENSOR
+  void set_diagnostic_sensor(DiagnosticSensorType type, sensor::Sensor *sensor) {
+    this->diagnostic_sensors_[static_cast<size_t>(type)] = sensor;
+  }
+#endif
+
+  // records kept in the session trace ring, 0 disables it
+  void set_trace_size(uint16_t records) { this->trace_size_ = records; }
+  // prints the session trace as hex records, see SessionTrace
+  void trace_dump() const;
+  // bytes for recording the raw traffic of the last session, 0 disables it
+  void set_capture_size(uint16_t bytes) { this->capture_size_ = bytes; }
+  // Fast polling bursts started by sensor triggers: a short session every interval, as long as
+  // sessions (of all meters on the bus) have held it for less than the given share of the burst
+  void set_fast_poll(uint32_t interval_ms, float max_bus_utilization) {
+    this->fast_poll_interval_ms_ = interval_ms;
+    this->fast_poll_max_utilization_ = max_bus_utilization;
+  }
+  // time loop() may keep advancing the session before yielding, 0 for one state per call
+  void set_loop_budget(uint32_t us) { this->loop_budget_us_ = us; }
+  // receive buffer, fixed at setup; 0 picks the mode's default
+  void set_receive_buffer_size(uint16_t bytes) { this->rx_buffer_size_ = bytes; }
+  // prints the recorded traffic as hex, see CapturePort
+  void capture_dump() const;
 
   void set_reboot_after_failure(uint16_t number_of_failures) { this->failures_before_reboot_ = number_of_failures; }
   void set_cp1251_conversion_required(bool required) { this->cp1251_conversion_required_ = required; }
@@ -86,6 +157,13 @@ class DlmsCosemComponent : public PollingComponent, public uart::UARTDevice {
   void set_push_mode(bool push_mode) { this->operation_mode_push_ = push_mode; }
   void set_push_show_log(bool show_log) { this->push_show_log_ = show_log; }
   void set_push_custom_pattern_dsl(const std::string &dsl) { this->push_custom_pattern_dsl_ = dsl; }
+  void set_push_parse_budget(uint8_t max_depth, uint16_t max_elements, uint32_t max_time_ms) {
+    this->push_max_depth_ = max_depth;
+    this->push_max_elements_ = max_elements;
+    this->push_max_parse_time_ms_ = max_time_ms;
+  }
+  void set_decryption_key(const std::string &hex_key);
+  void set_authentication_key(const std::string &hex_key);
 #endif
 
   bool has_error{true};
@@ -98,8 +176,23 @@ class DlmsCosemComponent : public PollingComponent, public uart::UARTDevice {
 
 #ifdef USE_TEXT_SENSOR
   SUB_TEXT_SENSOR(last_scan)
+  SUB_TEXT_SENSOR(object_stats)
 #endif
 
+  // error is a DLMS_ERROR_CODE; value is the raw attribute (no scaler) or NAN if it is not a number,
+  // text the attribute as a text sensor would show it (as the library prints it for structures and arrays).
+  using ReadNowCallback = std::function<void(int error, double value, const char *text)>;
+  // Reads one attribute of a Data, Register or Clock object (pull mode): next in a running session,
+  // or in a short session of its own when idle. Sensors with the same OBIS code and class are updated
+  // and published as well. False if the request is invalid or the queue is full.
+  bool read_now(const char *obis, uint16_t class_id = DLMS_OBJECT_TYPE_REGISTER, uint8_t attribute = 2,
+                ReadNowCallback callback = nullptr);
+
+  // Request statistics of the object behind an OBIS code (pull mode), nullptr if not polled
+  const ObjectTelemetry *get_object_telemetry(const std::string &obis) const;
+  // [{"obis":..,"reads":..,"rtt":..,"ewma":..,"max":..,"frame_errors":..,"retries":..,"errors":{"<code>":<count>,..}},..]
+  std::string object_telemetry_json() const;
+
  protected:
   uint16_t client_address_{16};
   uint16_t server_address_{1};
@@ -110,6 +203,9 @@ class DlmsCosemComponent : public PollingComponent, public uart::UARTDevice {
 #ifdef ENABLE_DLMS_COSEM_PUSH_MODE
   bool push_show_log_{false};
   std::string push_custom_pattern_dsl_{""};
+  uint8_t push_max_depth_{16};
+  uint16_t push_max_elements_{1000};
+  uint32_t push_max_parse_time_ms_{30};
 #endif
 
   uint32_t receive_timeout_ms_{500};
@@ -117,11 +213,14 @@ class DlmsCosemComponent : public PollingComponent, public uart::UARTDevice {
   bool cp1251_conversion_required_{true};
 
   GPIOPin *flow_control_pin_{nullptr};
-  std::unique_ptr<DlmsCosemUart> iuart_;
+  std::unique_ptr<DlmsCosemPort> port_;
 
   SensorMap sensors_;
 
   sensor::Sensor *crc_errors_per_session_sensor_{};
+#ifdef USE_SENSOR
+  sensor::Sensor *diagnostic_sensors_[static_cast<size_t>(DiagnosticSensorType::COUNT)]{};
+#endif
 
   enum class State : uint8_t {
     NOT_INITIALIZED,
@@ -146,6 +245,7 @@ class DlmsCosemComponent : public PollingComponent, public uart::UARTDevice {
     DATA_NEXT,
     SESSION_RELEASE,
     DISCONNECT_REQ,
+    SESSION_SCRIPT,  // coroutine session (ENABLE_DLMS_COSEM_COROUTINES) between requests
 #ifdef ENABLE_DLMS_COSEM_PUSH_MODE
     PUSH_DATA_PROCESS,  // Process received push data
 #endif
@@ -153,6 +253,45 @@ class DlmsCosemComponent : public PollingComponent, public uart::UARTDevice {
   } state_{State::NOT_INITIALIZED};
   State last_reported_state_{State::NOT_INITIALIZED};
 
+  // time spent in each state (entry to exit) and in each busy loop()
+  static constexpr size_t STATE_COUNT = static_cast<size_t>(State::PUBLISH) + 1;
+  static constexpr uint32_t SLOW_LOOP_US = 30000;  // ESPHome warns about components blocking longer
+  DurationHistogram state_timing_[STATE_COUNT];
+  DurationHistogram loop_timing_;
+  uint32_t loop_budget_us_{10000};
+  HighFrequencyLoopRequester high_freq_;
+  bool high_freq_active_{false};
+  uint32_t state_entered_us_{0};
+  uint32_t loop_max_us_{0};  // since last diagnostics publication
+  uint32_t slow_loops_{0};
+
+  SessionTrace trace_;
+  uint16_t trace_size_{64};
+  CapturePort *capture_{nullptr};  // wraps port_ when enabled
+  uint16_t capture_size_{0};
+
+  // Receive buffers (buffers_.in and, in push mode, push_rx_.buf) are carved from one
+  // allocation made at setup and never resized; a reply that does not fit is dropped and counted.
+  std::unique_ptr<uint8_t[]> arena_;
+  size_t arena_size_{0};
+  uint16_t rx_buffer_size_{0};
+
+  uint32_t current_baud_rate_{0};
+  BusUsage *bus_usage_{nullptr};
+  BusUsage bus_usage_own_{};  // when there are more buses than BusUsage can track
+  BusUsage bus_snapshot_{};   // counters at the previous publication
+  uint32_t bus_snapshot_ms_{0};
+  uint32_t reply_wait_started_us_{0};  // 0: not waiting for a reply
+  uint32_t last_tx_bytes_{0};          // size of the last request, still draining when the wait starts
+  uint32_t lock_wait_started_ms_{0};
+  bool lock_waiting_{false};  // another meter holds the bus since lock_wait_started_ms_
+  uint32_t bus_locked_us_{0};
+  void publish_bus_usage_();
+  void step_();  // handles the current state once
+  void account_state_change_(State state_before);
+  void account_loop_time_(State state_before, uint32_t loop_start_us);
+  void publish_diagnostics_();
+
   struct {
     uint32_t start_time{0};
     uint32_t delay_ms{0};
@@ -169,16 +308,20 @@ class DlmsCosemComponent : public PollingComponent, public uart::UARTDevice {
   void prepare_and_send_dlms_buffers();
   void prepare_and_send_dlms_aarq();
   void prepare_and_send_dlms_auth();
-  void prepare_and_send_dlms_data_unit_request(const char *obis, int type);
-  void prepare_and_send_dlms_data_request(const char *obis, int type, bool reg_init = true);
+  void prepare_and_send_dlms_data_unit_request();
+  void prepare_and_send_dlms_data_request(bool reg_init = true);
   void prepare_and_send_dlms_release();
   void prepare_and_send_dlms_disconnect();
 
 #ifdef ENABLE_DLMS_COSEM_PUSH_MODE
   void process_push_data();
 #endif
-  void send_dlms_req_and_next(DlmsRequestMaker maker, DlmsResponseParser parser, State next_state,
-                              bool mission_critical = false, bool clear_buffer = true);
+  void send_dlms_req_and_next(DlmsRequest request, State next_state, bool mission_critical = false,
+                              bool clear_buffer = true);
+  int make_request_(DlmsRequest request);
+  int parse_reply_(DlmsRequest request);
+  bool retry_request_();
+  int parse_get_response_(DlmsRequest request);
 
   // State handler methods extracted from loop()
   void handle_comms_rx_();
@@ -191,6 +334,7 @@ class DlmsCosemComponent : public PollingComponent, public uart::UARTDevice {
   void handle_data_enq_();
   void handle_data_recv_();
   void handle_data_next_();
+  bool select_next_request_();
   void handle_session_release_();
   void handle_disconnect_req_();
 #ifdef ENABLE_DLMS_COSEM_PUSH_MODE
@@ -198,8 +342,31 @@ class DlmsCosemComponent : public PollingComponent, public uart::UARTDevice {
 #endif
   void handle_publish_();
 
+  // One object of the session, loop_state_.request or the read_now one. Both session engines read it
+  // with these steps: begin, the scaler and unit request if needed, the value request, done.
+  void begin_object_();
+  bool object_needs_units_() const;
+  int prepare_object_request_(bool units, bool reg_init, DlmsRequest *request);
+  void object_done_();
+  void object_read_(DlmsCosemSensorBase *sens);
+  void start_publish_();
+
+#ifdef ENABLE_DLMS_COSEM_COROUTINES
+  // The session as one coroutine instead of the OPEN_SESSION..DISCONNECT_REQ states. Requests still
+  // go through COMMS_TX/COMMS_RX, which come back to SESSION_SCRIPT to resume it.
+  struct ScriptRequest;
+  struct ScriptDelay;
+  CoroutineFramePool coroutine_frames_;
+  SessionTask script_;
+  SessionTask session_script_();
+  ScriptRequest request_(DlmsRequest request, bool mission_critical = false);
+  ScriptDelay delay_(uint32_t ms);
+  void handle_session_script_();
+#endif
+
   int set_sensor_scale_and_unit(DlmsCosemSensor *sensor);
   int set_sensor_value(DlmsCosemSensorBase *sensor, const char *obis);
+  void set_sensor_value_from_get_result_(DlmsCosemSensorBase *sensor, const char *obis);
 
 #ifdef ENABLE_DLMS_COSEM_PUSH_MODE
   int set_sensor_value(uint16_t class_id, const uint8_t *obis_code, DLMS_DATA_TYPE value_type,
@@ -213,10 +380,26 @@ class DlmsCosemComponent : public PollingComponent, public uart::UARTDevice {
   bool is_push_mode() const { return this->operation_mode_push_; }
 #ifdef ENABLE_DLMS_COSEM_PUSH_MODE
   AxdrStreamParser *axdr_parser_{nullptr};
+  ObisIndex push_index_;  // raw OBIS -> sensors, built at setup
+  PushFrameAssembler push_assembler_;
+  DlmsCipher push_cipher_;
+
+  // Push input is double-buffered: the UART is drained into push_rx_.buf in every loop(),
+  // while a complete telegram is parsed and published from buffers_.in; the two are swapped
+  // when the parser is idle.
+  struct {
+    gxByteBuffer buf;
+    uint32_t started_ms{0};  // first byte of the telegram
+    uint32_t last_rx_ms{0};
+    bool receiving{false};
+    bool overflow{false};
+    bool ready{false};  // complete telegram waiting for the parser
+  } push_rx_;
+  void push_receive_();
+  void build_push_index_();
 #endif  // ENABLE_DLMS_COSEM_PUSH_MODE
 
   struct {
-    ReadFunction read_fn;
     State next_state;
     bool mission_critical;
     bool check_crc;
@@ -224,27 +407,73 @@ class DlmsCosemComponent : public PollingComponent, public uart::UARTDevice {
     uint8_t tries_counter;
     uint32_t err_crc;
     uint32_t err_invalid_frames;
-  } reading_state_{nullptr, State::IDLE, false, false, 0, 0, 0, 0};
+  } reading_state_{State::IDLE, false, false, 0, 0, 0, 0};
   size_t received_frame_size_{0};
   bool received_complete_reply_{false};
 
   struct {
-    DlmsRequestMaker maker_fn;
-    DlmsResponseParser parser_fn;
+    DlmsRequest request;
     State next_state;
     bool mission_critical;
     bool reply_is_complete;
     int last_error;
-  } dlms_reading_state_{nullptr, nullptr, State::IDLE, false, false, DLMS_ERROR_CODE_OK};
+  } dlms_reading_state_{DlmsRequest::NONE, State::IDLE, false, false, DLMS_ERROR_CODE_OK};
 
   uint32_t baud_rate_handshake_{9600};
   uint32_t baud_rate_{9600};
 
   uint32_t last_rx_time_{0};
 
+  // Sessions other than SCHEDULED read a subset of objects and publish them as they come
+  enum class SessionKind : uint8_t {
+    SCHEDULED,  // update(): every object
+    READ_NOW,   // only the read_now() queue
+    FAST_POLL,  // objects in fast polling
+  } session_kind_{SessionKind::SCHEDULED};
+  bool update_pending_{false};  // update() came during a READ_NOW/FAST_POLL session
+  void start_session_(SessionKind kind);
+
+  uint32_t fast_poll_interval_ms_{5000};
+  float fast_poll_max_utilization_{0.5f};
+  uint32_t fast_poll_until_ms_{0};  // 0: no burst
+  uint32_t fast_poll_started_ms_{0};
+  uint32_t fast_poll_last_ms_{0};   // last fast poll session
+  uint64_t fast_poll_bus_us_{0};    // bus session time at burst start
+  void trigger_fast_poll_(const FastPollTrigger &trigger, uint32_t now);
+  bool fast_poll_due_(uint32_t now);
+  bool has_fast_poll_() const;  // some sensor has a fast_poll trigger
+
+  struct ReadNowRequest {
+    uint8_t obis[6]{};
+    uint16_t class_id{0};
+    uint8_t attribute{2};
+    ReadNowCallback callback;
+  };
+  // On-demand reads waiting for the session; they go ahead of the scheduled objects
+  static constexpr uint8_t READ_NOW_QUEUE_SIZE = 4;
+  ReadNowRequest read_now_queue_[READ_NOW_QUEUE_SIZE];
+  uint8_t read_now_head_{0};
+  uint8_t read_now_count_{0};
+  void finish_read_now_();
+  void fail_read_now_(int error);
+
   struct LoopState {
     uint32_t session_started_ms{0};             // start of session
+    uint32_t object_started_ms{0};              // first request for the current object
+    uint8_t object_retries{0};                  // requests for the current object sent again
+    struct {
+      uint32_t frames_sent{0};
+      uint32_t frames_received{0};
+      uint32_t bytes_sent{0};
+      uint32_t bytes_received{0};
+      uint16_t objects{0};
+      uint16_t objects_failed{0};
+      uint16_t retries{0};
+    } session;                                  // traffic of the current session
     SensorMap::iterator request_iter{nullptr};  // talking to meter
+    DlmsCosemSensorBase *request{nullptr};      // object being read
+    ReadNowRequest read_now;                    // object being read when read_now_active
+    bool read_now_active{false};
     SensorMap::iterator sensor_iter{nullptr};   // publishing sensor values
 
   } loop_state_;
@@ -258,9 +487,9 @@ class DlmsCosemComponent : public PollingComponent, public uart::UARTDevice {
 
     gxReplyData reply;
 
-    void init(size_t default_in_buf_size);
+    void init(uint8_t *in_data, size_t in_size);
     void reset();
-    void check_and_grow_input(uint16_t more_data);
+    size_t in_room() const { return in.capacity - in.size; }
     // next function shows whether there are still messages to send
     bool has_more_messages_to_send() const { return out_msg_index < out_msg.size; }
 
@@ -268,6 +497,10 @@ class DlmsCosemComponent : public PollingComponent, public uart::UARTDevice {
     gxClock gx_clock;
     unsigned char gx_attribute{2};
 
+    // reply decoded in place by parse_get_response_(), gx_register/gx_clock are not filled then
+    DlmsGetResult get_result;
+    bool get_result_valid{false};
+
   } buffers_;
 
  protected:
@@ -284,8 +517,6 @@ class DlmsCosemComponent : public PollingComponent, public uart::UARTDevice {
   size_t receive_frame_ascii_();
   size_t receive_frame_hdlc_();
 
-  size_t receive_frame_raw_();
-  uint32_t time_raw_limit_{0};
 
   inline void update_last_rx_time_() { this->last_rx_time_ = millis(); }
   bool check_wait_timeout_() { return millis() - wait_.start_time >= wait_.delay_ms; }
@@ -306,10 +537,31 @@ class DlmsCosemComponent : public PollingComponent, public uart::UARTDevice {
     uint32_t crc_errors_recovered_{0};
     uint32_t invalid_frames_{0};
     uint8_t failures_{0};
+    uint32_t push_telegrams_{0};
+    uint32_t push_dropped_{0};
+    uint32_t push_overflows_{0};
+    uint32_t push_peak_bytes_{0};
+    uint32_t rx_peak_bytes_{0};
+    uint32_t tx_peak_bytes_{0};
+    uint32_t rx_overflows_{0};
+    uint32_t frames_sent_{0};
+    uint32_t frames_received_{0};
+    uint32_t bytes_sent_{0};
+    uint32_t bytes_received_{0};
+    uint32_t objects_read_{0};
+    uint32_t objects_failed_{0};
+    uint32_t retries_{0};
+    uint32_t last_session_ms_{0};
+    uint32_t fast_poll_bursts_{0};
+    uint32_t fast_poll_sessions_{0};
+    uint32_t fast_poll_capped_{0};  // sessions not started because of the bus utilization cap
 
     float crc_errors_per_session() const { return (float) crc_errors_ / connections_tried_; }
   } stats_;
   void stats_dump();
+  void timing_dump();
+  void telemetry_dump();
+  void session_stats_report_();
 
   uint8_t failures_before_reboot_{0};
 
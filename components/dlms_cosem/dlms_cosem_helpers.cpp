@@ -1,7 +1,6 @@
 #include "dlms_cosem_helpers.h"
+#include <cstdio>
 #include <cstring>
-#include <sstream>
-#include <iomanip>
 
 namespace esphome {
 namespace dlms_cosem {
@@ -69,12 +68,9 @@ float dlms_data_as_float(DLMS_DATA_TYPE value_type, const uint8_t *value_buffer_
       return 0.0f;
     case DLMS_DATA_TYPE_FLOAT64:
       if (value_length >= 8) {
-        uint8_t b[8];
-        for (int i = 0; i < 8; i++)
-          b[i] = value_buffer_ptr[i];
-
+        uint64_t u = be64(value_buffer_ptr);
         double d{};
-        std::memcpy(&d, b, sizeof(d));
+        std::memcpy(&d, &u, sizeof(d));
         return static_cast<float>(d);
       }
       return 0.0f;
@@ -83,211 +79,441 @@ float dlms_data_as_float(DLMS_DATA_TYPE value_type, const uint8_t *value_buffer_
   }
 }
 
-std::string dlms_datetime_as_string(const uint8_t *value_buffer_ptr, uint8_t value_length) {
-  if (value_buffer_ptr == nullptr || value_length < 12) {
-    return std::string();
+// 1e0..1e22 are exact in a double
+static const double POW10_EXACT[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+static constexpr int POW10_EXACT_MAX = sizeof(POW10_EXACT) / sizeof(POW10_EXACT[0]) - 1;
+
+double dlms_pow10(int exp) {
+  double r = 1.0;
+  int e = exp < 0 ? -exp : exp;
+  while (e > POW10_EXACT_MAX) {
+    r *= POW10_EXACT[POW10_EXACT_MAX];
+    e -= POW10_EXACT_MAX;
   }
+  r *= POW10_EXACT[e];
+  return exp < 0 ? 1.0 / r : r;
+}
 
-  const uint8_t *buf = value_buffer_ptr;
+double DlmsNumber::to_double() const {
+  if (this->is_real)
+    return this->real;
+  if (this->exponent == 0)
+    return (double) this->mantissa;
+  // dividing by an exact power keeps e.g. 12345 * 10^-2 at the double closest to 123.45
+  int e = this->exponent < 0 ? -this->exponent : this->exponent;
+  if (e <= POW10_EXACT_MAX) {
+    return this->exponent < 0 ? (double) this->mantissa / POW10_EXACT[e]
+                              : (double) this->mantissa * POW10_EXACT[e];
+  }
+  return (double) this->mantissa * dlms_pow10(this->exponent);
+}
 
-  // Year (2 bytes, big-endian)
-  uint16_t year = (buf[0] << 8) | buf[1];
+bool dlms_data_as_number(DLMS_DATA_TYPE value_type, const uint8_t *value_buffer_ptr, uint8_t value_length,
+                         DlmsNumber *out) {
+  *out = DlmsNumber{};
+  if (value_buffer_ptr == nullptr || value_length == 0)
+    return false;
 
-  // Month (1 byte)
-  uint8_t month = buf[2];
+  auto be = [](const uint8_t *p, uint8_t n) -> uint64_t {
+    uint64_t v = 0;
+    for (uint8_t i = 0; i < n; i++)
+      v = (v << 8) | p[i];
+    return v;
+  };
 
-  // Day of month (1 byte)
-  uint8_t day = buf[3];
+  switch (value_type) {
+    case DLMS_DATA_TYPE_BOOLEAN:
+    case DLMS_DATA_TYPE_ENUM:
+    case DLMS_DATA_TYPE_UINT8:
+      out->mantissa = value_buffer_ptr[0];
+      return true;
+    case DLMS_DATA_TYPE_INT8:
+      out->mantissa = (int8_t) value_buffer_ptr[0];
+      return true;
+    case DLMS_DATA_TYPE_UINT16:
+    case DLMS_DATA_TYPE_INT16:
+      if (value_length < 2)
+        return false;
+      out->mantissa = value_type == DLMS_DATA_TYPE_INT16 ? (int64_t) (int16_t) be(value_buffer_ptr, 2)
+                                                         : (int64_t) be(value_buffer_ptr, 2);
+      return true;
+    case DLMS_DATA_TYPE_UINT32:
+    case DLMS_DATA_TYPE_INT32:
+      if (value_length < 4)
+        return false;
+      out->mantissa = value_type == DLMS_DATA_TYPE_INT32 ? (int64_t) (int32_t) be(value_buffer_ptr, 4)
+                                                         : (int64_t) be(value_buffer_ptr, 4);
+      return true;
+    case DLMS_DATA_TYPE_INT64:
+      if (value_length < 8)
+        return false;
+      out->mantissa = (int64_t) be(value_buffer_ptr, 8);
+      return true;
+    case DLMS_DATA_TYPE_UINT64: {
+      if (value_length < 8)
+        return false;
+      uint64_t v = be(value_buffer_ptr, 8);
+      if (v > (uint64_t) INT64_MAX) {  // drop the last digit rather than wrap
+        v /= 10;
+        out->exponent = 1;
+      }
+      out->mantissa = (int64_t) v;
+      return true;
+    }
+    case DLMS_DATA_TYPE_FLOAT32:
+      if (value_length < 4)
+        return false;
+      out->is_real = true;
+      out->real = dlms_data_as_float(value_type, value_buffer_ptr, value_length);
+      return true;
+    case DLMS_DATA_TYPE_FLOAT64: {
+      if (value_length < 8)
+        return false;
+      uint64_t u = be(value_buffer_ptr, 8);
+      std::memcpy(&out->real, &u, sizeof(out->real));
+      out->is_real = true;
+      return true;
+    }
+    default:
+      return false;
+  }
+}
 
-  // Day of week (1 byte) - skip for formatting
-  // uint8_t dow = buf[4];
+static constexpr uint8_t MAX_VALUE_DEPTH = 4;
 
-  // Hour (1 byte)
-  uint8_t hour = buf[5];
+// A-XDR length: one byte, or 0x81/0x82 followed by 1/2 length bytes
+static bool read_length(const uint8_t *p, size_t &pos, size_t end, size_t &len) {
+  if (pos >= end)
+    return false;
+  uint8_t b = p[pos++];
+  if (b < 0x80) {
+    len = b;
+    return true;
+  }
+  uint8_t n = b & 0x7F;
+  if (n == 0 || n > 2 || pos + n > end)
+    return false;
+  len = 0;
+  while (n--)
+    len = (len << 8) | p[pos++];
+  return true;
+}
 
-  // Minute (1 byte)
-  uint8_t minute = buf[6];
+static int fixed_size(uint8_t tag) {
+  switch (tag) {
+    case DLMS_DATA_TYPE_NONE:
+      return 0;
+    case DLMS_DATA_TYPE_BOOLEAN:
+    case DLMS_DATA_TYPE_INT8:
+    case DLMS_DATA_TYPE_UINT8:
+    case DLMS_DATA_TYPE_ENUM:
+    case DLMS_DATA_TYPE_BINARY_CODED_DESIMAL:
+      return 1;
+    case DLMS_DATA_TYPE_INT16:
+    case DLMS_DATA_TYPE_UINT16:
+      return 2;
+    case DLMS_DATA_TYPE_INT32:
+    case DLMS_DATA_TYPE_UINT32:
+    case DLMS_DATA_TYPE_FLOAT32:
+    case DLMS_DATA_TYPE_TIME:
+      return 4;
+    case DLMS_DATA_TYPE_DATE:
+      return 5;
+    case DLMS_DATA_TYPE_INT64:
+    case DLMS_DATA_TYPE_UINT64:
+    case DLMS_DATA_TYPE_FLOAT64:
+      return 8;
+    case DLMS_DATA_TYPE_DATETIME:
+      return 12;
+    default:
+      return -1;
+  }
+}
 
-  // Second (1 byte)
-  uint8_t second = buf[7];
+// Moves pos past one tagged value, reporting where its content starts and how long it is
+static bool skip_value(const uint8_t *p, size_t &pos, size_t end, uint8_t depth, uint8_t &tag, size_t &from,
+                       size_t &len) {
+  if (pos >= end || depth > MAX_VALUE_DEPTH)
+    return false;
+  tag = p[pos++];
+  int size = fixed_size(tag);
+  if (size >= 0) {
+    from = pos;
+    len = size;
+  } else if (tag == DLMS_DATA_TYPE_OCTET_STRING || tag == DLMS_DATA_TYPE_STRING ||
+             tag == DLMS_DATA_TYPE_STRING_UTF8 || tag == DLMS_DATA_TYPE_BIT_STRING) {
+    if (!read_length(p, pos, end, len))
+      return false;
+    if (tag == DLMS_DATA_TYPE_BIT_STRING)
+      len = (len + 7) / 8;
+    from = pos;
+  } else if (tag == DLMS_DATA_TYPE_STRUCTURE || tag == DLMS_DATA_TYPE_ARRAY) {
+    size_t count = 0;
+    if (!read_length(p, pos, end, count))
+      return false;
+    from = pos;
+    uint8_t t;
+    size_t f, l;
+    while (count--) {
+      if (!skip_value(p, pos, end, depth + 1, t, f, l))
+        return false;
+    }
+    len = pos - from;
+    return true;
+  } else {
+    return false;  // compact arrays and the like are left to Gurux
+  }
+  if (from + len > end)
+    return false;
+  pos = from + len;
+  return true;
+}
 
-  // Hundredths of second (1 byte)
-  uint8_t hundredths = buf[8];
+bool dlms_parse_data_value(const uint8_t *data, size_t len, DlmsGetResult *out) {
+  *out = DlmsGetResult{};
+  if (data == nullptr)
+    return false;
+  size_t pos = 0;
+  uint8_t tag;
+  size_t from, length;
+  // one value and nothing after it
+  if (!skip_value(data, pos, len, 0, tag, from, length) || pos != len || length > UINT16_MAX)
+    return false;
+  out->type = (DLMS_DATA_TYPE) tag;
+  out->offset = from;
+  out->length = length;
+  return true;
+}
 
-  // Timezone deviation (2 bytes, signed, big-endian)
-  uint16_t u_dev = (buf[9] << 8) | buf[10];
-  int16_t deviation = (int16_t) u_dev;
+bool dlms_parse_scaler_unit(const uint8_t *apdu, const DlmsGetResult &res, int8_t *scaler, uint8_t *unit) {
+  // structure of two elements: integer scaler, enum unit
+  const uint8_t *p = apdu + res.offset;
+  if (res.type != DLMS_DATA_TYPE_STRUCTURE || res.length != 4 || p[-1] != 2 || p[0] != DLMS_DATA_TYPE_INT8 ||
+      p[2] != DLMS_DATA_TYPE_ENUM)
+    return false;
+  *scaler = (int8_t) p[1];
+  *unit = p[3];
+  return true;
+}
 
-  // Clock status (1 byte)
-  uint8_t clock_status = buf[11];
+namespace {
 
-  std::ostringstream ss;
+// Appends to a caller-supplied buffer, always keeps it NUL-terminated and silently truncates
+struct CharWriter {
+  char *buf;
+  size_t size;
+  size_t pos{0};
 
-  // Format: YYYY-MM-DD HH:MM:SS
-  if (year != 0x0000 && year != 0xFFFF) {
-    ss << year;
-  } else {
-    ss << "????";
+  CharWriter(char *buf, size_t size) : buf(buf), size(size) {
+    if (size > 0)
+      buf[0] = '\0';
   }
-  ss << "-";
 
-  if (month != 0xFF && month >= 1 && month <= 12) {
-    ss << std::setfill('0') << std::setw(2) << (int) month;
-  } else {
-    ss << "??";
+  void put(char c) {
+    if (this->pos + 1 < this->size) {
+      this->buf[this->pos++] = c;
+      this->buf[this->pos] = '\0';
+    }
+  }
+  void put(const char *s) {
+    while (*s)
+      this->put(*s++);
+  }
+  void put(const char *s, size_t len) {
+    while (len--)
+      this->put(*s++);
+  }
+  // decimal, left-padded with zeros to min_width
+  void dec(uint64_t v, uint8_t min_width = 1) {
+    char tmp[20];
+    uint8_t n = 0;
+    do {
+      tmp[n++] = '0' + v % 10;
+      v /= 10;
+    } while (v != 0);
+    while (n < min_width && n < sizeof(tmp))
+      tmp[n++] = '0';
+    while (n)
+      this->put(tmp[--n]);
+  }
+  void hex(uint8_t b) {
+    static const char DIGITS[] = "0123456789abcdef";
+    this->put(DIGITS[b >> 4]);
+    this->put(DIGITS[b & 0x0F]);
   }
-  ss << "-";
+  // two digits or "??" when outside [min, max]
+  void field2(uint8_t v, uint8_t min, uint8_t max) {
+    if (v >= min && v <= max) {
+      this->dec(v, 2);
+    } else {
+      this->put("??");
+    }
+  }
+};
 
-  if (day != 0xFF && day >= 1 && day <= 31) {
-    ss << std::setfill('0') << std::setw(2) << (int) day;
+}  // namespace
+
+size_t dlms_format_uint(char *buf, size_t size, uint64_t value) {
+  CharWriter w(buf, size);
+  w.dec(value);
+  return w.pos;
+}
+
+size_t dlms_format_int(char *buf, size_t size, int64_t value) {
+  CharWriter w(buf, size);
+  if (value < 0) {
+    w.put('-');
+    w.dec(0 - (uint64_t) value);
   } else {
-    ss << "??";
+    w.dec((uint64_t) value);
   }
-  ss << " ";
+  return w.pos;
+}
 
-  if (hour != 0xFF && hour <= 23) {
-    ss << std::setfill('0') << std::setw(2) << (int) hour;
-  } else {
-    ss << "??";
+size_t dlms_format_hex(char *buf, size_t size, const uint8_t *data, size_t len) {
+  CharWriter w(buf, size);
+  for (size_t i = 0; i < len; i++)
+    w.hex(data[i]);
+  return w.pos;
+}
+
+size_t dlms_format_float(char *buf, size_t size, double value) {
+  if (size == 0)
+    return 0;
+  // %g: six significant digits, as std::ostream prints a float by default
+  int n = snprintf(buf, size, "%g", value);
+  if (n < 0) {
+    buf[0] = '\0';
+    return 0;
   }
-  ss << ":";
+  return (size_t) n < size ? (size_t) n : size - 1;
+}
 
-  if (minute != 0xFF && minute <= 59) {
-    ss << std::setfill('0') << std::setw(2) << (int) minute;
-  } else {
-    ss << "??";
+size_t dlms_datetime_to_chars(char *buf, size_t size, const uint8_t *value_buffer_ptr, uint8_t value_length) {
+  CharWriter w(buf, size);
+  if (value_buffer_ptr == nullptr || value_length < 12) {
+    return 0;
   }
-  ss << ":";
 
-  if (second != 0xFF && second <= 59) {
-    ss << std::setfill('0') << std::setw(2) << (int) second;
+  const uint8_t *p = value_buffer_ptr;
+  uint16_t year = (p[0] << 8) | p[1];
+  uint8_t month = p[2];
+  uint8_t day = p[3];
+  // p[4] is the day of week, not shown
+  uint8_t hour = p[5];
+  uint8_t minute = p[6];
+  uint8_t second = p[7];
+  uint8_t hundredths = p[8];
+  int16_t deviation = (int16_t) ((p[9] << 8) | p[10]);
+  // p[11] is the clock status, not shown
+
+  // YYYY-MM-DD HH:MM:SS[.hh][ +HH:MM]
+  if (year != 0x0000 && year != 0xFFFF) {
+    w.dec(year);
   } else {
-    ss << "??";
+    w.put("????");
   }
-
-  // Add hundredths if available
-  if (hundredths != 0xFF && hundredths <= 99) {
-    ss << "." << std::setfill('0') << std::setw(2) << (int) hundredths;
+  w.put('-');
+  w.field2(month, 1, 12);
+  w.put('-');
+  w.field2(day, 1, 31);
+  w.put(' ');
+  w.field2(hour, 0, 23);
+  w.put(':');
+  w.field2(minute, 0, 59);
+  w.put(':');
+  w.field2(second, 0, 59);
+
+  if (hundredths <= 99) {
+    w.put('.');
+    w.dec(hundredths, 2);
   }
 
-  // Add timezone info if available
   if (deviation != (int16_t) 0x8000) {
-    if (deviation >= 0) {
-      ss << " +" << std::setfill('0') << std::setw(2) << (deviation / 60);
-      ss << ":" << std::setfill('0') << std::setw(2) << (deviation % 60);
-    } else {
-      ss << " -" << std::setfill('0') << std::setw(2) << ((-deviation) / 60);
-      ss << ":" << std::setfill('0') << std::setw(2) << ((-deviation) % 60);
-    }
+    uint16_t d = deviation >= 0 ? deviation : -deviation;
+    w.put(deviation >= 0 ? " +" : " -");
+    w.dec(d / 60, 2);
+    w.put(':');
+    w.dec(d % 60, 2);
   }
 
-  return ss.str();
+  return w.pos;
 }
 
-std::string dlms_data_as_string(DLMS_DATA_TYPE value_type, const uint8_t *value_buffer_ptr, uint8_t value_length) {
-  if (value_buffer_ptr == nullptr && value_length == 0)
-    return std::string();
-
-  auto hex_of = [](const uint8_t *p, uint8_t len) -> std::string {
-    std::ostringstream ss;
-    ss << std::hex << std::setfill('0');
-    for (uint8_t i = 0; i < len; i++) {
-      ss << std::setw(2) << static_cast<int>(p[i]);
-      if (i + 1 < len)
-        ss << "";  // compact
-    }
-    return ss.str();
+size_t dlms_data_to_chars(char *buf, size_t size, DLMS_DATA_TYPE value_type, const uint8_t *value_buffer_ptr,
+                          uint8_t value_length) {
+  if (size > 0)
+    buf[0] = '\0';
+  if (value_buffer_ptr == nullptr || value_length == 0)
+    return 0;
+
+  auto be = [](const uint8_t *p, uint8_t n) -> uint64_t {
+    uint64_t v = 0;
+    for (uint8_t i = 0; i < n; i++)
+      v = (v << 8) | p[i];
+    return v;
   };
 
   switch (value_type) {
     case DLMS_DATA_TYPE_OCTET_STRING:
     case DLMS_DATA_TYPE_STRING:
     case DLMS_DATA_TYPE_STRING_UTF8: {
-      return std::string(reinterpret_cast<const char *>(value_buffer_ptr),
-                         reinterpret_cast<const char *>(value_buffer_ptr) + value_length);
+      // up to the first NUL, like a C string
+      CharWriter w(buf, size);
+      w.put(reinterpret_cast<const char *>(value_buffer_ptr),
+            strnlen(reinterpret_cast<const char *>(value_buffer_ptr), value_length));
+      return w.pos;
     }
     case DLMS_DATA_TYPE_BIT_STRING:
     case DLMS_DATA_TYPE_BINARY_CODED_DESIMAL:
-      return hex_of(value_buffer_ptr, value_length);
+    case DLMS_DATA_TYPE_DATE:
+    case DLMS_DATA_TYPE_TIME:
+      // dates and times alone are left to higher-level layers
+      return dlms_format_hex(buf, size, value_buffer_ptr, value_length);
 
     case DLMS_DATA_TYPE_BOOLEAN:
     case DLMS_DATA_TYPE_ENUM:
-    case DLMS_DATA_TYPE_UINT8: {
-      return std::to_string(static_cast<unsigned>(value_buffer_ptr ? value_buffer_ptr[0] : 0));
-    }
-    case DLMS_DATA_TYPE_INT8: {
-      return std::to_string(static_cast<int>(static_cast<int8_t>(value_buffer_ptr ? value_buffer_ptr[0] : 0)));
-    }
-    case DLMS_DATA_TYPE_UINT16: {
-      if (value_length >= 2) {
-        uint16_t v = (uint16_t) ((value_buffer_ptr[0] << 8) | value_buffer_ptr[1]);
-        return std::to_string(v);
-      }
-      return std::string();
-    }
-    case DLMS_DATA_TYPE_INT16: {
-      if (value_length >= 2) {
-        int16_t v = (int16_t) ((value_buffer_ptr[0] << 8) | value_buffer_ptr[1]);
-        return std::to_string(v);
-      }
-      return std::string();
-    }
-    case DLMS_DATA_TYPE_UINT32: {
-      if (value_length >= 4) {
-        uint32_t v = ((uint32_t) value_buffer_ptr[0] << 24) | ((uint32_t) value_buffer_ptr[1] << 16) |
-                     ((uint32_t) value_buffer_ptr[2] << 8) | (uint32_t) value_buffer_ptr[3];
-        return std::to_string(v);
-      }
-      return std::string();
-    }
-    case DLMS_DATA_TYPE_INT32: {
-      if (value_length >= 4) {
-        int32_t v = ((int32_t) value_buffer_ptr[0] << 24) | ((int32_t) value_buffer_ptr[1] << 16) |
-                    ((int32_t) value_buffer_ptr[2] << 8) | (int32_t) value_buffer_ptr[3];
-        return std::to_string(v);
-      }
-      return std::string();
-    }
-    case DLMS_DATA_TYPE_UINT64: {
-      if (value_length >= 8) {
-        uint64_t v = 0;
-        for (int i = 0; i < 8; i++)
-          v = (v << 8) | value_buffer_ptr[i];
-        return std::to_string(v);
-      }
-      return std::string();
-    }
-    case DLMS_DATA_TYPE_INT64: {
-      if (value_length >= 8) {
-        uint64_t u = 0;
-        for (int i = 0; i < 8; i++)
-          u = (u << 8) | value_buffer_ptr[i];
-        int64_t v = static_cast<int64_t>(u);
-        return std::to_string(v);
-      }
-      return std::string();
-    }
+    case DLMS_DATA_TYPE_UINT8:
+      return dlms_format_uint(buf, size, value_buffer_ptr[0]);
+    case DLMS_DATA_TYPE_INT8:
+      return dlms_format_int(buf, size, (int8_t) value_buffer_ptr[0]);
+    case DLMS_DATA_TYPE_UINT16:
+      return value_length >= 2 ? dlms_format_uint(buf, size, be(value_buffer_ptr, 2)) : 0;
+    case DLMS_DATA_TYPE_INT16:
+      return value_length >= 2 ? dlms_format_int(buf, size, (int16_t) be(value_buffer_ptr, 2)) : 0;
+    case DLMS_DATA_TYPE_UINT32:
+      return value_length >= 4 ? dlms_format_uint(buf, size, be(value_buffer_ptr, 4)) : 0;
+    case DLMS_DATA_TYPE_INT32:
+      return value_length >= 4 ? dlms_format_int(buf, size, (int32_t) be(value_buffer_ptr, 4)) : 0;
+    case DLMS_DATA_TYPE_UINT64:
+      return value_length >= 8 ? dlms_format_uint(buf, size, be(value_buffer_ptr, 8)) : 0;
+    case DLMS_DATA_TYPE_INT64:
+      return value_length >= 8 ? dlms_format_int(buf, size, (int64_t) be(value_buffer_ptr, 8)) : 0;
     case DLMS_DATA_TYPE_FLOAT32:
-    case DLMS_DATA_TYPE_FLOAT64: {
-      float f = dlms_data_as_float(value_type, value_buffer_ptr, value_length);
-      // Use minimal formatting
-      std::ostringstream ss;
-      ss << f;
-      return ss.str();
-    }
+    case DLMS_DATA_TYPE_FLOAT64:
+      return dlms_format_float(buf, size, dlms_data_as_float(value_type, value_buffer_ptr, value_length));
     case DLMS_DATA_TYPE_DATETIME:
-      return dlms_datetime_as_string(value_buffer_ptr, value_length);
-    case DLMS_DATA_TYPE_DATE:
-    case DLMS_DATA_TYPE_TIME:
-      // For now, return hex. Higher-level layers may decode properly.
-      return hex_of(value_buffer_ptr, value_length);
+      return dlms_datetime_to_chars(buf, size, value_buffer_ptr, value_length);
 
     case DLMS_DATA_TYPE_NONE:
     default:
-      return std::string();
+      return 0;
   }
 }
 
+std::string dlms_datetime_as_string(const uint8_t *value_buffer_ptr, uint8_t value_length) {
+  char buf[DLMS_DATETIME_STRING_SIZE];
+  size_t len = dlms_datetime_to_chars(buf, sizeof(buf), value_buffer_ptr, value_length);
+  return std::string(buf, len);
+}
+
+std::string dlms_data_as_string(DLMS_DATA_TYPE value_type, const uint8_t *value_buffer_ptr, uint8_t value_length) {
+  char buf[DLMS_VALUE_STRING_SIZE];
+  size_t len = dlms_data_to_chars(buf, sizeof(buf), value_type, value_buffer_ptr, value_length);
+  return std::string(buf, len);
+}
+
 const char *dlms_error_to_string(int error) {
   switch (error) {
     case DLMS_ERROR_CODE_OK:
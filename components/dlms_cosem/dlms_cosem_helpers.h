@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <dlmssettings.h>
 
@@ -7,11 +9,78 @@ namespace esphome {
 namespace dlms_cosem {
 
 float dlms_data_as_float(DLMS_DATA_TYPE value_type, const uint8_t *value_buffer_ptr, uint8_t value_length);
+
+// 10^exp from a table of exact powers, no pow()
+double dlms_pow10(int exp);
+
+/**
+ * Numeric value as decoded, carried as is up to the sensor.
+ * Integers stay exact as mantissa * 10^exponent, so a scaler only moves the exponent;
+ * floating point values are kept as double.
+ */
+struct DlmsNumber {
+  int64_t mantissa{0};
+  double real{0.0};
+  int8_t exponent{0};
+  bool is_real{false};
+
+  void scale(int8_t scaler) {
+    if (this->is_real) {
+      this->real *= dlms_pow10(scaler);
+    } else {
+      this->exponent += scaler;
+    }
+  }
+  // the one rounding step, done at the publish boundary
+  double to_double() const;
+};
+
+// false for non-numeric types, out is left zero then
+bool dlms_data_as_number(DLMS_DATA_TYPE value_type, const uint8_t *value_buffer_ptr, uint8_t value_length,
+                         DlmsNumber *out);
+
+/**
+ * Value of a GET reply, located in the reply buffer without decoding it into a variant. Gurux has
+ * consumed the response header by then (and answered access errors with an error code), so the
+ * buffer holds the bare A-XDR value, starting with its type tag, as push telegrams do.
+ * For strings offset/length cover the characters, for structures and arrays the encoded elements.
+ */
+struct DlmsGetResult {
+  DLMS_DATA_TYPE type{DLMS_DATA_TYPE_NONE};
+  uint16_t offset{0};
+  uint16_t length{0};
+};
+
+// false unless data is exactly one value of a type handled here (compact arrays, truncated data);
+// the caller then falls back to the value Gurux decoded
+bool dlms_parse_data_value(const uint8_t *data, size_t len, DlmsGetResult *out);
+// scaler and unit from the scaler_unit structure of a register's attribute 3
+bool dlms_parse_scaler_unit(const uint8_t *apdu, const DlmsGetResult &res, int8_t *scaler, uint8_t *unit);
+
+// Formatters writing into a caller-supplied buffer: the result is always NUL-terminated, truncated to size - 1
+// characters if needed, and its length is returned. Nothing is allocated.
+static constexpr size_t DLMS_DATETIME_STRING_SIZE = 32;
+static constexpr size_t DLMS_VALUE_STRING_SIZE = 256;  // fits any octet string, hex is truncated past 127 bytes
+
+size_t dlms_format_uint(char *buf, size_t size, uint64_t value);
+size_t dlms_format_int(char *buf, size_t size, int64_t value);
+size_t dlms_format_hex(char *buf, size_t size, const uint8_t *data, size_t len);
+size_t dlms_format_float(char *buf, size_t size, double value);
+size_t dlms_datetime_to_chars(char *buf, size_t size, const uint8_t *value_buffer_ptr, uint8_t value_length);
+size_t dlms_data_to_chars(char *buf, size_t size, DLMS_DATA_TYPE value_type, const uint8_t *value_buffer_ptr,
+                          uint8_t value_length);
+
+// std::string wrappers of the above
 std::string dlms_datetime_as_string(const uint8_t *value_buffer_ptr, uint8_t value_length);
 std::string dlms_data_as_string(DLMS_DATA_TYPE value_type, const uint8_t *value_buffer_ptr, uint8_t value_length);
 
 const char *dlms_data_type_to_string(DLMS_DATA_TYPE vt);
 const char *dlms_error_to_string(int error);
+// dlms_getData2() returns the data-access-result of a GET-Response as is (1..250): the meter did answer,
+// with an error for the object. Library errors (bad frames, CRC, memory) are above that range.
+inline bool dlms_is_access_result(int error) {
+  return error > DLMS_ERROR_CODE_OK && error <= DLMS_ERROR_CODE_OTHER_REASON;
+}
 
 }  // namespace dlms_cosem
 }  // namespace esphome
@@ -0,0 +1,119 @@
+#include "dlms_cosem_port.h"
+
+#ifdef USE_HOST
+#include "esphome/core/log.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace esphome {
+namespace dlms_cosem {
+
+static const char *TAG = "dlms_cosem.port";
+
+static speed_t to_speed(uint32_t baud_rate) {
+  switch (baud_rate) {
+    case 300:
+      return B300;
+    case 600:
+      return B600;
+    case 1200:
+      return B1200;
+    case 2400:
+      return B2400;
+    case 4800:
+      return B4800;
+    case 19200:
+      return B19200;
+    case 38400:
+      return B38400;
+    case 57600:
+      return B57600;
+    case 115200:
+      return B115200;
+    case 9600:
+    default:
+      return B9600;
+  }
+}
+
+PosixSerialPort::~PosixSerialPort() {
+  if (this->fd_ >= 0)
+    ::close(this->fd_);
+}
+
+bool PosixSerialPort::open() {
+  this->fd_ = ::open(this->path_.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (this->fd_ < 0) {
+    ESP_LOGE(TAG, "Can't open %s: %s", this->path_.c_str(), strerror(errno));
+    return false;
+  }
+  struct termios tio {};
+  if (tcgetattr(this->fd_, &tio) == 0) {
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tcsetattr(this->fd_, TCSANOW, &tio);
+  }
+  // a pty has no line settings, that's fine
+  return true;
+}
+
+int PosixSerialPort::available() {
+  int n = 0;
+  if (this->fd_ < 0 || ioctl(this->fd_, FIONREAD, &n) != 0)
+    return 0;
+  return n;
+}
+
+bool PosixSerialPort::read_array(uint8_t *data, size_t len) {
+  while (len > 0) {
+    ssize_t n = ::read(this->fd_, data, len);
+    if (n <= 0)
+      return false;
+    data += n;
+    len -= n;
+  }
+  return true;
+}
+
+void PosixSerialPort::write_array(const uint8_t *data, size_t len) {
+  while (len > 0) {
+    ssize_t n = ::write(this->fd_, data, len);
+    if (n < 0 && (errno == EAGAIN || errno == EINTR)) {
+      // device buffer is full, sleep until it drains instead of spinning
+      struct pollfd pfd {
+        .fd = this->fd_, .events = POLLOUT, .revents = 0
+      };
+      int ready = ::poll(&pfd, 1, static_cast<int>(this->write_timeout_ms_));
+      if (ready > 0 && (pfd.revents & POLLOUT))
+        continue;
+      ESP_LOGW(TAG, "Write to %s timed out, %u bytes not sent", this->path_.c_str(), static_cast<unsigned>(len));
+      return;
+    }
+    if (n <= 0) {
+      ESP_LOGW(TAG, "Write to %s failed: %s", this->path_.c_str(), strerror(errno));
+      return;
+    }
+    data += n;
+    len -= n;
+  }
+}
+
+void PosixSerialPort::set_baud_rate(uint32_t baud_rate) {
+  struct termios tio {};
+  if (this->fd_ < 0 || tcgetattr(this->fd_, &tio) != 0)
+    return;
+  cfsetispeed(&tio, to_speed(baud_rate));
+  cfsetospeed(&tio, to_speed(baud_rate));
+  tcsetattr(this->fd_, TCSADRAIN, &tio);
+}
+
+}  // namespace dlms_cosem
+}  // namespace esphome
+
+#endif  // USE_HOST
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+
+#if defined(USE_ESP32) || defined(USE_ESP8266)
+#include "esphome/components/uart/uart.h"
+#include "dlms_cosem_uart.h"
+#endif
+
+namespace esphome {
+namespace dlms_cosem {
+
+/**
+ * Byte stream between the component and the meter.
+ * The session engine does all of its I/O through this interface, so the serial side can be
+ * replaced (POSIX tty/pty on the host platform, in-memory pipes, recorders) without touching it.
+ */
+class DlmsCosemPort {
+ public:
+  virtual ~DlmsCosemPort() = default;
+
+  virtual int available() = 0;
+  virtual bool read_byte(uint8_t *data) = 0;
+  virtual bool read_array(uint8_t *data, size_t len) = 0;
+  virtual void write_array(const uint8_t *data, size_t len) = 0;
+  virtual void set_baud_rate(uint32_t baud_rate) = 0;
+
+  // Identity of the physical bus: ports sharing it share the session lock and bus statistics
+  virtual const void *bus_id() const { return this; }
+};
+
+#if defined(USE_ESP32) || defined(USE_ESP8266)
+// ESPHome UART bus, with optional RS-485 direction pin
+class UartPort final : public DlmsCosemPort {
+ public:
+  UartPort(uart::UARTComponent *parent, GPIOPin *flow_control_pin)
+      : parent_(parent), flow_control_pin_(flow_control_pin) {
+#ifdef USE_ESP32
+    this->iuart_ = make_unique<DlmsCosemUart>(*static_cast<uart::IDFUARTComponent *>(parent));
+#endif
+#ifdef USE_ESP8266
+    this->iuart_ = make_unique<DlmsCosemUart>(*static_cast<uart::ESP8266UartComponent *>(parent));
+#endif
+  }
+
+  int available() override { return this->parent_->available(); }
+  bool read_byte(uint8_t *data) override { return this->iuart_->read_one_byte(data); }
+  bool read_array(uint8_t *data, size_t len) override { return this->parent_->read_array(data, len); }
+
+  void write_array(const uint8_t *data, size_t len) override {
+    if (this->flow_control_pin_ != nullptr)
+      this->flow_control_pin_->digital_write(true);
+    this->parent_->write_array(data, len);
+    if (this->flow_control_pin_ != nullptr)
+      this->flow_control_pin_->digital_write(false);
+  }
+
+  void set_baud_rate(uint32_t baud_rate) override { this->iuart_->update_baudrate(baud_rate); }
+
+  const void *bus_id() const override { return this->parent_; }
+
+ protected:
+  uart::UARTComponent *parent_;
+  GPIOPin *flow_control_pin_;
+  std::unique_ptr<DlmsCosemUart> iuart_;
+};
+#endif
+
+#ifdef USE_HOST
+// Serial device or pty on the host platform
+class PosixSerialPort final : public DlmsCosemPort {
+ public:
+  explicit PosixSerialPort(std::string path) : path_(std::move(path)) {}
+  ~PosixSerialPort() override;
+
+  bool open();
+
+  int available() override;
+  bool read_byte(uint8_t *data) override { return this->read_array(data, 1); }
+  bool read_array(uint8_t *data, size_t len) override;
+  void write_array(const uint8_t *data, size_t len) override;
+  void set_baud_rate(uint32_t baud_rate) override;
+
+  // how long write_array() waits for the device to accept more bytes
+  void set_write_timeout_ms(uint32_t timeout_ms) { this->write_timeout_ms_ = timeout_ms; }
+
+ protected:
+  std::string path_;
+  uint32_t write_timeout_ms_{1000};
+  int fd_{-1};
+};
+#endif
+
+}  // namespace dlms_cosem
+}  // namespace esphome
@@ -1,12 +1,22 @@
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "esphome/core/entity_base.h"
+#include "esphome/core/hal.h"
 
 #include "esphome/components/sensor/sensor.h"
 
+#include "cp1251.h"
+#include "dlms_cosem_helpers.h"
+#include "obis_index.h"
+
 #ifdef USE_TEXT_SENSOR
 #include "esphome/components/text_sensor/text_sensor.h"
 #endif
@@ -21,7 +31,8 @@ namespace dlms_cosem {
 /**
  * We keep a light abstraction over different entity types that can be bound to an OBIS code.
  * The python codegen creates objects with the default ctor and then calls setters
- * (set_name_and_object_id, set_obis_code, set_attribute, set_request_retries, ...).
+ * (set_obis_code, set_attribute, set_request_retries, ...).
+ * Only a compact record is kept per sensor: the OBIS code as its 6 bytes, the name stays with the entity.
  */
 enum class SensorType : uint8_t {
   SENSOR = 0,
@@ -29,22 +40,66 @@ enum class SensorType : uint8_t {
   BINARY_SENSOR = 2,
 };
 
+// Request statistics of one object, pull mode
+struct ObjectTelemetry {
+  static constexpr uint8_t ERROR_SLOTS = 4;
+
+  uint32_t reads{0};
+  uint32_t last_rtt_ms{0};  // first request to value received, unit request included
+  float ewma_rtt_ms{0.0f};  // alpha 1/8
+  uint32_t max_rtt_ms{0};
+  uint32_t frame_errors{0};  // invalid frames and non-critical timeouts while reading
+  uint32_t retries{0};       // requests sent again after a lost or corrupted reply
+  struct {
+    int code;
+    uint16_t count;
+  } errors[ERROR_SLOTS]{};
+  uint16_t other_errors{0};  // codes not fitting into errors[]
+
+  void record(uint32_t rtt_ms, int error, uint32_t frame_errors, uint32_t retries) {
+    this->ewma_rtt_ms = this->reads == 0 ? rtt_ms : this->ewma_rtt_ms + (rtt_ms - this->ewma_rtt_ms) / 8.0f;
+    this->reads++;
+    this->last_rtt_ms = rtt_ms;
+    this->max_rtt_ms = std::max(this->max_rtt_ms, rtt_ms);
+    this->frame_errors += frame_errors;
+    this->retries += retries;
+    if (error == 0)
+      return;
+    for (auto &e : this->errors) {
+      if (e.count == 0 || e.code == error) {
+        e.code = error;
+        e.count++;
+        return;
+      }
+    }
+    this->other_errors++;
+  }
+
+  uint32_t error_count() const {
+    uint32_t n = this->other_errors;
+    for (const auto &e : this->errors)
+      n += e.count;
+    return n;
+  }
+};
+
 class DlmsCosemSensorBase {
  public:
   DlmsCosemSensorBase() = default;
   virtual ~DlmsCosemSensorBase() = default;
 
   // Identification
-  void set_name_and_object_id(const std::string &name, const std::string &object_id) {
-    this->sensor_name_ = name;
-    this->object_id_ = object_id;
-  }
-  const std::string &get_sensor_name() const { return this->sensor_name_; }
-  virtual const std::string &get_id() const = 0;
+  const char *get_sensor_name() { return this->get_base()->get_name().c_str(); }
 
-  // OBIS/COSEM parameters
-  void set_obis_code(std::string obis_code) { this->obis_code_ = std::move(obis_code); }
-  const std::string &get_obis_code() const { return this->obis_code_; }
+  // OBIS/COSEM parameters; codegen passes the six bytes, the string form is for lambdas
+  void set_obis_code(uint8_t a, uint8_t b, uint8_t c, uint8_t d, uint8_t e, uint8_t f) {
+    const uint8_t obis[6] = {a, b, c, d, e, f};
+    memcpy(this->obis_, obis, sizeof(this->obis_));
+  }
+  bool set_obis_code(const char *obis_code) { return obis_parse(obis_code, this->obis_); }
+  const uint8_t *get_obis() const { return this->obis_; }
+  uint64_t get_obis_key() const { return obis_pack(this->obis_); }
+  ObisString get_obis_code() const { return obis_to_string(this->obis_); }
 
   void set_obis_class(uint16_t obis_class) { this->obis_class_ = obis_class; }
   uint16_t get_obis_class() const { return this->obis_class_; }
@@ -59,6 +114,11 @@ class DlmsCosemSensorBase {
   void set_dont_publish(bool dont_publish) { this->dont_publish_ = dont_publish; }
   bool shall_we_publish() const { return !this->dont_publish_; }
 
+  // Change-only publishing: skip values equal to the last published one (within deadband for
+  // numeric sensors), but still publish at least every max_silence ms if that is set
+  void set_publish_on_change(bool on_change) { this->publish_on_change_ = on_change; }
+  void set_max_silence_ms(uint32_t ms) { this->max_silence_ms_ = ms; }
+
   SensorType get_type() const { return this->type_; }
 
   // Scale/unit support (numeric sensors); other types just report "ready".
@@ -70,18 +130,64 @@ class DlmsCosemSensorBase {
   // Called by component when new value arrived
   virtual void publish() = 0;
 
+  ObjectTelemetry &telemetry() { return this->telemetry_; }
+  const ObjectTelemetry &telemetry() const { return this->telemetry_; }
+
+  // Fast polling: the object is read in the hub's fast poll sessions until this time
+  void set_fast_poll_until(uint32_t ms) { this->fast_poll_until_ms_ = ms; }
+  bool is_fast_polled(uint32_t now) const {
+    return this->fast_poll_until_ms_ != 0 && (int32_t) (this->fast_poll_until_ms_ - now) > 0;
+  }
+
  protected:
   SensorType type_{SensorType::SENSOR};
 
-  std::string sensor_name_{};
-  std::string object_id_{};
-
-  std::string obis_code_{};
+  uint8_t obis_[6]{};
   uint16_t obis_class_{0};
   uint8_t attribute_{2};
   uint8_t request_retries_{3};
 
   bool dont_publish_{false};
+
+  ObjectTelemetry telemetry_{};
+
+  bool publish_on_change_{false};
+  bool published_once_{false};
+  uint32_t max_silence_ms_{0};
+  uint32_t last_publish_ms_{0};
+  uint32_t fast_poll_until_ms_{0};
+
+  bool check_publish_needed_(bool changed) {
+    uint32_t now = millis();
+    if (this->publish_on_change_ && this->published_once_ && !changed &&
+        (this->max_silence_ms_ == 0 || now - this->last_publish_ms_ < this->max_silence_ms_))
+      return false;
+    this->published_once_ = true;
+    this->last_publish_ms_ = now;
+    return true;
+  }
+};
+
+// Event that moves objects into fast polling: the value is above/below a threshold or
+// changes faster than rate per second. Each hit keeps the targets fast for another duration.
+struct FastPollTrigger {
+  double above{NAN};
+  double below{NAN};
+  double rate{NAN};
+  uint32_t duration_ms{0};
+  std::vector<uint64_t> targets;  // packed OBIS codes
+
+  double last_value{NAN};
+  uint32_t last_ms{0};
+
+  bool check(double value, uint32_t now) {
+    bool hit = (!std::isnan(this->above) && value > this->above) || (!std::isnan(this->below) && value < this->below);
+    if (!std::isnan(this->rate) && !std::isnan(this->last_value) && now != this->last_ms)
+      hit |= std::fabs(value - this->last_value) * 1000.0 / (now - this->last_ms) >= this->rate;
+    this->last_value = value;
+    this->last_ms = now;
+    return hit;
+  }
 };
 
 // Numeric sensor (sensor::Sensor)
@@ -90,21 +196,25 @@ class DlmsCosemSensor : public DlmsCosemSensorBase, public sensor::Sensor {
   DlmsCosemSensor() { this->type_ = SensorType::SENSOR; }
 
   // setters used by codegen / component
-  void set_multiplier(float multiplier) { this->multiplier_ = multiplier; }
+  void set_multiplier(double multiplier) { this->multiplier_ = multiplier; }
+  void set_deadband(float deadband) { this->deadband_ = deadband; }
+  void set_deadband_percent(float percent) { this->deadband_percent_ = percent; }
 
   bool has_got_scale_and_unit() const override { return this->has_scale_and_unit_; }
-  void set_scale_and_unit(int scal, int unit, std::string unit_str) {
+  // unit_str must be static, as obj_getUnitAsString() returns
+  void set_scale_and_unit(int8_t scal, uint8_t unit, const char *unit_str) {
     this->scale_ = scal;
     this->unit_ = unit;
-    this->unit_str_ = std::move(unit_str);
+    this->unit_str_ = unit_str;
     this->has_scale_and_unit_ = true;
   }
   int get_scale() const { return this->scale_; }
   int get_unit() const { return this->unit_; }
-  const std::string &get_unit_str() const { return this->unit_str_; }
+  const char *get_unit_str() const { return this->unit_str_; }
 
   // value set by component
-  void set_value(float value) {
+  void set_value(const DlmsNumber &value) { this->set_value(value.to_double()); }
+  void set_value(double value) {
     this->value_ = value * this->multiplier_;
     this->has_value_ = true;
     this->tries_ = 0;
@@ -114,25 +224,61 @@ class DlmsCosemSensor : public DlmsCosemSensorBase, public sensor::Sensor {
     if (!this->shall_we_publish())
       return;
     if (this->has_value_) {
-      this->publish_state(this->value_);
+      if (this->check_publish_needed_(this->is_changed_())) {
+        this->publish_state((float) this->value_);  // the only narrowing to float
+        this->last_published_value_ = this->value_;
+      }
       this->has_value_ = false;
     }
   }
 
-  const std::string &get_id() const override { return this->object_id_; }
-
   EntityBase *get_base() override { return this; }
 
+  // NAN disables a condition; targets default to this sensor's OBIS code
+  void set_fast_poll(double above, double below, double rate, uint32_t duration_ms) {
+    this->fast_poll_ = std::make_unique<FastPollTrigger>();
+    this->fast_poll_->above = above;
+    this->fast_poll_->below = below;
+    this->fast_poll_->rate = rate;
+    this->fast_poll_->duration_ms = duration_ms;
+  }
+  void add_fast_poll_target(uint8_t a, uint8_t b, uint8_t c, uint8_t d, uint8_t e, uint8_t f) {
+    const uint8_t obis[6] = {a, b, c, d, e, f};
+    this->fast_poll_->targets.push_back(obis_pack(obis));
+  }
+  bool has_fast_poll() const { return this->fast_poll_ != nullptr; }
+  // checks the value just read, the trigger if it hits
+  const FastPollTrigger *check_fast_poll(uint32_t now) {
+    if (!this->fast_poll_ || !this->has_value_ || !this->fast_poll_->check(this->value_, now))
+      return nullptr;
+    return this->fast_poll_.get();
+  }
+
  protected:
-  float value_{NAN};
+  bool is_changed_() const {
+    double last = this->last_published_value_;
+    if (std::isnan(this->value_) || std::isnan(last))
+      return std::isnan(this->value_) != std::isnan(last);
+    double band = std::max<double>(this->deadband_, std::fabs(last) * this->deadband_percent_ / 100.0);
+    double diff = std::fabs(this->value_ - last);
+    return band > 0.0 ? diff >= band : diff != 0.0;
+  }
+
+  double value_{NAN};
   bool has_value_{false};
   uint8_t tries_{0};
 
-  float multiplier_{1.0f};
+  double last_published_value_{NAN};
+  float deadband_{0.0f};
+  float deadband_percent_{0.0f};
+
+  double multiplier_{1.0};
 
-  int scale_{0};
-  int unit_{0};
-  std::string unit_str_{};
+  std::unique_ptr<FastPollTrigger> fast_poll_;  // only for sensors that have one
+
+  const char *unit_str_{""};
+  int8_t scale_{0};
+  uint8_t unit_{0};
   bool has_scale_and_unit_{false};
 };
 
@@ -141,21 +287,37 @@ class DlmsCosemTextSensor : public DlmsCosemSensorBase, public text_sensor::Text
  public:
   DlmsCosemTextSensor() { this->type_ = SensorType::TEXT_SENSOR; }
 
-  explicit DlmsCosemTextSensor(std::string obis_code, uint8_t attribute, uint8_t request_retries) {
+  explicit DlmsCosemTextSensor(const char *obis_code, uint8_t attribute, uint8_t request_retries) {
     this->type_ = SensorType::TEXT_SENSOR;
-    this->obis_code_ = std::move(obis_code);
+    this->set_obis_code(obis_code);
     this->attribute_ = attribute;
     this->request_retries_ = request_retries;
   }
 
-  void set_value(const char *value, bool cp1251_conversion_required) {
-    std::string s(value ? value : "");
-    if (cp1251_conversion_required) {
-      // Best-effort: ESPHome strings are UTF-8; if device returns CP1251 bytes and user enabled conversion,
-      // we just keep bytes as-is here. Proper conversion requires a mapping table; keep behavior non-crashing.
-      // If you need strict CP1251->UTF8, implement it here.
+  void set_value(const char *value, DLMS_DATA_TYPE type, bool cp1251_conversion_required) {
+    this->set_value(value, value ? strlen(value) : 0, type, cp1251_conversion_required);
+  }
+
+  // per-sensor override of the hub's cp1251 setting
+  void set_cp1251_conversion_required(bool required) {
+    this->cp1251_ = required ? Cp1251::CONVERT : Cp1251::KEEP;
+  }
+
+  // type is the DLMS type the text was formatted from: only raw strings are transcoded, numbers,
+  // dates and UTF-8 strings are kept as they are. Compares in place, the stored string is only
+  // touched when the value has changed.
+  void set_value(const char *value, size_t len, DLMS_DATA_TYPE type, bool cp1251_conversion_required) {
+    char utf8[TEXT_SENSOR_MAX_BYTES];
+    const bool raw_string = type == DLMS_DATA_TYPE_OCTET_STRING || type == DLMS_DATA_TYPE_STRING;
+    if (raw_string &&
+        (this->cp1251_ == Cp1251::HUB ? cp1251_conversion_required : this->cp1251_ == Cp1251::CONVERT)) {
+      len = cp1251_to_utf8(reinterpret_cast<const uint8_t *>(value), len, utf8, sizeof(utf8));
+      value = utf8;
+    }
+    if (len != this->value_.size() || (len > 0 && memcmp(value, this->value_.data(), len) != 0)) {
+      this->value_.assign(value, len);
+      this->changed_ = true;
     }
-    this->value_ = std::move(s);
     this->has_value_ = true;
     this->tries_ = 0;
   }
@@ -164,18 +326,25 @@ class DlmsCosemTextSensor : public DlmsCosemSensorBase, public text_sensor::Text
     if (!this->shall_we_publish())
       return;
     if (this->has_value_) {
-      this->publish_state(this->value_);
+      if (this->check_publish_needed_(this->changed_)) {
+        this->publish_state(this->value_);
+        this->changed_ = false;
+      }
       this->has_value_ = false;
     }
   }
 
-  const std::string &get_id() const override { return this->object_id_; }
-
   EntityBase *get_base() override { return this; }
 
  protected:
+  // converted values longer than this are clipped
+  static constexpr size_t TEXT_SENSOR_MAX_BYTES = 384;
+  enum class Cp1251 : uint8_t { HUB, CONVERT, KEEP };
+
   std::string value_{};
   bool has_value_{false};
+  bool changed_{false};  // value_ differs from the last published one
+  Cp1251 cp1251_{Cp1251::HUB};
   uint8_t tries_{0};
 };
 #endif  // USE_TEXT_SENSOR
@@ -185,9 +354,9 @@ class DlmsCosemBinarySensor : public DlmsCosemSensorBase, public binary_sensor::
  public:
   DlmsCosemBinarySensor() { this->type_ = SensorType::BINARY_SENSOR; }
 
-  explicit DlmsCosemBinarySensor(std::string obis_code, uint8_t attribute, uint8_t request_retries) {
+  explicit DlmsCosemBinarySensor(const char *obis_code, uint8_t attribute, uint8_t request_retries) {
     this->type_ = SensorType::BINARY_SENSOR;
-    this->obis_code_ = std::move(obis_code);
+    this->set_obis_code(obis_code);
     this->attribute_ = attribute;
     this->request_retries_ = request_retries;
   }
@@ -202,17 +371,19 @@ class DlmsCosemBinarySensor : public DlmsCosemSensorBase, public binary_sensor::
     if (!this->shall_we_publish())
       return;
     if (this->has_value_) {
-      this->publish_state(this->value_);
+      if (this->check_publish_needed_(this->value_ != this->last_published_value_)) {
+        this->publish_state(this->value_);
+        this->last_published_value_ = this->value_;
+      }
       this->has_value_ = false;
     }
   }
 
-  const std::string &get_id() const override { return this->object_id_; }
-
   EntityBase *get_base() override { return this; }
 
  protected:
   bool value_{false};
+  bool last_published_value_{false};
   bool has_value_{false};
   uint8_t tries_{0};
 };
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace esphome {
+namespace dlms_cosem {
+
+/**
+ * Duration statistics with a fixed log-scale histogram, no allocation.
+ * Bucket i counts samples below 8^(i+1) us: <8us, <64us, <512us, <4ms, <33ms, <262ms, <2s, the rest.
+ */
+struct DurationHistogram {
+  static constexpr uint8_t BUCKETS = 8;
+
+  uint32_t count{0};
+  uint64_t total_us{0};
+  uint32_t max_us{0};
+  uint16_t buckets[BUCKETS]{};
+
+  void add(uint32_t us) {
+    this->count++;
+    this->total_us += us;
+    if (us > this->max_us)
+      this->max_us = us;
+    uint8_t i = 0;
+    for (uint32_t v = us; v >= 8 && i < BUCKETS - 1; v >>= 3)
+      i++;
+    if (this->buckets[i] != UINT16_MAX)
+      this->buckets[i]++;
+  }
+
+  uint32_t avg_us() const { return this->count ? (uint32_t) (this->total_us / this->count) : 0; }
+
+  // "a/b/c/d/e/f/g/h", returns buf
+  char *format_buckets(char *buf, size_t size) const {
+    size_t pos = 0;
+    buf[0] = '\0';
+    for (uint8_t i = 0; i < BUCKETS && pos < size; i++) {
+      int n = snprintf(buf + pos, size - pos, i ? "/%u" : "%u", this->buckets[i]);
+      if (n < 0)
+        break;
+      pos += n;
+    }
+    return buf;
+  }
+};
+
+}  // namespace dlms_cosem
+}  // namespace esphome
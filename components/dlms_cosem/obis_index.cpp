@@ -0,0 +1,71 @@
+#include "obis_index.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace esphome {
+namespace dlms_cosem {
+
+bool obis_parse(const char *str, uint8_t *obis) {
+  // codegen normalizes OBIS codes to "A.B.C.D.E.F"
+  if (str == nullptr)
+    return false;
+  for (int i = 0; i < 6; i++) {
+    char *end;
+    unsigned long v = strtoul(str, &end, 10);
+    if (end == str || v > 255)
+      return false;
+    if (i < 5 && *end != '.')
+      return false;
+    if (i == 5 && *end != '\0')
+      return false;
+    obis[i] = (uint8_t) v;
+    str = end + 1;
+  }
+  return true;
+}
+
+ObisString obis_to_string(const uint8_t *obis) {
+  ObisString s;
+  snprintf(s.str, sizeof(s.str), "%u.%u.%u.%u.%u.%u", obis[0], obis[1], obis[2], obis[3], obis[4], obis[5]);
+  return s;
+}
+
+void ObisIndex::reserve(size_t count) {
+  this->keys_.reserve(count);
+  this->sensors_.reserve(count);
+}
+
+void ObisIndex::add(uint64_t key, DlmsCosemSensorBase *sensor) {
+  this->keys_.push_back(key);
+  this->sensors_.push_back(sensor);
+}
+
+void ObisIndex::build() {
+  size_t capacity = 8;
+  while (capacity < this->sensors_.size() * 2)
+    capacity <<= 1;
+
+  this->slots_.assign(capacity, Slot{});
+  this->mask_ = capacity - 1;
+
+  size_t i = 0;
+  while (i < this->keys_.size()) {
+    uint64_t key = this->keys_[i];
+    size_t j = i;
+    while (j < this->keys_.size() && this->keys_[j] == key)
+      j++;
+
+    uint32_t s = this->slot_of_(key);
+    while (this->slots_[s].key != EMPTY_KEY)
+      s = (s + 1) & this->mask_;
+    this->slots_[s] = {key, (uint16_t) i, (uint16_t) (j - i)};
+    i = j;
+  }
+
+  this->keys_.clear();
+  this->keys_.shrink_to_fit();
+}
+
+}  // namespace dlms_cosem
+}  // namespace esphome
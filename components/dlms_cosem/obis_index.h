@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace esphome {
+namespace dlms_cosem {
+
+class DlmsCosemSensorBase;
+
+// 6 OBIS bytes packed big-endian into the low 48 bits
+inline uint64_t obis_pack(const uint8_t *obis) {
+  uint64_t key = 0;
+  for (int i = 0; i < 6; i++)
+    key = (key << 8) | obis[i];
+  return key;
+}
+
+inline void obis_unpack(uint64_t key, uint8_t *obis) {
+  for (int i = 5; i >= 0; i--, key >>= 8)
+    obis[i] = key & 0xFF;
+}
+
+bool obis_parse(const char *str, uint8_t *obis);
+
+// "A.B.C.D.E.F", formatted on demand instead of being stored
+struct ObisString {
+  char str[24];
+  const char *c_str() const { return this->str; }
+};
+ObisString obis_to_string(const uint8_t *obis);
+
+/**
+ * Fixed open-addressing table OBIS -> sensors, built once at setup.
+ * Load factor is kept at or below 1/2, so a miss (the common case for push
+ * objects nobody subscribed to) usually costs a single probe.
+ */
+class ObisIndex {
+ public:
+  struct Range {
+    DlmsCosemSensorBase *const *first{nullptr};
+    DlmsCosemSensorBase *const *last{nullptr};
+    DlmsCosemSensorBase *const *begin() const { return first; }
+    DlmsCosemSensorBase *const *end() const { return last; }
+    bool empty() const { return first == last; }
+  };
+
+  // Sensors with equal keys must be passed adjacently (as iterating the SensorMap gives them)
+  void reserve(size_t count);
+  void add(uint64_t key, DlmsCosemSensorBase *sensor);
+  void build();
+
+  Range find(uint64_t key) const {
+    if (this->mask_ == 0)
+      return {};
+    for (uint32_t i = this->slot_of_(key);; i = (i + 1) & this->mask_) {
+      const Slot &s = this->slots_[i];
+      if (s.key == key)
+        return {&this->sensors_[s.first], &this->sensors_[s.first] + s.count};
+      if (s.key == EMPTY_KEY)
+        return {};
+    }
+  }
+
+  Range find(const uint8_t *obis) const { return this->find(obis_pack(obis)); }
+
+  size_t size() const { return this->sensors_.size(); }
+
+ protected:
+  static constexpr uint64_t EMPTY_KEY = UINT64_MAX;
+
+  struct Slot {
+    uint64_t key{EMPTY_KEY};
+    uint16_t first{0};
+    uint16_t count{0};
+  };
+
+  uint32_t slot_of_(uint64_t key) const { return (uint32_t) ((key * 0x9E3779B97F4A7C15ULL) >> 32) & this->mask_; }
+
+  std::vector<uint64_t> keys_{};
+  std::vector<DlmsCosemSensorBase *> sensors_{};
+  std::vector<Slot> slots_{};
+  uint32_t mask_{0};
+};
+
+}  // namespace dlms_cosem
+}  // namespace esphome
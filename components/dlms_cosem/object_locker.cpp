@@ -3,7 +3,7 @@
 namespace esphome {
 namespace dlms_cosem {
 
-std::vector<void *> AnyObjectLocker::locked_objects_(5);
+std::vector<const void *> AnyObjectLocker::locked_objects_(5);
 Mutex AnyObjectLocker::lock_;
 
 };  // namespace dlms_cosem
@@ -9,7 +9,7 @@ namespace dlms_cosem {
 
 class AnyObjectLocker {
  public:
-  static bool try_lock(void *obj) {
+  static bool try_lock(const void *obj) {
     if (!lock_.try_lock()) {
       return false;
     }
@@ -22,13 +22,13 @@ class AnyObjectLocker {
     return result;
   }
 
-  static void unlock(void *obj) {
+  static void unlock(const void *obj) {
     LockGuard lock{lock_};
     locked_objects_.erase(std::remove(locked_objects_.begin(), locked_objects_.end(), obj), locked_objects_.end());
   }
 
  private:
-  static std::vector<void *> locked_objects_;
+  static std::vector<const void *> locked_objects_;
   static Mutex lock_;
 };
 };  // namespace dlms_cosem
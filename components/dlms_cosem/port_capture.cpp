@@ -0,0 +1,155 @@
+#include "port_capture.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace esphome {
+namespace dlms_cosem {
+
+CapturePort::CapturePort(std::unique_ptr<DlmsCosemPort> port, size_t size)
+    : port_(std::move(port)), buf_(new uint8_t[size]), capacity_(size) {}
+
+bool CapturePort::read_byte(uint8_t *data) {
+  if (!this->port_->read_byte(data))
+    return false;
+  this->record_(CAPTURE_RX, data, 1);
+  return true;
+}
+
+bool CapturePort::read_array(uint8_t *data, size_t len) {
+  if (!this->port_->read_array(data, len))
+    return false;
+  this->record_(CAPTURE_RX, data, len);
+  return true;
+}
+
+void CapturePort::write_array(const uint8_t *data, size_t len) {
+  this->port_->write_array(data, len);
+  this->record_(CAPTURE_TX, data, len);
+}
+
+void CapturePort::restart() {
+  this->used_ = 0;
+  this->dropped_ = 0;
+  this->chunk_ = SIZE_MAX;
+  this->last_ms_ = millis();
+  this->last_byte_ms_ = this->last_ms_;
+}
+
+void CapturePort::record_(uint8_t direction, const uint8_t *data, size_t len) {
+  const uint32_t now = millis();
+  while (len > 0) {
+    uint8_t *hdr = this->chunk_ != SIZE_MAX ? this->buf_.get() + this->chunk_ : nullptr;
+    if (hdr == nullptr || hdr[2] != direction || hdr[3] == UINT8_MAX || now - this->last_byte_ms_ > CHUNK_GAP_MS) {
+      if (this->used_ + CAPTURE_HEADER_SIZE + 1 > this->capacity_) {
+        this->dropped_ += len;
+        return;
+      }
+      uint32_t dt = now - this->last_ms_;
+      if (dt > UINT16_MAX)
+        dt = UINT16_MAX;
+      hdr = this->buf_.get() + this->used_;
+      hdr[0] = dt;
+      hdr[1] = dt >> 8;
+      hdr[2] = direction;
+      hdr[3] = 0;
+      this->chunk_ = this->used_;
+      this->used_ += CAPTURE_HEADER_SIZE;
+      this->last_ms_ = now;
+    }
+    size_t n = std::min<size_t>({len, (size_t) (UINT8_MAX - hdr[3]), this->capacity_ - this->used_});
+    if (n == 0) {
+      this->dropped_ += len;
+      return;
+    }
+    memcpy(this->buf_.get() + this->used_, data, n);
+    hdr[3] += n;
+    this->used_ += n;
+    data += n;
+    len -= n;
+  }
+  this->last_byte_ms_ = now;
+}
+
+void CapturePort::dump(const char *tag) const {
+  static const char HEX_CHARS[] = "0123456789abcdef";
+  static constexpr size_t PER_LINE = 64;
+
+  ESP_LOGI(tag, "CAPTURE v1 bytes=%u dropped=%u", (unsigned) this->used_, (unsigned) this->dropped_);
+  char line[PER_LINE * 2 + 1];
+  for (size_t off = 0; off < this->used_; off += PER_LINE) {
+    size_t n = std::min(PER_LINE, this->used_ - off);
+    for (size_t i = 0; i < n; i++) {
+      line[i * 2] = HEX_CHARS[this->buf_[off + i] >> 4];
+      line[i * 2 + 1] = HEX_CHARS[this->buf_[off + i] & 0x0F];
+    }
+    line[n * 2] = '\0';
+    ESP_LOGI(tag, "CAPTURE:%s", line);
+  }
+}
+
+#ifdef USE_HOST
+void ReplayPort::advance_() {
+  const uint32_t now = millis();
+  if (!this->started_) {
+    this->started_ = true;
+    this->last_ms_ = now;
+  }
+  if (this->rx_pos_ == this->rx_.size()) {
+    this->rx_.clear();
+    this->rx_pos_ = 0;
+  }
+  while (this->tx_left_ == 0 && this->pos_ + CAPTURE_HEADER_SIZE <= this->capture_.size()) {
+    const uint8_t *hdr = this->capture_.data() + this->pos_;
+    uint16_t dt = hdr[0] | (hdr[1] << 8);
+    size_t len = std::min<size_t>(hdr[3], this->capture_.size() - this->pos_ - CAPTURE_HEADER_SIZE);
+    if (hdr[2] == CAPTURE_TX) {
+      // released by the component writing it
+      this->tx_left_ = len;
+      this->pos_ += CAPTURE_HEADER_SIZE;
+      if (len == 0)
+        continue;
+      return;
+    }
+    if (now - this->last_ms_ < dt)
+      return;
+    this->rx_.insert(this->rx_.end(), hdr + CAPTURE_HEADER_SIZE, hdr + CAPTURE_HEADER_SIZE + len);
+    this->pos_ += CAPTURE_HEADER_SIZE + len;
+    this->last_ms_ = now;
+  }
+}
+
+int ReplayPort::available() {
+  this->advance_();
+  return this->rx_.size() - this->rx_pos_;
+}
+
+bool ReplayPort::read_array(uint8_t *data, size_t len) {
+  this->advance_();
+  if (this->rx_.size() - this->rx_pos_ < len)
+    return false;
+  memcpy(data, this->rx_.data() + this->rx_pos_, len);
+  this->rx_pos_ += len;
+  return true;
+}
+
+void ReplayPort::write_array(const uint8_t *data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    this->advance_();
+    if (this->tx_left_ == 0) {
+      this->tx_mismatches_ += len - i;  // nothing recorded to compare with
+      return;
+    }
+    if (this->capture_[this->pos_] != data[i])
+      this->tx_mismatches_++;
+    this->pos_++;
+    if (--this->tx_left_ == 0)
+      this->last_ms_ = millis();
+  }
+}
+#endif
+
+}  // namespace dlms_cosem
+}  // namespace esphome
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "dlms_cosem_port.h"
+
+namespace esphome {
+namespace dlms_cosem {
+
+/**
+ * Capture format: a sequence of chunks, each a 4-byte header followed by the data bytes:
+ *   dt_ms (u16 little endian, since the start of the previous chunk, saturating), direction (u8, 0 = RX,
+ *   1 = TX), length (u8).
+ * Bytes in the same direction go into one chunk as long as they follow each other within CHUNK_GAP_MS,
+ * so timing is kept per burst, not per byte.
+ */
+static constexpr uint8_t CAPTURE_RX = 0;
+static constexpr uint8_t CAPTURE_TX = 1;
+static constexpr size_t CAPTURE_HEADER_SIZE = 4;
+static constexpr uint32_t CHUNK_GAP_MS = 20;
+
+// Records everything passing through another port into a fixed buffer
+class CapturePort final : public DlmsCosemPort {
+ public:
+  CapturePort(std::unique_ptr<DlmsCosemPort> port, size_t size);
+
+  int available() override { return this->port_->available(); }
+  bool read_byte(uint8_t *data) override;
+  bool read_array(uint8_t *data, size_t len) override;
+  void write_array(const uint8_t *data, size_t len) override;
+  void set_baud_rate(uint32_t baud_rate) override { this->port_->set_baud_rate(baud_rate); }
+  const void *bus_id() const override { return this->port_->bus_id(); }
+
+  // drops what was captured so far; called at the start of every session
+  void restart();
+  // bytes_dropped > 0 means the buffer filled up and the end of the session is missing
+  size_t size() const { return this->used_; }
+  size_t bytes_dropped() const { return this->dropped_; }
+  void dump(const char *tag) const;
+
+ protected:
+  void record_(uint8_t direction, const uint8_t *data, size_t len);
+
+  std::unique_ptr<DlmsCosemPort> port_;
+  std::unique_ptr<uint8_t[]> buf_;
+  size_t capacity_;
+  size_t used_{0};
+  size_t dropped_{0};
+  size_t chunk_{SIZE_MAX};  // header offset of the chunk being extended
+  uint32_t last_ms_{0};       // start of the last chunk
+  uint32_t last_byte_ms_{0};  // last byte recorded
+};
+
+#ifdef USE_HOST
+/**
+ * Plays a capture back to the component: RX chunks become readable with their recorded delays,
+ * each one only after all TX chunks before it were written. Written bytes are compared with the
+ * recorded TX data.
+ */
+class ReplayPort final : public DlmsCosemPort {
+ public:
+  explicit ReplayPort(std::vector<uint8_t> capture) : capture_(std::move(capture)) {}
+
+  int available() override;
+  bool read_byte(uint8_t *data) override { return this->read_array(data, 1); }
+  bool read_array(uint8_t *data, size_t len) override;
+  void write_array(const uint8_t *data, size_t len) override;
+  void set_baud_rate(uint32_t baud_rate) override {}
+
+  bool finished() const { return this->pos_ >= this->capture_.size() && this->rx_pos_ == this->rx_.size(); }
+  size_t tx_mismatches() const { return this->tx_mismatches_; }
+
+ protected:
+  void advance_();
+
+  std::vector<uint8_t> capture_;
+  size_t pos_{0};          // next chunk header
+  size_t tx_left_{0};      // bytes of the current TX chunk still expected
+  uint32_t last_ms_{0};    // when the previous chunk was released
+  bool started_{false};
+  std::vector<uint8_t> rx_;
+  size_t rx_pos_{0};
+  size_t tx_mismatches_{0};
+};
+#endif
+
+}  // namespace dlms_cosem
+}  // namespace esphome
@@ -0,0 +1,319 @@
+#ifdef ENABLE_DLMS_COSEM_PUSH_MODE
+
+#include "push_assembler.h"
+#include "esphome/core/log.h"
+#include <cstring>
+
+namespace esphome {
+namespace dlms_cosem {
+
+constexpr const char *TAG = "dlms_cosem.push";
+
+static constexpr uint8_t HDLC_FLAG = 0x7E;
+static constexpr uint8_t HDLC_FORMAT_TYPE_3 = 0xA0;
+static constexpr uint8_t HDLC_SEGMENTED = 0x08;
+static constexpr uint8_t GBT_TAG = 0xE0;
+static constexpr uint8_t GBT_LAST_BLOCK = 0x80;
+static constexpr size_t GBT_HEADER_SIZE = 6;  // tag, block-control, block-number, block-number-ack
+
+// FCS-16 (CRC-16/X-25) as used for HDLC HCS and FCS
+static uint16_t hdlc_fcs16(const uint8_t *p, size_t len) {
+  uint16_t fcs = 0xFFFF;
+  while (len--) {
+    fcs ^= *p++;
+    for (int i = 0; i < 8; i++)
+      fcs = (fcs & 1) ? (fcs >> 1) ^ 0x8408 : (fcs >> 1);
+  }
+  return ~fcs;
+}
+
+static bool hdlc_check(const uint8_t *p, size_t len) {
+  uint16_t fcs = hdlc_fcs16(p, len);
+  return p[len] == (fcs & 0xFF) && p[len + 1] == (fcs >> 8);
+}
+
+// A-XDR length: one byte, or 0x81/0x82 followed by 1/2 length bytes
+static bool read_axdr_length(const uint8_t *data, size_t &pos, size_t end, size_t &len) {
+  if (pos >= end)
+    return false;
+  uint8_t b = data[pos++];
+  if (b < 0x80) {
+    len = b;
+    return true;
+  }
+  uint8_t n = b & 0x7F;
+  if (n == 0 || n > 2 || pos + n > end)
+    return false;
+  len = 0;
+  while (n--)
+    len = (len << 8) | data[pos++];
+  return true;
+}
+
+void PushFrameAssembler::reset() {
+  this->mode_ = Mode::UNKNOWN;
+  this->raw_pos_ = 0;
+  this->out_pos_ = 0;
+  this->telegram_active_ = false;
+  this->telegram_bad_ = false;
+  this->telegram_start_ = 0;
+  this->telegram_segments_ = 0;
+  this->expected_ns_ = 0;
+  this->gbt_active_ = false;
+  this->gbt_start_ = 0;
+  this->gbt_next_block_ = 0;
+}
+
+void PushFrameAssembler::feed(gxByteBuffer *buf) {
+  uint8_t *data = buf->data;
+  const size_t size = buf->size;
+
+  if (this->mode_ == Mode::UNKNOWN && size > 0) {
+    this->mode_ = data[0] == HDLC_FLAG ? Mode::HDLC : Mode::RAW;
+    ESP_LOGV(TAG, "Push framing: %s", this->mode_ == Mode::HDLC ? "HDLC" : "raw");
+  }
+  if (this->mode_ != Mode::HDLC)
+    return;
+
+  size_t r = this->raw_pos_;
+  while (r < size) {
+    if (data[r] != HDLC_FLAG || (r + 1 < size && data[r + 1] == HDLC_FLAG)) {
+      r++;  // inter-frame garbage or a doubled flag
+      continue;
+    }
+    if (r + 3 > size)
+      break;  // wait for the frame format field
+
+    uint8_t f0 = data[r + 1];
+    if ((f0 & 0xF0) != HDLC_FORMAT_TYPE_3) {
+      r++;
+      continue;
+    }
+    size_t flen = ((f0 & 0x07) << 8) | data[r + 2];
+    if (r + flen + 2 > size)
+      break;  // wait for the rest of the frame
+
+    if (flen < 7 || data[r + flen + 1] != HDLC_FLAG) {
+      ESP_LOGV(TAG, "Invalid HDLC frame at %u", (unsigned) r);
+      this->telegram_bad_ = this->telegram_active_;
+      r++;
+      continue;
+    }
+
+    const uint8_t *f = data + r + 1;
+    bool segmented = f0 & HDLC_SEGMENTED;
+    this->stats_.frames++;
+
+    // format (2), destination and source addresses (LSB marks the last byte), control
+    size_t hdr = 2;
+    while (hdr < flen && !(f[hdr] & 1))
+      hdr++;
+    hdr++;
+    while (hdr < flen && !(f[hdr] & 1))
+      hdr++;
+    hdr++;
+    uint8_t control = hdr < flen ? f[hdr] : 0;
+    hdr++;
+
+    if (!this->telegram_active_) {
+      this->telegram_active_ = true;
+      this->telegram_bad_ = false;
+      this->telegram_start_ = this->out_pos_;
+      this->telegram_segments_ = 0;
+    }
+
+    size_t info_from = 0;
+    size_t info_len = 0;
+    if (hdr + 2 > flen) {
+      this->telegram_bad_ = true;
+    } else if (!hdlc_check(f, flen - 2)) {
+      ESP_LOGV(TAG, "HDLC FCS error");
+      this->stats_.fcs_errors++;
+      this->telegram_bad_ = true;
+    } else if (flen > hdr + 2) {
+      if (!hdlc_check(f, hdr)) {
+        ESP_LOGV(TAG, "HDLC HCS error");
+        this->stats_.hcs_errors++;
+        this->telegram_bad_ = true;
+      }
+      info_from = hdr + 2;
+      info_len = flen - hdr - 4;
+    }
+
+    // I-frames carry N(S); segments of one telegram must come in order
+    if (!(control & 0x01)) {
+      uint8_t ns = (control >> 1) & 0x07;
+      if (this->telegram_segments_ > 0 && ns != this->expected_ns_) {
+        ESP_LOGV(TAG, "HDLC segment out of sequence: N(S)=%u, expected %u", ns, this->expected_ns_);
+        this->stats_.sequence_errors++;
+        this->telegram_bad_ = true;
+      }
+      this->expected_ns_ = (ns + 1) & 0x07;
+    }
+
+    // LLC header only comes with the first segment
+    if (this->telegram_segments_ == 0 && info_len >= 3 && f[info_from] == 0xE6 &&
+        (f[info_from + 1] == 0xE7 || f[info_from + 1] == 0xE6) && f[info_from + 2] == 0x00) {
+      info_from += 3;
+      info_len -= 3;
+    }
+
+    if (!this->telegram_bad_ && info_len > 0) {
+      memmove(data + this->out_pos_, f + info_from, info_len);
+      this->out_pos_ += info_len;
+    }
+
+    this->telegram_segments_++;
+    r += flen + 1;  // closing flag may open the next frame
+    if (!segmented)
+      this->complete_telegram_(data);
+  }
+
+  // keep the unprocessed tail right behind the produced APDU bytes
+  size_t tail = size - r;
+  if (tail > 0 && r != this->out_pos_)
+    memmove(data + this->out_pos_, data + r, tail);
+  this->raw_pos_ = this->out_pos_;
+  buf->size = this->out_pos_ + tail;
+}
+
+void PushFrameAssembler::finish(gxByteBuffer *buf) {
+  if (this->mode_ == Mode::RAW) {
+    if (buf->size > 0 && buf->data[0] == GBT_TAG) {
+      this->out_pos_ = this->unwrap_gbt_(buf->data, 0, buf->size, 0);
+    } else {
+      this->out_pos_ = this->apdu_complete_(buf->data, 0, buf->size);
+    }
+  } else if (this->mode_ == Mode::HDLC && buf->size > this->raw_pos_ + 1) {  // a lone closing flag is fine
+    ESP_LOGV(TAG, "Discarding %u bytes of incomplete HDLC frame", (unsigned) (buf->size - this->raw_pos_));
+  }
+
+  if (this->telegram_active_) {
+    this->drop_telegram_();
+  }
+  if (this->gbt_active_) {
+    ESP_LOGV(TAG, "General-block-transfer incomplete, waiting for block %u", this->gbt_next_block_);
+    this->stats_.block_errors++;
+    this->stats_.telegrams_dropped++;
+    this->out_pos_ = this->gbt_start_;
+    this->gbt_active_ = false;
+  }
+
+  buf->size = this->out_pos_;
+  buf->position = 0;
+  this->raw_pos_ = this->out_pos_;
+}
+
+void PushFrameAssembler::complete_telegram_(uint8_t *data) {
+  if (this->telegram_bad_) {
+    this->drop_telegram_();
+    return;
+  }
+  this->telegram_active_ = false;
+  size_t start = this->telegram_start_;
+  if (start < this->out_pos_ && (data[start] == GBT_TAG || this->gbt_active_)) {
+    this->out_pos_ = this->unwrap_gbt_(data, start, this->out_pos_, start);
+  } else if (start < this->out_pos_) {
+    this->out_pos_ = this->apdu_complete_(data, start, this->out_pos_);
+  }
+}
+
+void PushFrameAssembler::drop_telegram_() {
+  ESP_LOGW(TAG, "Dropping damaged push telegram");
+  this->stats_.telegrams_dropped++;
+  this->out_pos_ = this->telegram_start_;
+  this->telegram_active_ = false;
+  this->telegram_bad_ = false;
+}
+
+size_t PushFrameAssembler::unwrap_gbt_(uint8_t *data, size_t from, size_t to, size_t out) {
+  size_t r = from;
+  while (r < to) {
+    if (data[r] != GBT_TAG) {
+      // plain APDU: an unfinished block transfer before it is lost
+      if (this->gbt_active_) {
+        ESP_LOGV(TAG, "General-block-transfer interrupted before block %u", this->gbt_next_block_);
+        this->stats_.block_errors++;
+        this->stats_.telegrams_dropped++;
+        out = this->gbt_start_;
+        this->gbt_active_ = false;
+      }
+      memmove(data + out, data + r, to - r);
+      return this->apdu_complete_(data, out, out + (to - r));
+    }
+
+    size_t len = 0;
+    size_t pos = r + GBT_HEADER_SIZE;
+    if (r + GBT_HEADER_SIZE > to || !read_axdr_length(data, pos, to, len) || pos + len > to) {
+      ESP_LOGV(TAG, "Truncated general-block-transfer block");
+      this->stats_.block_errors++;
+      if (this->gbt_active_) {
+        this->stats_.telegrams_dropped++;
+        out = this->gbt_start_;
+        this->gbt_active_ = false;
+      }
+      return out;
+    }
+
+    uint8_t control = data[r + 1];
+    uint16_t number = (data[r + 2] << 8) | data[r + 3];
+    this->stats_.blocks++;
+
+    if (!this->gbt_active_ && number == 1) {
+      this->gbt_active_ = true;
+      this->gbt_start_ = out;
+      this->gbt_next_block_ = 1;
+    }
+    if (!this->gbt_active_ || number != this->gbt_next_block_) {
+      // out of order or missing block: discard this transfer up to its last block
+      ESP_LOGV(TAG, "General-block-transfer block %u unexpected (next %u)", number, this->gbt_next_block_);
+      this->stats_.block_errors++;
+      if (this->gbt_active_) {
+        this->stats_.telegrams_dropped++;
+        out = this->gbt_start_;
+        this->gbt_active_ = false;
+      }
+      r = pos + len;
+      continue;
+    }
+
+    memmove(data + out, data + pos, len);
+    out += len;
+    r = pos + len;
+    this->gbt_next_block_++;
+
+    if (control & GBT_LAST_BLOCK) {
+      this->gbt_active_ = false;
+      out = this->apdu_complete_(data, this->gbt_start_, out);
+    }
+  }
+  return out;
+}
+
+size_t PushFrameAssembler::apdu_complete_(uint8_t *data, size_t start, size_t end) {
+  if (start == end)
+    return start;
+  if (DlmsCipher::is_ciphered(data + start, end - start)) {
+    if (this->cipher_ == nullptr || !this->cipher_->has_key()) {
+      ESP_LOGW(TAG, "Ciphered push APDU received, but no decryption_key is configured");
+      this->stats_.decrypt_errors++;
+      this->stats_.telegrams_dropped++;
+      return start;
+    }
+    size_t plain_len = 0;
+    if (this->cipher_->decrypt_in_place(data + start, end - start, plain_len) != DlmsCipher::Result::OK) {
+      this->stats_.decrypt_errors++;
+      this->stats_.telegrams_dropped++;
+      return start;
+    }
+    this->stats_.decrypted++;
+    end = start + plain_len;
+  }
+  this->stats_.telegrams++;
+  return end;
+}
+
+}  // namespace dlms_cosem
+}  // namespace esphome
+
+#endif  // ENABLE_DLMS_COSEM_PUSH_MODE
@@ -0,0 +1,84 @@
+#pragma once
+#ifdef ENABLE_DLMS_COSEM_PUSH_MODE
+
+#include <cstddef>
+#include <cstdint>
+
+#include <dlmssettings.h>
+
+#include "dlms_cipher.h"
+
+namespace esphome {
+namespace dlms_cosem {
+
+/**
+ * Turns raw push bytes into contiguous APDUs, in place inside the receive buffer.
+ *
+ * HDLC input (first byte is the 0x7E flag): every frame gets its HCS/FCS checked, headers, FCS and
+ * the LLC header are stripped and segments (S bit in the frame format field) are concatenated.
+ * General-block-transfer APDUs (tag 0xE0) are then merged into the APDU they carry.
+ * A telegram with a bad checksum, a sequence gap or a missing block is dropped on its own;
+ * telegrams around it in the same reception are kept.
+ *
+ * Input without HDLC framing is passed through, except for general-block-transfer unwrapping.
+ * With a cipher set, every complete general-glo-ciphering APDU is decrypted in place; general-ded-ciphering
+ * ones are dropped, see DlmsCipher.
+ *
+ * feed() may be called as bytes keep arriving: it consumes all complete frames and leaves only
+ * the incomplete tail as raw bytes, so the buffer holds APDU payload plus at most one raw frame.
+ */
+class PushFrameAssembler {
+ public:
+  struct Stats {
+    uint32_t frames{0};
+    uint32_t hcs_errors{0};
+    uint32_t fcs_errors{0};
+    uint32_t sequence_errors{0};
+    uint32_t blocks{0};
+    uint32_t block_errors{0};
+    uint32_t telegrams{0};
+    uint32_t telegrams_dropped{0};
+    uint32_t decrypted{0};
+    uint32_t decrypt_errors{0};
+  };
+
+  void set_cipher(DlmsCipher *cipher) { this->cipher_ = cipher; }
+
+  void reset();
+  void feed(gxByteBuffer *buf);
+  // end of reception: drops whatever is incomplete, leaves only complete APDUs in buf
+  void finish(gxByteBuffer *buf);
+
+  const Stats &stats() const { return this->stats_; }
+
+ protected:
+  enum class Mode : uint8_t { UNKNOWN, HDLC, RAW };
+
+  void complete_telegram_(uint8_t *data);
+  void drop_telegram_();
+  size_t unwrap_gbt_(uint8_t *data, size_t from, size_t to, size_t out);
+  size_t apdu_complete_(uint8_t *data, size_t start, size_t end);
+
+  DlmsCipher *cipher_{nullptr};
+
+  Mode mode_{Mode::UNKNOWN};
+  size_t raw_pos_{0};  // start of not yet processed raw bytes
+  size_t out_pos_{0};  // end of produced APDU bytes
+
+  bool telegram_active_{false};
+  bool telegram_bad_{false};
+  size_t telegram_start_{0};
+  uint8_t telegram_segments_{0};
+  uint8_t expected_ns_{0};
+
+  bool gbt_active_{false};
+  size_t gbt_start_{0};
+  uint16_t gbt_next_block_{0};
+
+  Stats stats_{};
+};
+
+}  // namespace dlms_cosem
+}  // namespace esphome
+
+#endif  // ENABLE_DLMS_COSEM_PUSH_MODE
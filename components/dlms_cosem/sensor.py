@@ -1,41 +1,161 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
+import esphome.final_validate as fv
 from esphome.components import sensor
+from esphome.const import CONF_ABOVE, CONF_BELOW, CONF_DURATION, CONF_PLATFORM
 from . import (
     DlmsCosem,
     dlms_cosem_ns,
     obis_code,
+    obis_bytes,
     CONF_DLMS_COSEM_ID,
     CONF_OBIS_CODE,
     CONF_DONT_PUBLISH,
     CONF_OBIS_CLASS,
+    CONF_PUBLISH_ON_CHANGE,
+    CONF_MAX_SILENCE,
 )
 
 DlmsCosemSensor = dlms_cosem_ns.class_("DlmsCosemSensor", sensor.Sensor)
+DiagnosticSensorType = dlms_cosem_ns.enum("DiagnosticSensorType", is_class=True)
 
 CONF_MULTIPLIER = "multiplier"
+CONF_DEADBAND = "deadband"
+CONF_DEADBAND_PERCENT = "deadband_percent"
+CONF_DIAGNOSTIC = "diagnostic"
+CONF_FAST_POLL = "fast_poll"
+CONF_RATE = "rate"
+CONF_OBIS_CODES = "obis_codes"
 
-CONFIG_SCHEMA = cv.All(
-    sensor.sensor_schema(
-        DlmsCosemSensor,
-    ).extend(
+DIAGNOSTIC_TYPES = {
+    "session_time": DiagnosticSensorType.SESSION_TIME,
+    "loop_time_max": DiagnosticSensorType.LOOP_TIME_MAX,
+    "bus_utilization": DiagnosticSensorType.BUS_UTILIZATION,
+    "bus_idle": DiagnosticSensorType.BUS_IDLE,
+    "bus_tx": DiagnosticSensorType.BUS_TX,
+    "bus_rx": DiagnosticSensorType.BUS_RX,
+    "bus_turnaround": DiagnosticSensorType.BUS_TURNAROUND,
+    "bus_contention": DiagnosticSensorType.BUS_CONTENTION,
+    "bus_max_poll_rate": DiagnosticSensorType.BUS_MAX_POLL_RATE,
+    "rx_buffer_peak": DiagnosticSensorType.RX_BUFFER_PEAK,
+    "tx_buffer_peak": DiagnosticSensorType.TX_BUFFER_PEAK,
+}
+
+FAST_POLL_SCHEMA = cv.All(
+    cv.Schema(
         {
-            cv.GenerateID(CONF_DLMS_COSEM_ID): cv.use_id(DlmsCosem),
-            cv.Required(CONF_OBIS_CODE): obis_code,
-            cv.Optional(CONF_DONT_PUBLISH, default=False): cv.boolean,
-            cv.Optional(CONF_MULTIPLIER, default=1.0): cv.float_,
-            cv.Optional(CONF_OBIS_CLASS, default=3): cv.int_,
+            cv.Optional(CONF_ABOVE): cv.float_,
+            cv.Optional(CONF_BELOW): cv.float_,
+            cv.Optional(CONF_RATE): cv.positive_float,
+            cv.Optional(
+                CONF_DURATION, default="60s"
+            ): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_OBIS_CODES): cv.ensure_list(obis_code),
         }
     ),
-    cv.has_exactly_one_key(CONF_OBIS_CODE),
+    cv.has_at_least_one_key(CONF_ABOVE, CONF_BELOW, CONF_RATE),
+)
+
+OBIS_SENSOR_SCHEMA = sensor.sensor_schema(
+    DlmsCosemSensor,
+).extend(
+    {
+        cv.GenerateID(CONF_DLMS_COSEM_ID): cv.use_id(DlmsCosem),
+        cv.Required(CONF_OBIS_CODE): obis_code,
+        cv.Optional(CONF_DONT_PUBLISH, default=False): cv.boolean,
+        cv.Optional(CONF_MULTIPLIER, default=1.0): cv.float_,
+        cv.Optional(CONF_OBIS_CLASS, default=3): cv.int_,
+        cv.Optional(CONF_PUBLISH_ON_CHANGE, default=False): cv.boolean,
+        cv.Optional(CONF_DEADBAND): cv.positive_float,
+        cv.Optional(CONF_DEADBAND_PERCENT): cv.percentage,
+        cv.Optional(CONF_MAX_SILENCE): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_FAST_POLL): FAST_POLL_SCHEMA,
+    }
+)
+
+# hub figures: a plain sensor, none of the OBIS options apply
+DIAGNOSTIC_SENSOR_SCHEMA = sensor.sensor_schema(
+    sensor.Sensor,
+).extend(
+    {
+        cv.GenerateID(CONF_DLMS_COSEM_ID): cv.use_id(DlmsCosem),
+        cv.Required(CONF_DIAGNOSTIC): cv.enum(DIAGNOSTIC_TYPES, lower=True),
+    }
 )
 
 
+def _obis_or_diagnostic(config):
+    if not isinstance(config, dict) or CONF_DIAGNOSTIC not in config:
+        return OBIS_SENSOR_SCHEMA(config)
+    if CONF_OBIS_CODE in config:
+        raise cv.Invalid(
+            f"Set either {CONF_OBIS_CODE} or {CONF_DIAGNOSTIC}, not both",
+            path=[CONF_DIAGNOSTIC],
+        )
+    return DIAGNOSTIC_SENSOR_SCHEMA(config)
+
+
+CONFIG_SCHEMA = _obis_or_diagnostic
+
+
+def _validate_fast_poll_targets(config):
+    # a target nobody reads would never be polled faster
+    fast_poll = config.get(CONF_FAST_POLL)
+    if not fast_poll or CONF_OBIS_CODES not in fast_poll:
+        return config
+    hub = str(config[CONF_DLMS_COSEM_ID])
+    read = set()
+    for domain in ("sensor", "text_sensor"):
+        for conf in fv.full_config.get().get(domain, []):
+            if (
+                conf.get(CONF_PLATFORM) == "dlms_cosem"
+                and str(conf.get(CONF_DLMS_COSEM_ID)) == hub
+                and CONF_OBIS_CODE in conf
+            ):
+                read.add(conf[CONF_OBIS_CODE])
+    for index, code in enumerate(fast_poll[CONF_OBIS_CODES]):
+        if code not in read:
+            raise cv.Invalid(
+                f"No dlms_cosem sensor or text sensor of this hub reads {code}",
+                path=[CONF_FAST_POLL, CONF_OBIS_CODES, index],
+            )
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = _validate_fast_poll_targets
+
+
 async def to_code(config):
     component = await cg.get_variable(config[CONF_DLMS_COSEM_ID])
     var = await sensor.new_sensor(config)
-    cg.add(var.set_obis_code(config[CONF_OBIS_CODE]))
+    if diagnostic := config.get(CONF_DIAGNOSTIC):
+        cg.add(component.set_diagnostic_sensor(diagnostic, var))
+        return
+
+    cg.add(var.set_obis_code(*obis_bytes(config[CONF_OBIS_CODE])))
     cg.add(var.set_dont_publish(config.get(CONF_DONT_PUBLISH)))
     cg.add(var.set_multiplier(config[CONF_MULTIPLIER]))
     cg.add(var.set_obis_class(config[CONF_OBIS_CLASS]))
+
+    on_change = config[CONF_PUBLISH_ON_CHANGE]
+    if (deadband := config.get(CONF_DEADBAND)) is not None:
+        cg.add(var.set_deadband(deadband))
+        on_change = True
+    if (deadband_percent := config.get(CONF_DEADBAND_PERCENT)) is not None:
+        cg.add(var.set_deadband_percent(deadband_percent * 100.0))
+        on_change = True
+    cg.add(var.set_publish_on_change(on_change))
+    if max_silence := config.get(CONF_MAX_SILENCE):
+        cg.add(var.set_max_silence_ms(max_silence))
+    if fast_poll := config.get(CONF_FAST_POLL):
+        cg.add(
+            var.set_fast_poll(
+                fast_poll.get(CONF_ABOVE, float("nan")),
+                fast_poll.get(CONF_BELOW, float("nan")),
+                fast_poll.get(CONF_RATE, float("nan")),
+                fast_poll[CONF_DURATION],
+            )
+        )
+        for code in fast_poll.get(CONF_OBIS_CODES, [config[CONF_OBIS_CODE]]):
+            cg.add(var.add_fast_poll_target(*obis_bytes(code)))
     cg.add(component.register_sensor(var))
@@ -0,0 +1,134 @@
+#pragma once
+
+#ifdef ENABLE_DLMS_COSEM_COROUTINES
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace esphome {
+namespace dlms_cosem {
+
+/**
+ * Storage for the frame of one session script.
+ *
+ * The compiler decides how big a coroutine frame is, so the size is only known when the frame is
+ * allocated. A request that does not fit (or comes while the frame is in use) gets nullptr, and the
+ * coroutine returns an empty SessionTask instead of touching the heap. last_request() tells how much
+ * was asked for, to size SIZE.
+ *
+ * The frame is allocated by the plain operator new of the promise, which can't see the owner: the pool
+ * is made current by a Scope around the call of the coroutine, see start_session_script().
+ */
+class CoroutineFramePool {
+ public:
+  static constexpr size_t SIZE = 384;  // the session script takes 256 on x86-64
+
+  void *allocate(size_t size) noexcept {
+    this->last_request_ = size;
+    if (this->busy_ || size > capacity())
+      return nullptr;
+    this->busy_ = true;
+    *reinterpret_cast<CoroutineFramePool **>(this->storage_) = this;
+    return this->storage_ + HEADER;
+  }
+  // frames only come from allocate(), the pool is right before the frame
+  static void release(void *frame) noexcept {
+    auto *pool = *reinterpret_cast<CoroutineFramePool **>(static_cast<uint8_t *>(frame) - HEADER);
+    pool->busy_ = false;
+  }
+
+  static constexpr size_t capacity() { return SIZE - HEADER; }
+  bool busy() const { return this->busy_; }
+  size_t last_request() const { return this->last_request_; }
+
+  // frames allocated while a Scope lives come from its pool
+  class Scope {
+   public:
+    explicit Scope(CoroutineFramePool &pool) : previous_(std::exchange(current_, &pool)) {}
+    ~Scope() { current_ = this->previous_; }
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+   protected:
+    CoroutineFramePool *previous_;
+  };
+  static void *allocate_current(size_t size) noexcept {
+    return current_ != nullptr ? current_->allocate(size) : nullptr;
+  }
+
+ protected:
+  static inline CoroutineFramePool *current_{nullptr};
+  static constexpr size_t HEADER = alignof(std::max_align_t);
+  alignas(std::max_align_t) uint8_t storage_[SIZE];
+  size_t last_request_{0};
+  bool busy_{false};
+};
+
+/**
+ * A session script: a coroutine returning SessionTask, started with start_session_script().
+ *
+ * It starts suspended, the owner resume()s it whenever what it co_awaits is done, and destroys it
+ * when it is done() or abandoned. An empty task (false) means the frame did not fit the pool.
+ */
+class SessionTask {
+ public:
+  struct promise_type {
+    static void *operator new(size_t size) noexcept { return CoroutineFramePool::allocate_current(size); }
+    static void operator delete(void *frame) noexcept { CoroutineFramePool::release(frame); }
+    static SessionTask get_return_object_on_allocation_failure() noexcept { return {}; }
+
+    SessionTask get_return_object() noexcept {
+      return SessionTask(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() noexcept {}
+    void unhandled_exception() noexcept {}  // the devices build without exceptions
+  };
+
+  SessionTask() = default;
+  SessionTask(SessionTask &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+  SessionTask &operator=(SessionTask &&other) noexcept {
+    if (this != &other) {
+      this->reset();
+      this->handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+  SessionTask(const SessionTask &) = delete;
+  SessionTask &operator=(const SessionTask &) = delete;
+  ~SessionTask() { this->reset(); }
+
+  explicit operator bool() const { return static_cast<bool>(this->handle_); }
+  bool done() const { return !this->handle_ || this->handle_.done(); }
+
+  // runs the script up to its next co_await; true once it has finished
+  bool resume() {
+    if (!this->done())
+      this->handle_.resume();
+    return this->done();
+  }
+
+  void reset() {
+    if (this->handle_)
+      this->handle_.destroy();
+    this->handle_ = nullptr;
+  }
+
+ protected:
+  explicit SessionTask(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+  std::coroutine_handle<promise_type> handle_;
+};
+
+// calls script(), which calls the coroutine, with the frame taken from pool
+template<typename Script> SessionTask start_session_script(CoroutineFramePool &pool, Script &&script) {
+  CoroutineFramePool::Scope scope(pool);
+  return script();
+}
+
+}  // namespace dlms_cosem
+}  // namespace esphome
+
+#endif  // ENABLE_DLMS_COSEM_COROUTINES
@@ -0,0 +1,78 @@
+#include "session_trace.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace dlms_cosem {
+
+void SessionTrace::init(size_t capacity) {
+  this->records_.reset(capacity > 0 ? new Record[capacity]() : nullptr);
+  this->capacity_ = capacity;
+  this->head_ = 0;
+  this->count_ = 0;
+}
+
+void SessionTrace::add(Event event, uint8_t arg8, uint16_t arg16, uint32_t arg32) {
+  if (this->capacity_ == 0)
+    return;
+  Record &r = this->records_[this->head_];
+  r.time_us = micros();
+  r.event = event;
+  r.arg8 = arg8;
+  r.arg16 = arg16;
+  r.arg32 = arg32;
+  if (++this->head_ == this->capacity_)
+    this->head_ = 0;
+  if (this->count_ < this->capacity_)
+    this->count_++;
+}
+
+void SessionTrace::add_frame(Event event, const uint8_t *data, size_t len) {
+  uint32_t head = 0;
+  for (size_t i = 1; i < 5; i++)
+    head = (head << 8) | (i < len ? data[i] : 0);
+  this->add(event, 0, len > UINT16_MAX ? UINT16_MAX : (uint16_t) len, head);
+}
+
+void SessionTrace::dump(const char *tag, size_t state_count) const {
+  static const char HEX_CHARS[] = "0123456789abcdef";
+  static constexpr size_t PER_LINE = 8;
+
+  ESP_LOGI(tag, "TRACE v1 size=%u count=%u now=%u states=%u", (unsigned) sizeof(Record), (unsigned) this->count_,
+           micros(), (unsigned) state_count);
+
+  char line[PER_LINE * sizeof(Record) * 2 + 1];
+  size_t pos = 0;
+  size_t idx = (this->head_ + this->capacity_ - this->count_) % (this->capacity_ ? this->capacity_ : 1);
+  for (size_t n = 0; n < this->count_; n++) {
+    uint8_t raw[sizeof(Record)];
+    const Record &r = this->records_[idx];
+    // explicit little endian, independent of the struct layout of the target
+    raw[0] = r.time_us;
+    raw[1] = r.time_us >> 8;
+    raw[2] = r.time_us >> 16;
+    raw[3] = r.time_us >> 24;
+    raw[4] = static_cast<uint8_t>(r.event);
+    raw[5] = r.arg8;
+    raw[6] = r.arg16;
+    raw[7] = r.arg16 >> 8;
+    raw[8] = r.arg32;
+    raw[9] = r.arg32 >> 8;
+    raw[10] = r.arg32 >> 16;
+    raw[11] = r.arg32 >> 24;
+    for (uint8_t b : raw) {
+      line[pos++] = HEX_CHARS[b >> 4];
+      line[pos++] = HEX_CHARS[b & 0x0F];
+    }
+    if (++idx == this->capacity_)
+      idx = 0;
+    if ((n + 1) % PER_LINE == 0 || n + 1 == this->count_) {
+      line[pos] = '\0';
+      ESP_LOGI(tag, "TRACE:%s", line);
+      pos = 0;
+    }
+  }
+}
+
+}  // namespace dlms_cosem
+}  // namespace esphome
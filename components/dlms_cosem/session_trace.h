@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace esphome {
+namespace dlms_cosem {
+
+/**
+ * Binary ring of session events, recorded without any formatting.
+ *
+ * Records are 12 bytes, little endian: time_us (u32, micros()), event (u8), arg8 (u8), arg16 (u16),
+ * arg32 (u32). Per event:
+ *   STATE    arg8 = old state, arg16 = new state, arg32 = time in old state, us
+ *   TX / RX  arg16 = frame length, arg32 = frame bytes 1..4 (HDLC format, length, first address byte)
+ *   ERROR    arg8 = state, arg32 = DLMS error code
+ *   TIMEOUT  arg8 = state the reply was awaited for (where COMMS_RX goes next), arg32 = ms since last RX
+ *   PUSH     arg16 = telegram length, arg32 = telegrams so far
+ * States are DlmsCosemComponent::State values; their numbering depends on push mode, so the header
+ * carries the number of states.
+ * dump() prints the oldest-to-newest records as hex, 8 per "TRACE:" line, after a header line
+ * "TRACE v1 size=<record size> count=<n> now=<time_us> states=<n>", so a host tool
+ * (tests/trace_decode.cpp) can rebuild the timeline.
+ */
+class SessionTrace {
+ public:
+  enum class Event : uint8_t { STATE = 1, TX = 2, RX = 3, ERROR = 4, TIMEOUT = 5, PUSH = 6 };
+
+  struct Record {
+    uint32_t time_us;
+    Event event;
+    uint8_t arg8;
+    uint16_t arg16;
+    uint32_t arg32;
+  };
+  static_assert(sizeof(Record) == 12, "trace record layout is part of the dump format");
+
+  // allocates the ring once; 0 keeps tracing off
+  void init(size_t capacity);
+  bool enabled() const { return this->capacity_ > 0; }
+
+  void add(Event event, uint8_t arg8, uint16_t arg16, uint32_t arg32);
+  void add_frame(Event event, const uint8_t *data, size_t len);
+
+  void dump(const char *tag, size_t state_count) const;
+
+ protected:
+  std::unique_ptr<Record[]> records_;
+  size_t capacity_{0};
+  size_t head_{0};  // next slot to write
+  size_t count_{0};
+};
+
+}  // namespace dlms_cosem
+}  // namespace esphome
@@ -5,11 +5,14 @@ from . import (
     DlmsCosem,
     dlms_cosem_ns,
     obis_code,
+    obis_bytes,
     CONF_DLMS_COSEM_ID,
     CONF_OBIS_CODE,
     CONF_DONT_PUBLISH,
     CONF_OBIS_CLASS,
     CONF_CP1251,
+    CONF_PUBLISH_ON_CHANGE,
+    CONF_MAX_SILENCE,
 )
 
 AUTO_LOAD = ["dlms_cosem"]
@@ -18,31 +21,64 @@ DlmsCosemTextSensor = dlms_cosem_ns.class_(
     "DlmsCosemTextSensor", text_sensor.TextSensor
 )
 
+CONF_DIAGNOSTIC = "diagnostic"
+DIAGNOSTIC_OBJECT_STATS = "object_stats"
 
-CONFIG_SCHEMA = cv.All(
-    text_sensor.text_sensor_schema(
-        DlmsCosemTextSensor,
-    ).extend(
-        {
-            cv.GenerateID(CONF_DLMS_COSEM_ID): cv.use_id(DlmsCosem),
-            cv.Required(CONF_OBIS_CODE): obis_code,
-            cv.Optional(CONF_DONT_PUBLISH, default=False): cv.boolean,
-            cv.Optional(CONF_OBIS_CLASS, default=1): cv.int_,
-            cv.Optional(CONF_CP1251): cv.boolean,
-        }
-    ),
-    cv.has_exactly_one_key(CONF_OBIS_CODE),
+
+OBIS_TEXT_SENSOR_SCHEMA = text_sensor.text_sensor_schema(
+    DlmsCosemTextSensor,
+).extend(
+    {
+        cv.GenerateID(CONF_DLMS_COSEM_ID): cv.use_id(DlmsCosem),
+        cv.Required(CONF_OBIS_CODE): obis_code,
+        cv.Optional(CONF_DONT_PUBLISH, default=False): cv.boolean,
+        cv.Optional(CONF_OBIS_CLASS, default=1): cv.int_,
+        cv.Optional(CONF_CP1251): cv.boolean,
+        cv.Optional(CONF_PUBLISH_ON_CHANGE, default=False): cv.boolean,
+        cv.Optional(CONF_MAX_SILENCE): cv.positive_time_period_milliseconds,
+    }
+)
+
+# hub statistics: a plain text sensor, none of the OBIS options apply
+DIAGNOSTIC_TEXT_SENSOR_SCHEMA = text_sensor.text_sensor_schema(
+    text_sensor.TextSensor,
+).extend(
+    {
+        cv.GenerateID(CONF_DLMS_COSEM_ID): cv.use_id(DlmsCosem),
+        cv.Required(CONF_DIAGNOSTIC): cv.one_of(DIAGNOSTIC_OBJECT_STATS, lower=True),
+    }
 )
 
 
+def _obis_or_diagnostic(config):
+    if not isinstance(config, dict) or CONF_DIAGNOSTIC not in config:
+        return OBIS_TEXT_SENSOR_SCHEMA(config)
+    if CONF_OBIS_CODE in config:
+        raise cv.Invalid(
+            f"Set either {CONF_OBIS_CODE} or {CONF_DIAGNOSTIC}, not both",
+            path=[CONF_DIAGNOSTIC],
+        )
+    return DIAGNOSTIC_TEXT_SENSOR_SCHEMA(config)
+
+
+CONFIG_SCHEMA = _obis_or_diagnostic
+
+
 async def to_code(config):
     component = await cg.get_variable(config[CONF_DLMS_COSEM_ID])
     var = await text_sensor.new_text_sensor(config)
-    cg.add(var.set_obis_code(config[CONF_OBIS_CODE]))
+    if config.get(CONF_DIAGNOSTIC) == DIAGNOSTIC_OBJECT_STATS:
+        cg.add(component.set_object_stats_text_sensor(var))
+        return
+
+    cg.add(var.set_obis_code(*obis_bytes(config[CONF_OBIS_CODE])))
     cg.add(var.set_dont_publish(config.get(CONF_DONT_PUBLISH)))
     cg.add(var.set_obis_class(config[CONF_OBIS_CLASS]))
+    cg.add(var.set_publish_on_change(config[CONF_PUBLISH_ON_CHANGE]))
+    if max_silence := config.get(CONF_MAX_SILENCE):
+        cg.add(var.set_max_silence_ms(max_silence))
+
+    if (cp1251 := config.get(CONF_CP1251)) is not None:
+        cg.add(var.set_cp1251_conversion_required(cp1251))
 
-    if conf := config.get(CONF_CP1251):
-        cg.add(var.set_cp1251_conversion_required(config[CONF_CP1251]))
-        
     cg.add(component.register_sensor(var))
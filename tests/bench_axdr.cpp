@@ -0,0 +1,304 @@
+// AxdrStreamParser benchmark: replays the push telegram corpus and synthetic large and deeply nested
+// telegrams through parse(), with the default patterns and with many custom ones.
+//
+//   bench_axdr [--check] [--iterations N] [corpus_dir]
+//
+// Reports frames/s, ns per object and per byte, pattern attempts, receive buffer use and heap
+// allocations per frame. --check parses everything once and fails if a corpus telegram does not
+// decode to its "# expect" objects or parse() allocates; ctest runs it that way.
+
+#include "axdr_parser.h"
+#include "dlms_cosem.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::dlms_cosem;
+
+// ---------------------------------------------------------------- heap allocation counter
+
+static size_t g_allocations = 0;
+
+void *operator new(size_t size) {
+  g_allocations++;
+  if (void *p = malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+namespace {
+
+struct Expected {
+  uint16_t class_id;
+  std::string obis;
+  uint8_t type;
+  std::string value;  // hex, "-" for none
+};
+
+struct Telegram {
+  std::string name;
+  std::vector<uint8_t> apdu;
+  bool has_expect{false};
+  std::vector<Expected> expect;
+};
+
+std::string to_hex(const uint8_t *p, size_t n) {
+  static const char *digits = "0123456789ABCDEF";
+  std::string s;
+  for (size_t i = 0; i < n; i++) {
+    s.push_back(digits[p[i] >> 4]);
+    s.push_back(digits[p[i] & 0x0F]);
+  }
+  return s.empty() ? "-" : s;
+}
+
+// "# text" comments, "# expect <class_id> <obis> <type hex> <value hex>" lines, hex bytes
+bool load_hex(const std::string &path, Telegram &t) {
+  std::ifstream in(path);
+  if (!in)
+    return false;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (!line.empty() && line[0] == '#') {
+      std::istringstream ls(line.substr(1));
+      std::string word;
+      ls >> word;
+      if (word == "expect") {
+        Expected e;
+        unsigned type;
+        ls >> e.class_id >> e.obis >> std::hex >> type >> e.value;
+        e.type = type;
+        t.expect.push_back(e);
+        t.has_expect = true;
+      }
+      continue;
+    }
+    std::istringstream ls(line);
+    std::string byte;
+    while (ls >> byte)
+      t.apdu.push_back(strtoul(byte.c_str(), nullptr, 16));
+  }
+  return !t.apdu.empty();
+}
+
+std::vector<Telegram> load_corpus(const std::string &dir) {
+  std::vector<Telegram> out;
+  DIR *d = opendir(dir.c_str());
+  if (d == nullptr)
+    return out;
+  std::vector<std::string> names;
+  while (auto *e = readdir(d)) {
+    std::string name = e->d_name;
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, ".hex") == 0)
+      names.push_back(name);
+  }
+  closedir(d);
+  std::sort(names.begin(), names.end());
+  for (auto &name : names) {
+    Telegram t;
+    t.name = name;
+    if (load_hex(dir + "/" + name, t))
+      out.push_back(std::move(t));
+  }
+  return out;
+}
+
+void put_obis(std::vector<uint8_t> &v, uint8_t c, uint8_t d, uint8_t e) {
+  v.insert(v.end(), {0x09, 0x06, 1, 0, c, d, e, 255});
+}
+
+// arrays of class/OBIS/attribute/value structures (T1), arrays hold at most 254 elements
+Telegram synthetic_large(unsigned objects) {
+  Telegram t;
+  t.name = "synthetic: " + std::to_string(objects) + " T1 objects";
+  const unsigned per_array = 200;
+  const unsigned arrays = (objects + per_array - 1) / per_array;
+  t.apdu = {0x0F, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, static_cast<uint8_t>(arrays)};
+  for (unsigned a = 0; a < arrays; a++) {
+    unsigned n = std::min(per_array, objects - a * per_array);
+    t.apdu.insert(t.apdu.end(), {0x01, static_cast<uint8_t>(n)});
+    for (unsigned i = 0; i < n; i++) {
+      unsigned k = a * per_array + i;
+      t.apdu.insert(t.apdu.end(), {0x02, 0x04, 0x12, 0x00, 0x03});
+      put_obis(t.apdu, 1 + k / 64, 8, k % 64);
+      t.apdu.insert(t.apdu.end(), {0x0F, 0x02, 0x06, 0x00, 0x01, static_cast<uint8_t>(k >> 8), static_cast<uint8_t>(k)});
+    }
+  }
+  return t;
+}
+
+// structures nested depth deep, an OBIS/value/scaler-unit object (T2) on every level
+Telegram synthetic_nested(unsigned depth) {
+  Telegram t;
+  t.name = "synthetic: " + std::to_string(depth) + " nested levels";
+  t.apdu = {0x0F, 0x00, 0x00, 0x00, 0x01, 0x00};
+  for (unsigned level = 0; level < depth; level++) {
+    t.apdu.insert(t.apdu.end(), {0x02, 0x02, 0x02, 0x03});
+    put_obis(t.apdu, 32, 7, level);
+    t.apdu.insert(t.apdu.end(), {0x12, 0x08, 0xFC, 0x02, 0x02, 0x0F, 0xFF, 0x16, 0x23});
+  }
+  t.apdu.insert(t.apdu.end(), {0x11, 0x00});
+  return t;
+}
+
+// DSLs as meter-specific YAML configs register them, tried before the default patterns on every
+// element; none of them matches the telegrams above, so they only add failed attempts
+const char *const CUSTOM_PATTERNS[] = {
+    "TC,TO,TA,TV,TSU", "TO,TA,TV",      "S2(TO,TV),TSU", "TO,TSU,TV",        "F,TO,TA,TS,TU",
+    "TO,TV,TS",        "TO,TVOSDTM,TV", "S3(TO,TV,TSU)", "TC,TS,TV",         "TO,TU,TV",
+    "TC,TO,TV,TU",     "TC,TO,TA,TSU",  "TO,TS,TV",      "TO,TU,TS,TV",      "F,TO,TSU",
+    "TV,TSU,TO",       "TC,TSU,TO,TV",  "TO,TA,TV,TSU",  "F,TC,TO,TU",       "TC,TA,TO,TV"};
+
+struct Result {
+  size_t objects{0};
+  size_t allocations{0};
+  double ns{0};
+  uint32_t attempts{0};
+  std::vector<std::string> found;
+};
+
+Result run(const Telegram &t, bool custom, unsigned iterations, bool record) {
+  std::vector<uint8_t> data = t.apdu;
+  gxByteBuffer buf{};
+  buf.data = data.data();
+  buf.capacity = data.size();
+  buf.size = data.size();
+
+  Result r;
+  CosemObjectFoundCallback fn = [&](uint16_t class_id, const uint8_t *obis, DLMS_DATA_TYPE type, const uint8_t *value,
+                                    uint8_t len, const int8_t *, const uint8_t *) {
+    if (record) {
+      char line[160];
+      snprintf(line, sizeof(line), "%u %u.%u.%u.%u.%u.%u %02X %s", class_id, obis[0], obis[1], obis[2], obis[3],
+               obis[4], obis[5], type, to_hex(value, len).c_str());
+      r.found.push_back(line);
+    }
+  };
+  AxdrStreamParser parser(&buf, fn, false);
+  // same set as the component registers in push mode
+  parser.register_pattern_dsl("HAN-DTM", "F,TO,TVOSDTM");
+  parser.register_pattern_dsl("DEV-ID", "S2(TO,TV)");
+  parser.register_pattern_dsl("T1", "TC,TO,TS,TV");
+  parser.register_pattern_dsl("T2", "TO,TV,TSU");
+  parser.register_pattern_dsl("T3", "TV,TC,TSU,TO");
+  parser.register_pattern_dsl("U.ZPA", "F,C,O,A,TV");
+  if (custom) {
+    for (const char *dsl : CUSTOM_PATTERNS)
+      parser.register_pattern_dsl("CUSTOM", dsl, 0);
+  }
+  parser.set_budget({16, 2000, 1000000});
+
+  const auto start = std::chrono::steady_clock::now();
+  const size_t allocations_before = g_allocations;
+  for (unsigned i = 0; i < iterations; i++) {
+    buf.position = 0;
+    parser.begin_frame();
+    r.objects = parser.parse();
+  }
+  r.allocations = g_allocations - allocations_before;
+  r.ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  r.attempts = parser.stats().pattern_attempts / iterations;
+  return r;
+}
+
+bool check(const Telegram &t, const Result &r) {
+  bool ok = true;
+  if (!t.has_expect)
+    return ok;
+  if (r.found.size() != t.expect.size()) {
+    printf("FAIL %s: %zu objects, expected %zu\n", t.name.c_str(), r.found.size(), t.expect.size());
+    ok = false;
+  }
+  for (size_t i = 0; i < std::min(r.found.size(), t.expect.size()); i++) {
+    const auto &e = t.expect[i];
+    char want[160];
+    snprintf(want, sizeof(want), "%u %s %02X %s", e.class_id, e.obis.c_str(), e.type, e.value.c_str());
+    if (r.found[i] != want) {
+      printf("FAIL %s: object %zu is \"%s\", expected \"%s\"\n", t.name.c_str(), i + 1, r.found[i].c_str(), want);
+      ok = false;
+    }
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  bool check_only = false;
+  unsigned iterations = 2000;
+  std::string corpus_dir = DLMS_COSEM_CORPUS_DIR;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--check") == 0) {
+      check_only = true;
+    } else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+      iterations = std::max(1, atoi(argv[++i]));
+    } else {
+      corpus_dir = argv[i];
+    }
+  }
+  host::set_print_level(ESPHOME_LOG_LEVEL_ERROR);
+  host::set_keep_level(ESPHOME_LOG_LEVEL_NONE);
+
+  std::vector<Telegram> telegrams = load_corpus(corpus_dir);
+  if (telegrams.empty()) {
+    printf("No *.hex telegrams in %s\n", corpus_dir.c_str());
+    return 1;
+  }
+  telegrams.push_back(synthetic_large(400));
+  telegrams.push_back(synthetic_nested(15));
+
+  bool ok = true;
+  if (!check_only) {
+    printf("%-36s %-8s %6s %7s %9s %8s %8s %9s %7s\n", "telegram", "patterns", "bytes", "objects", "frames/s",
+           "ns/obj", "ns/byte", "attempts", "allocs");
+  }
+  for (const auto &t : telegrams) {
+    if (check_only) {
+      // decoded objects, then allocations with the recording callback out of the way
+      ok &= check(t, run(t, false, 1, true));
+      for (bool custom : {false, true}) {
+        Result r = run(t, custom, 1, false);
+        if (r.allocations != 0) {
+          printf("FAIL %s: %zu heap allocations in parse()%s\n", t.name.c_str(), r.allocations,
+                 custom ? " with custom patterns" : "");
+          ok = false;
+        }
+      }
+      continue;
+    }
+    for (bool custom : {false, true}) {
+      Result r = run(t, custom, iterations, false);
+      const double frame_ns = r.ns / iterations;
+      printf("%-36s %-8s %6zu %7zu %9.0f %8.1f %8.2f %9u %7.2f\n", t.name.c_str(), custom ? "+20 dsl" : "default",
+             t.apdu.size(), r.objects, 1e9 / frame_ns, r.objects ? frame_ns / r.objects : 0.0,
+             frame_ns / t.apdu.size(), r.attempts, double(r.allocations) / iterations);
+    }
+    if (!check_only && t.apdu.size() > DEFAULT_IN_BUF_SIZE_PUSH) {
+      printf("%-36s needs a receive_buffer_size of at least %zu (default %zu)\n", "", t.apdu.size(),
+             DEFAULT_IN_BUF_SIZE_PUSH);
+    }
+  }
+  if (!check_only) {
+    size_t peak = 0;
+    for (const auto &t : telegrams)
+      peak = std::max(peak, t.apdu.size());
+    printf("peak buffer use: %zu bytes, %.0f%% of the default push receive buffer\n", peak,
+           100.0 * peak / DEFAULT_IN_BUF_SIZE_PUSH);
+  } else {
+    printf("%zu telegrams, %s\n", telegrams.size(), ok ? "all decode as expected" : "FAILED");
+  }
+  return ok ? 0 : 1;
+}
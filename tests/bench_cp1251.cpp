@@ -0,0 +1,88 @@
+// CP1251 -> UTF-8 micro-benchmark: cp1251_to_utf8() against a byte-at-a-time loop over the same
+// table, for the kinds of strings meters report (serial numbers, type strings, long Cyrillic text).
+//
+//   bench_cp1251 [iterations]
+
+#include "cp1251.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace esphome::dlms_cosem;
+
+namespace {
+
+struct Seq {
+  uint8_t len;
+  char bytes[CP1251_UTF8_MAX_BYTES];
+};
+Seq high[128];
+
+// the straightforward version: one byte per iteration, no ASCII word path
+size_t byte_at_a_time(const uint8_t *src, size_t len, char *dst, size_t dst_size) {
+  size_t out = 0;
+  for (size_t i = 0; i < len; i++) {
+    if (src[i] < 0x80) {
+      if (out + 1 >= dst_size)
+        break;
+      dst[out++] = (char) src[i];
+    } else {
+      const Seq &s = high[src[i] - 0x80];
+      if (out + s.len >= dst_size)
+        break;
+      memcpy(dst + out, s.bytes, s.len);
+      out += s.len;
+    }
+  }
+  dst[out] = '\0';
+  return out;
+}
+
+template<typename F> double ns_per_call(F fn, const std::string &in, unsigned iterations, size_t *sink) {
+  char out[512];
+  const auto start = std::chrono::steady_clock::now();
+  for (unsigned i = 0; i < iterations; i++) {
+    *sink += fn(reinterpret_cast<const uint8_t *>(in.data()), in.size(), out, sizeof(out));
+    // keep the compiler from hoisting the call out of the loop
+    asm volatile("" : : "r"(out) : "memory");
+  }
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const unsigned iterations = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000000;
+  for (int c = 0x80; c < 0x100; c++) {
+    const uint8_t b = c;
+    char tmp[8];
+    Seq &s = high[c - 0x80];
+    s.len = cp1251_to_utf8(&b, 1, tmp, sizeof(tmp));
+    memcpy(s.bytes, tmp, s.len);
+  }
+
+  std::string cyrillic;
+  for (int i = 0; i < 128; i++)
+    cyrillic += static_cast<char>(0xC0 + i % 64);
+  const struct {
+    const char *name;
+    std::string text;
+  } inputs[] = {
+      {"serial number (16 ASCII)", "0123456789012345"},
+      {"meter type (mixed, 28)", "\xD1\xF7\xE5\xF2\xF7\xE8\xEA \xCD\xE0\xF0\xF2\xE8\xF1 I100-W112 \xB9 5"},
+      {"ASCII (128)", std::string(128, 'a')},
+      {"Cyrillic (128)", cyrillic},
+  };
+
+  size_t sink = 0;
+  printf("%-28s %12s %12s %8s\n", "input", "word path", "per byte", "speedup");
+  for (const auto &in : inputs) {
+    const double fast = ns_per_call(cp1251_to_utf8, in.text, iterations, &sink);
+    const double slow = ns_per_call(byte_at_a_time, in.text, iterations, &sink);
+    printf("%-28s %9.1f ns %9.1f ns %7.2fx\n", in.name, fast, slow, slow / fast);
+  }
+  return sink == 0 ? 1 : 0;
+}
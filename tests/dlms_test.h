@@ -0,0 +1,79 @@
+#pragma once
+
+// Minimal test runner for the host tests: TEST_CASE() registers a case, CHECK*() record failures and
+// keep going, test_main.cpp runs every registered case.
+
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace dlms_test {
+
+struct Case {
+  const char *name;
+  void (*fn)();
+};
+
+inline std::vector<Case> &cases() {
+  static std::vector<Case> all;
+  return all;
+}
+
+inline int &failures() {
+  static int count = 0;
+  return count;
+}
+
+struct Register {
+  Register(const char *name, void (*fn)()) { cases().push_back({name, fn}); }
+};
+
+inline void fail(const char *file, int line, const std::string &what) {
+  fprintf(stderr, "%s:%d: check failed: %s\n", file, line, what.c_str());
+  failures()++;
+}
+
+template<typename T> std::string show(const T &value) {
+  std::ostringstream os;
+  if constexpr (std::is_same_v<T, uint8_t> || std::is_same_v<T, int8_t>) {
+    os << static_cast<int>(value);
+  } else {
+    os << value;
+  }
+  return os.str();
+}
+
+}  // namespace dlms_test
+
+#define TEST_CASE(name) \
+  static void name(); \
+  static dlms_test::Register name##_registered_(#name, name); \
+  static void name()
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) \
+      dlms_test::fail(__FILE__, __LINE__, #cond); \
+  } while (0)
+
+#define CHECK_EQ(a, b) \
+  do { \
+    auto a_ = (a); \
+    auto b_ = (b); \
+    if (!(a_ == b_)) \
+      dlms_test::fail(__FILE__, __LINE__, \
+                      std::string(#a " == " #b ", ") + dlms_test::show(a_) + " != " + dlms_test::show(b_)); \
+  } while (0)
+
+#define CHECK_NEAR(a, b, eps) \
+  do { \
+    double a_ = (a); \
+    double b_ = (b); \
+    if (!(std::fabs(a_ - b_) <= (eps))) \
+      dlms_test::fail(__FILE__, __LINE__, \
+                      std::string(#a " ~ " #b ", ") + dlms_test::show(a_) + " != " + dlms_test::show(b_)); \
+  } while (0)
@@ -0,0 +1,280 @@
+// Fuzz target for the push path: raw bytes through PushFrameAssembler (HDLC, block transfer,
+// ciphering) and the resulting APDUs through AxdrStreamParser, as push_receive_() and
+// process_push_data() run them on the device.
+//
+// With clang: cmake -DDLMS_COSEM_LIBFUZZER=ON builds a libFuzzer binary (-fsanitize=fuzzer).
+// Otherwise main() below is a small standalone driver: it replays the files given on the command
+// line (or the push corpus) and then random mutations of them, under ASan/UBSan when available.
+//
+//   fuzz_push [-runs=N] [-seed=N] [file_or_dir...]
+
+#include "axdr_parser.h"
+#include "dlms_cipher.h"
+#include "push_assembler.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::dlms_cosem;
+
+static constexpr size_t RX_BUFFER_SIZE = 2048;  // DEFAULT_IN_BUF_SIZE_PUSH
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  static bool quiet = [] {
+    host::set_print_level(ESPHOME_LOG_LEVEL_NONE);
+    host::set_keep_level(ESPHOME_LOG_LEVEL_NONE);
+    return true;
+  }();
+  (void) quiet;
+  if (size == 0)
+    return 0;
+
+  // first byte: bytes per read (UART chunks) and whether a key is set
+  const uint8_t control = data[0];
+  const size_t chunk = 1 + (control & 0x3F);
+  const bool ciphered = control & 0x40;
+  data++;
+  size--;
+
+  static DlmsCipher cipher = [] {
+    DlmsCipher c;
+    uint8_t ek[16], ak[16];
+    for (int i = 0; i < 16; i++) {
+      ek[i] = i;
+      ak[i] = 0xD0 + i;
+    }
+    c.set_decryption_key(ek);
+    c.set_authentication_key(ak);
+    return c;
+  }();
+
+  // exactly the receive buffer's size, so ASan sees any access past it
+  std::unique_ptr<uint8_t[]> storage(new uint8_t[RX_BUFFER_SIZE]);
+  gxByteBuffer buf{};
+  buf.data = storage.get();
+  buf.capacity = RX_BUFFER_SIZE;
+
+  PushFrameAssembler assembler;
+  assembler.set_cipher(ciphered ? &cipher : nullptr);
+  assembler.reset();
+  for (size_t pos = 0; pos < size;) {
+    size_t n = std::min({chunk, size - pos, (size_t) (buf.capacity - buf.size)});
+    if (n == 0)
+      break;  // overflow: the component drops the telegram here
+    memcpy(buf.data + buf.size, data + pos, n);
+    buf.size += n;
+    pos += n;
+    assembler.feed(&buf);
+  }
+  assembler.finish(&buf);
+  if (buf.size > buf.capacity)
+    abort();
+
+  uint32_t sink = 0;
+  CosemObjectFoundCallback fn = [&](uint16_t class_id, const uint8_t *obis, DLMS_DATA_TYPE type, const uint8_t *value,
+                                    uint8_t len, const int8_t *scaler, const uint8_t *unit) {
+    // touch everything the parser hands out
+    sink += class_id + type;
+    for (int i = 0; i < 6; i++)
+      sink += obis[i];
+    for (uint8_t i = 0; i < len; i++)
+      sink += value[i];
+    if (scaler != nullptr)
+      sink += *scaler + *unit;
+  };
+  AxdrStreamParser parser(&buf, fn, false);
+  parser.register_pattern_dsl("HAN-DTM", "F,TO,TVOSDTM");
+  parser.register_pattern_dsl("DEV-ID", "S2(TO,TV)");
+  parser.register_pattern_dsl("T1", "TC,TO,TS,TV");
+  parser.register_pattern_dsl("T2", "TO,TV,TSU");
+  parser.register_pattern_dsl("T3", "TV,TC,TSU,TO");
+  parser.register_pattern_dsl("U.ZPA", "F,C,O,A,TV");
+
+  // as process_push_data()
+  buf.position = 0;
+  parser.begin_frame();
+  while (buf.position < buf.size) {
+    auto before = buf.position;
+    if (parser.parse() == 0 && buf.position == before)
+      break;
+    if (buf.position > buf.size)
+      abort();
+  }
+  return sink == 0xFFFFFFFF;  // keeps sink alive
+}
+
+#ifndef DLMS_COSEM_LIBFUZZER
+
+namespace {
+
+std::vector<uint8_t> read_file(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  std::vector<uint8_t> raw((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  if (path.size() < 4 || path.compare(path.size() - 4, 4, ".hex") != 0)
+    return raw;
+  // corpus text: hex bytes, '#' comment lines
+  std::vector<uint8_t> out;
+  std::istringstream text(std::string(raw.begin(), raw.end()));
+  std::string line;
+  while (std::getline(text, line)) {
+    if (!line.empty() && line[0] == '#')
+      continue;
+    std::istringstream ls(line);
+    std::string byte;
+    while (ls >> byte)
+      out.push_back(strtoul(byte.c_str(), nullptr, 16));
+  }
+  return out;
+}
+
+void add_path(const std::string &path, std::vector<std::vector<uint8_t>> &seeds) {
+  if (DIR *d = opendir(path.c_str())) {
+    std::vector<std::string> names;
+    while (auto *e = readdir(d)) {
+      if (e->d_name[0] != '.')
+        names.push_back(path + "/" + e->d_name);
+    }
+    closedir(d);
+    std::sort(names.begin(), names.end());
+    for (auto &name : names)
+      add_path(name, seeds);
+    return;
+  }
+  auto data = read_file(path);
+  if (!data.empty())
+    seeds.push_back(std::move(data));
+}
+
+uint16_t fcs16(const uint8_t *p, size_t n) {
+  uint16_t fcs = 0xFFFF;
+  while (n--) {
+    fcs ^= *p++;
+    for (int i = 0; i < 8; i++)
+      fcs = (fcs & 1) ? (fcs >> 1) ^ 0x8408 : fcs >> 1;
+  }
+  return ~fcs;
+}
+
+// the APDU in HDLC UI frames of at most max_info bytes, as a meter pushes it
+std::vector<uint8_t> hdlc_wrap(const std::vector<uint8_t> &apdu, size_t max_info) {
+  std::vector<uint8_t> info = {0xE6, 0xE7, 0x00};
+  info.insert(info.end(), apdu.begin(), apdu.end());
+  std::vector<uint8_t> out;
+  for (size_t off = 0; off < info.size(); off += max_info) {
+    size_t n = std::min(max_info, info.size() - off);
+    bool segmented = off + n < info.size();
+    size_t length = 2 + 1 + 1 + 1 + 2 + n + 2;
+    std::vector<uint8_t> f = {0x7E, static_cast<uint8_t>(0xA0 | (segmented ? 0x08 : 0) | (length >> 8)),
+                              static_cast<uint8_t>(length), 0x03, 0x21, 0x13};
+    uint16_t hcs = fcs16(f.data() + 1, f.size() - 1);
+    f.push_back(hcs & 0xFF);
+    f.push_back(hcs >> 8);
+    f.insert(f.end(), info.begin() + off, info.begin() + off + n);
+    uint16_t fcs = fcs16(f.data() + 1, f.size() - 1);
+    f.push_back(fcs & 0xFF);
+    f.push_back(fcs >> 8);
+    f.push_back(0x7E);
+    out.insert(out.end(), f.begin(), f.end());
+  }
+  return out;
+}
+
+void mutate(std::vector<uint8_t> &d, std::mt19937 &rng) {
+  const int edits = 1 + rng() % 4;
+  for (int e = 0; e < edits; e++) {
+    size_t pos = d.empty() ? 0 : rng() % d.size();
+    switch (rng() % 6) {
+      case 0:  // flip a bit
+        if (!d.empty())
+          d[pos] ^= 1 << (rng() % 8);
+        break;
+      case 1:  // interesting byte
+        if (!d.empty()) {
+          static const uint8_t values[] = {0x00, 0x01, 0x02, 0x09, 0x0F, 0x7E, 0x7F, 0x80, 0xE0, 0xDB, 0xFE, 0xFF};
+          d[pos] = values[rng() % sizeof(values)];
+        }
+        break;
+      case 2:  // insert
+        d.insert(d.begin() + pos, static_cast<uint8_t>(rng()));
+        break;
+      case 3:  // erase
+        if (!d.empty())
+          d.erase(d.begin() + pos);
+        break;
+      case 4:  // truncate
+        d.resize(pos);
+        break;
+      case 5:  // duplicate a slice
+        if (!d.empty()) {
+          size_t n = std::min<size_t>(1 + rng() % 32, d.size() - pos);
+          std::vector<uint8_t> slice(d.begin() + pos, d.begin() + pos + n);
+          d.insert(d.begin() + rng() % (d.size() + 1), slice.begin(), slice.end());
+        }
+        break;
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  unsigned runs = 10000;
+  unsigned seed = 1;
+  std::vector<std::vector<uint8_t>> seeds;
+  bool have_paths = false;
+  for (int i = 1; i < argc; i++) {
+    if (strncmp(argv[i], "-runs=", 6) == 0) {
+      runs = strtoul(argv[i] + 6, nullptr, 10);
+    } else if (strncmp(argv[i], "-seed=", 6) == 0) {
+      seed = strtoul(argv[i] + 6, nullptr, 10);
+    } else {
+      add_path(argv[i], seeds);
+      have_paths = true;
+    }
+  }
+#ifdef DLMS_COSEM_CORPUS_DIR
+  if (!have_paths)
+    add_path(DLMS_COSEM_CORPUS_DIR, seeds);
+#endif
+  if (seeds.empty()) {
+    fprintf(stderr, "No inputs\n");
+    return 1;
+  }
+
+  // each APDU as is and in HDLC frames, plain and segmented; first byte is the harness control byte
+  std::vector<std::vector<uint8_t>> inputs;
+  for (const auto &s : seeds) {
+    for (auto framed : {s, hdlc_wrap(s, 1000), hdlc_wrap(s, 64)}) {
+      framed.insert(framed.begin(), 0x0F);
+      inputs.push_back(framed);
+    }
+  }
+  for (const auto &in : inputs)
+    LLVMFuzzerTestOneInput(in.data(), in.size());
+
+  std::mt19937 rng(seed);
+  for (unsigned r = 0; r < runs; r++) {
+    std::vector<uint8_t> in = inputs[rng() % inputs.size()];
+    mutate(in, rng);
+    if (in.empty())
+      in.push_back(0);
+    in[0] = static_cast<uint8_t>(rng());
+    LLVMFuzzerTestOneInput(in.data(), in.size());
+  }
+  printf("%zu inputs and %u mutations parsed\n", inputs.size(), runs);
+  return 0;
+}
+
+#endif  // DLMS_COSEM_LIBFUZZER
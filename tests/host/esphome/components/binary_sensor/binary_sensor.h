@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+
+#include "esphome/core/entity_base.h"
+
+#define LOG_BINARY_SENSOR(prefix, type, obj)
+#define SUB_BINARY_SENSOR(name) \
+ protected: \
+  binary_sensor::BinarySensor *name##_binary_sensor_{nullptr}; \
+\
+ public: \
+  void set_##name##_binary_sensor(binary_sensor::BinarySensor *binary_sensor) { \
+    this->name##_binary_sensor_ = binary_sensor; \
+  }
+
+namespace esphome {
+namespace binary_sensor {
+
+// sink: keeps every published state
+class BinarySensor : public EntityBase {
+ public:
+  void publish_state(bool state) {
+    this->state = state;
+    this->published.push_back(state);
+  }
+
+  bool state{false};
+  std::vector<bool> published;
+};
+
+}  // namespace binary_sensor
+}  // namespace esphome
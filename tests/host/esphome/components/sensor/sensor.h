@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "esphome/core/entity_base.h"
+
+#define LOG_SENSOR(prefix, type, obj)
+#define SUB_SENSOR(name) \
+ protected: \
+  sensor::Sensor *name##_sensor_{nullptr}; \
+\
+ public: \
+  void set_##name##_sensor(sensor::Sensor *sensor) { this->name##_sensor_ = sensor; }
+
+namespace esphome {
+namespace sensor {
+
+// sink: keeps every published state
+class Sensor : public EntityBase {
+ public:
+  void publish_state(float state) {
+    this->state = state;
+    this->published.push_back(state);
+  }
+  int8_t get_accuracy_decimals() { return this->accuracy_decimals_; }
+  void set_accuracy_decimals(int8_t accuracy_decimals) { this->accuracy_decimals_ = accuracy_decimals; }
+
+  float state{0.0f};
+  std::vector<float> published;
+
+ protected:
+  int8_t accuracy_decimals_{2};
+};
+
+}  // namespace sensor
+}  // namespace esphome
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "esphome/core/entity_base.h"
+
+#define LOG_TEXT_SENSOR(prefix, type, obj)
+#define SUB_TEXT_SENSOR(name) \
+ protected: \
+  text_sensor::TextSensor *name##_text_sensor_{nullptr}; \
+\
+ public: \
+  void set_##name##_text_sensor(text_sensor::TextSensor *text_sensor) { this->name##_text_sensor_ = text_sensor; }
+
+namespace esphome {
+namespace text_sensor {
+
+// sink: keeps every published state
+class TextSensor : public EntityBase {
+ public:
+  void publish_state(const std::string &state) {
+    this->state = state;
+    this->published.push_back(state);
+  }
+
+  std::string state;
+  std::vector<std::string> published;
+};
+
+}  // namespace text_sensor
+}  // namespace esphome
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+
+class Application {
+ public:
+  void safe_reboot() { this->reboot_requested_ = true; }
+  void feed_wdt() {}
+  uint32_t get_loop_component_start_time() const { return millis(); }
+
+  // host harness only
+  bool reboot_requested() const { return this->reboot_requested_; }
+
+ protected:
+  bool reboot_requested_{false};
+};
+
+extern Application App;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+}  // namespace esphome
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "esphome/core/component.h"
+
+namespace esphome {
+
+template<typename T, typename... X> class TemplatableValue {
+ public:
+  TemplatableValue() = default;
+  TemplatableValue(T value) : has_value_(true), value_(std::move(value)) {}  // NOLINT
+  template<typename F, typename = decltype(std::declval<F>()(std::declval<X>()...))>
+  TemplatableValue(F f) : has_value_(true), f_(f) {}  // NOLINT
+
+  bool has_value() const { return this->has_value_; }
+  T value(X... x) const { return this->f_ ? this->f_(x...) : this->value_; }
+
+ protected:
+  bool has_value_{false};
+  T value_{};
+  std::function<T(X...)> f_;
+};
+
+#define TEMPLATABLE_VALUE_(type, name) \
+ protected: \
+  TemplatableValue<type, Ts...> name##_{}; \
+\
+ public: \
+  template<typename V> void set_##name(V name) { this->name##_ = name; }
+
+#define TEMPLATABLE_VALUE(type, name) TEMPLATABLE_VALUE_(type, name)
+
+template<typename... Ts> class Action {
+ public:
+  virtual ~Action() = default;
+  virtual void play(Ts... x) = 0;
+  void play_complex(Ts... x) { this->play(x...); }
+};
+
+// the host harness has no automations, a trigger calls whatever the test attached to it
+template<typename... Ts> class Trigger {
+ public:
+  void trigger(Ts... x) {
+    for (auto &f : this->callbacks_)
+      f(x...);
+  }
+  void add_callback(std::function<void(Ts...)> &&f) { this->callbacks_.push_back(std::move(f)); }
+
+ protected:
+  std::vector<std::function<void(Ts...)>> callbacks_;
+};
+
+template<typename T> class Parented {
+ public:
+  Parented() = default;
+  Parented(T *parent) : parent_(parent) {}  // NOLINT
+  T *get_parent() const { return this->parent_; }
+  void set_parent(T *parent) { this->parent_ = parent; }
+
+ protected:
+  T *parent_{nullptr};
+};
+
+}  // namespace esphome
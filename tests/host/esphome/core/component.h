@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#define LOG_UPDATE_INTERVAL(this)
+
+namespace esphome {
+
+namespace setup_priority {
+extern const float DATA;
+}  // namespace setup_priority
+
+class Component {
+ public:
+  virtual ~Component();
+
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+  virtual float get_setup_priority() const { return 0.0f; }
+
+  bool is_ready() const { return this->ready_ && !this->failed_; }
+  bool is_failed() const { return this->failed_; }
+  void mark_failed() { this->failed_ = true; }
+  void status_momentary_warning(const std::string &name, uint32_t length = 5000) {}
+
+  void set_timeout(uint32_t timeout, std::function<void()> &&f);
+  void set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f);
+  void set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f);
+  bool cancel_timeout(const std::string &name);
+
+  // host harness only: runs setup() and marks the component ready, as App.setup() would
+  void call_setup();
+  // host harness only: fires due timeouts and intervals of this component
+  void run_scheduler();
+
+ protected:
+  struct Scheduled {
+    std::string name;
+    uint32_t at_ms;
+    uint32_t interval_ms;  // 0 = one-shot
+    std::function<void()> f;
+  };
+  std::vector<Scheduled> scheduled_;
+  bool ready_{false};
+  bool failed_{false};
+};
+
+class PollingComponent : public Component {
+ public:
+  PollingComponent() = default;
+  explicit PollingComponent(uint32_t update_interval) : update_interval_(update_interval) {}
+
+  virtual void update() = 0;
+  void set_update_interval(uint32_t update_interval) { this->update_interval_ = update_interval; }
+  uint32_t get_update_interval() const { return this->update_interval_; }
+
+  // host harness only: calls update() every update interval, like the ESPHome scheduler
+  void run_polling();
+
+ protected:
+  uint32_t update_interval_{60000};
+  uint32_t last_update_ms_{0};
+  bool updated_once_{false};
+};
+
+namespace host {
+
+/**
+ * Drives a component like App.loop() does: the simulated clock moves in steps of step_us, and every
+ * step fires due timeouts, calls update() when the update interval has passed and then loop().
+ */
+void run_for(PollingComponent *component, uint32_t duration_ms, uint32_t step_us = 1000);
+
+}  // namespace host
+}  // namespace esphome
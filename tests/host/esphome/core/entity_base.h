@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+
+namespace esphome {
+
+class EntityBase {
+ public:
+  const std::string &get_name() const { return this->name_; }
+  void set_name(const std::string &name) { this->name_ = name; }
+  std::string get_object_id() const { return this->name_; }
+
+ protected:
+  std::string name_;
+};
+
+}  // namespace esphome
@@ -0,0 +1,38 @@
+#pragma once
+
+// Host test shim: the clock is simulated and only moves when a test advances it (or delay() is called).
+
+#include <cstdint>
+
+#define LOG_PIN(prefix, pin)
+
+namespace esphome {
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+class GPIOPin {
+ public:
+  virtual ~GPIOPin() = default;
+  virtual void setup() {}
+  virtual void digital_write(bool value) { this->state_ = value; }
+  virtual bool digital_read() { return this->state_; }
+
+ protected:
+  bool state_{false};
+};
+
+namespace host {
+
+// advances the simulated clock
+void advance_us(uint64_t us);
+inline void advance_ms(uint32_t ms) { advance_us(uint64_t(ms) * 1000); }
+// sets the simulated clock, e.g. just before the 32-bit millis() wrap
+void set_time_us(uint64_t us);
+uint64_t now_us();
+
+}  // namespace host
+}  // namespace esphome
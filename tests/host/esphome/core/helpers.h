@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace esphome {
+
+using std::make_unique;
+
+template<typename T> using optional = std::optional<T>;
+
+std::string format_hex_pretty(const uint8_t *data, size_t length);
+std::string str_sprintf(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+bool parse_hex(const std::string &str, uint8_t *data, size_t count);
+uint32_t fnv1_hash(const std::string &str);
+
+class Mutex {
+ public:
+  void lock() { this->m_.lock(); }
+  bool try_lock() { return this->m_.try_lock(); }
+  void unlock() { this->m_.unlock(); }
+
+ private:
+  std::mutex m_;
+};
+
+class LockGuard {
+ public:
+  explicit LockGuard(Mutex &mutex) : mutex_(mutex) { this->mutex_.lock(); }
+  ~LockGuard() { this->mutex_.unlock(); }
+
+ private:
+  Mutex &mutex_;
+};
+
+class HighFrequencyLoopRequester {
+ public:
+  void start();
+  void stop();
+  static bool is_high_frequency();
+
+ protected:
+  bool started_{false};
+};
+
+template<class T> class RAMAllocator {
+ public:
+  T *allocate(size_t n) { return static_cast<T *>(std::malloc(n * sizeof(T))); }
+  void deallocate(T *p, size_t n) { std::free(p); }
+};
+
+}  // namespace esphome
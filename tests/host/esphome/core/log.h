@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdarg>
+#include <string>
+#include <vector>
+
+#define ESPHOME_LOG_LEVEL_NONE 0
+#define ESPHOME_LOG_LEVEL_ERROR 1
+#define ESPHOME_LOG_LEVEL_WARN 2
+#define ESPHOME_LOG_LEVEL_INFO 3
+#define ESPHOME_LOG_LEVEL_CONFIG 4
+#define ESPHOME_LOG_LEVEL_DEBUG 5
+#define ESPHOME_LOG_LEVEL_VERBOSE 6
+#define ESPHOME_LOG_LEVEL_VERY_VERBOSE 7
+
+#ifndef ESPHOME_LOG_LEVEL
+#define ESPHOME_LOG_LEVEL ESPHOME_LOG_LEVEL_VERY_VERBOSE
+#endif
+
+#define ESP_LOGE(tag, ...) ::esphome::host::log(ESPHOME_LOG_LEVEL_ERROR, tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) ::esphome::host::log(ESPHOME_LOG_LEVEL_WARN, tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) ::esphome::host::log(ESPHOME_LOG_LEVEL_INFO, tag, __VA_ARGS__)
+#define ESP_LOGCONFIG(tag, ...) ::esphome::host::log(ESPHOME_LOG_LEVEL_CONFIG, tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) ::esphome::host::log(ESPHOME_LOG_LEVEL_DEBUG, tag, __VA_ARGS__)
+#define ESP_LOGV(tag, ...) ::esphome::host::log(ESPHOME_LOG_LEVEL_VERBOSE, tag, __VA_ARGS__)
+#define ESP_LOGVV(tag, ...) ::esphome::host::log(ESPHOME_LOG_LEVEL_VERY_VERBOSE, tag, __VA_ARGS__)
+
+struct LogString;
+#define LOG_STR(s) (reinterpret_cast<const LogString *>(s))
+#define LOG_STR_ARG(s) (reinterpret_cast<const char *>(s))
+#define LOG_STR_LITERAL(s) (s)
+
+namespace esphome {
+namespace host {
+
+struct LogLine {
+  int level;
+  std::string tag;
+  std::string message;
+};
+
+void log(int level, const char *tag, const char *format, ...) __attribute__((format(printf, 3, 4)));
+
+// lines at or above (numerically below or equal to) this level go to stderr, default WARN
+void set_print_level(int level);
+// lines up to this level (default VERBOSE) are kept until cleared, so tests can check what was logged
+void set_keep_level(int level);
+const std::vector<LogLine> &log_lines();
+void clear_log();
+size_t count_log(int level, const char *substring);
+
+}  // namespace host
+}  // namespace esphome
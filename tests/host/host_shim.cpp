@@ -0,0 +1,222 @@
+// Host test shim: simulated clock, captured log, component scheduler and the ESPHome helpers the
+// component uses. Only what the tests need, with the ESPHome semantics.
+
+#include "esphome/core/application.h"
+#include "esphome/core/component.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace esphome {
+
+Application App;  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+namespace setup_priority {
+const float DATA = 600.0f;
+}  // namespace setup_priority
+
+// ---------------------------------------------------------------- clock
+
+static uint64_t now_us_ = 0;
+
+namespace host {
+void advance_us(uint64_t us) { now_us_ += us; }
+void set_time_us(uint64_t us) { now_us_ = us; }
+uint64_t now_us() { return now_us_; }
+}  // namespace host
+
+uint32_t millis() { return static_cast<uint32_t>(now_us_ / 1000); }
+uint32_t micros() { return static_cast<uint32_t>(now_us_); }
+void delay(uint32_t ms) { now_us_ += uint64_t(ms) * 1000; }
+void delayMicroseconds(uint32_t us) { now_us_ += us; }
+void yield() {}
+
+// ---------------------------------------------------------------- log
+
+static int print_level_ = ESPHOME_LOG_LEVEL_WARN;
+static int keep_level_ = ESPHOME_LOG_LEVEL_VERBOSE;
+static constexpr size_t MAX_LOG_LINES = 100000;
+static std::vector<host::LogLine> log_lines_;
+
+namespace host {
+
+void log(int level, const char *tag, const char *format, ...) {
+  if (level > print_level_ && level > keep_level_)
+    return;
+  char buf[1024];
+  va_list args;
+  va_start(args, format);
+  vsnprintf(buf, sizeof(buf), format, args);
+  va_end(args);
+  if (level <= print_level_)
+    fprintf(stderr, "[%c][%s] %s\n", "-EWICDVV"[level], tag, buf);
+  if (level > keep_level_)
+    return;
+  if (log_lines_.size() >= MAX_LOG_LINES)
+    log_lines_.erase(log_lines_.begin(), log_lines_.begin() + MAX_LOG_LINES / 2);
+  log_lines_.push_back({level, tag, buf});
+}
+
+void set_print_level(int level) { print_level_ = level; }
+void set_keep_level(int level) { keep_level_ = level; }
+const std::vector<LogLine> &log_lines() { return log_lines_; }
+void clear_log() { log_lines_.clear(); }
+
+size_t count_log(int level, const char *substring) {
+  return std::count_if(log_lines_.begin(), log_lines_.end(), [&](const LogLine &l) {
+    return l.level == level && l.message.find(substring) != std::string::npos;
+  });
+}
+
+}  // namespace host
+
+// ---------------------------------------------------------------- helpers
+
+std::string format_hex_pretty(const uint8_t *data, size_t length) {
+  static const char HEX_CHARS[] = "0123456789ABCDEF";
+  std::string ret;
+  for (size_t i = 0; i < length; i++) {
+    if (i > 0)
+      ret += '.';
+    ret += HEX_CHARS[data[i] >> 4];
+    ret += HEX_CHARS[data[i] & 0x0F];
+  }
+  if (length > 4)
+    ret += " (" + std::to_string(length) + ")";
+  return ret;
+}
+
+std::string str_sprintf(const char *fmt, ...) {
+  char buf[512];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  return buf;
+}
+
+static int hex_value(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+bool parse_hex(const std::string &str, uint8_t *data, size_t count) {
+  if (str.size() < count * 2)
+    return false;
+  for (size_t i = 0; i < count; i++) {
+    int hi = hex_value(str[i * 2]);
+    int lo = hex_value(str[i * 2 + 1]);
+    if (hi < 0 || lo < 0)
+      return false;
+    data[i] = (hi << 4) | lo;
+  }
+  return true;
+}
+
+uint32_t fnv1_hash(const std::string &str) {
+  uint32_t hash = 2166136261UL;
+  for (char c : str) {
+    hash *= 16777619UL;
+    hash ^= c;
+  }
+  return hash;
+}
+
+static int high_frequency_requests_ = 0;
+
+void HighFrequencyLoopRequester::start() {
+  if (this->started_)
+    return;
+  high_frequency_requests_++;
+  this->started_ = true;
+}
+
+void HighFrequencyLoopRequester::stop() {
+  if (!this->started_)
+    return;
+  high_frequency_requests_--;
+  this->started_ = false;
+}
+
+bool HighFrequencyLoopRequester::is_high_frequency() { return high_frequency_requests_ > 0; }
+
+// ---------------------------------------------------------------- components
+
+Component::~Component() = default;
+
+void Component::set_timeout(uint32_t timeout, std::function<void()> &&f) {
+  this->scheduled_.push_back({"", millis() + timeout, 0, std::move(f)});
+}
+
+void Component::set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f) {
+  this->cancel_timeout(name);
+  this->scheduled_.push_back({name, millis() + timeout, 0, std::move(f)});
+}
+
+void Component::set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f) {
+  this->cancel_timeout(name);
+  this->scheduled_.push_back({name, millis() + interval, interval, std::move(f)});
+}
+
+bool Component::cancel_timeout(const std::string &name) {
+  auto it = std::remove_if(this->scheduled_.begin(), this->scheduled_.end(),
+                           [&](const Scheduled &s) { return !name.empty() && s.name == name; });
+  bool found = it != this->scheduled_.end();
+  this->scheduled_.erase(it, this->scheduled_.end());
+  return found;
+}
+
+void Component::call_setup() {
+  this->setup();
+  this->ready_ = true;
+}
+
+void Component::run_scheduler() {
+  const uint32_t now = millis();
+  for (size_t i = 0; i < this->scheduled_.size(); i++) {
+    if (static_cast<int32_t>(now - this->scheduled_[i].at_ms) < 0)
+      continue;
+    auto f = this->scheduled_[i].f;
+    if (this->scheduled_[i].interval_ms == 0) {
+      this->scheduled_.erase(this->scheduled_.begin() + i);
+      i--;
+    } else {
+      this->scheduled_[i].at_ms = now + this->scheduled_[i].interval_ms;
+    }
+    f();
+  }
+}
+
+void PollingComponent::run_polling() {
+  const uint32_t now = millis();
+  if (this->updated_once_ && now - this->last_update_ms_ < this->update_interval_)
+    return;
+  this->updated_once_ = true;
+  this->last_update_ms_ = now;
+  this->update();
+}
+
+namespace host {
+
+void run_for(PollingComponent *component, uint32_t duration_ms, uint32_t step_us) {
+  const uint64_t end = now_us_ + uint64_t(duration_ms) * 1000;
+  while (now_us_ < end) {
+    component->run_scheduler();
+    if (component->is_ready())
+      component->run_polling();
+    component->loop();
+    now_us_ += step_us;
+  }
+}
+
+}  // namespace host
+}  // namespace esphome
@@ -0,0 +1,52 @@
+// mbedtls/aes.h for host tests, over OpenSSL's AES block cipher
+
+#include "mbedtls/aes.h"
+
+#include <cstring>
+#include <openssl/evp.h>
+
+void mbedtls_aes_init(mbedtls_aes_context *ctx) { memset(ctx, 0, sizeof(*ctx)); }
+
+void mbedtls_aes_free(mbedtls_aes_context *ctx) { memset(ctx, 0, sizeof(*ctx)); }
+
+int mbedtls_aes_setkey_enc(mbedtls_aes_context *ctx, const unsigned char *key, unsigned int keybits) {
+  if (keybits != 128 && keybits != 192 && keybits != 256)
+    return -0x0020;  // MBEDTLS_ERR_AES_INVALID_KEY_LENGTH
+  memcpy(ctx->key, key, keybits / 8);
+  ctx->keybits = keybits;
+  return 0;
+}
+
+int mbedtls_aes_crypt_ecb(mbedtls_aes_context *ctx, int mode, const unsigned char input[16],
+                          unsigned char output[16]) {
+  const EVP_CIPHER *cipher = ctx->keybits == 256   ? EVP_aes_256_ecb()
+                             : ctx->keybits == 192 ? EVP_aes_192_ecb()
+                                                   : EVP_aes_128_ecb();
+  EVP_CIPHER_CTX *c = EVP_CIPHER_CTX_new();
+  int len = 0;
+  int ok = EVP_CipherInit_ex(c, cipher, nullptr, ctx->key, nullptr, mode == MBEDTLS_AES_ENCRYPT) &&
+           EVP_CIPHER_CTX_set_padding(c, 0) && EVP_CipherUpdate(c, output, &len, input, 16);
+  EVP_CIPHER_CTX_free(c);
+  return ok && len == 16 ? 0 : -1;
+}
+
+int mbedtls_aes_crypt_ctr(mbedtls_aes_context *ctx, size_t length, size_t *nc_off, unsigned char nonce_counter[16],
+                          unsigned char stream_block[16], const unsigned char *input, unsigned char *output) {
+  size_t n = *nc_off;
+  if (n > 15)
+    return -0x0021;  // MBEDTLS_ERR_AES_BAD_INPUT_DATA
+  for (size_t i = 0; i < length; i++) {
+    if (n == 0) {
+      if (mbedtls_aes_crypt_ecb(ctx, MBEDTLS_AES_ENCRYPT, nonce_counter, stream_block) != 0)
+        return -1;
+      for (int j = 15; j >= 0; j--) {
+        if (++nonce_counter[j] != 0)
+          break;
+      }
+    }
+    output[i] = input[i] ^ stream_block[n];
+    n = (n + 1) & 0x0F;
+  }
+  *nc_off = n;
+  return 0;
+}
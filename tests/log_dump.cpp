@@ -0,0 +1,76 @@
+#include "log_dump.h"
+
+#include <cstdlib>
+#include <sstream>
+
+namespace esphome {
+namespace dlms_cosem {
+namespace testing {
+
+namespace {
+
+int hex_value(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+}  // namespace
+
+uint32_t LogDump::header_u32(const std::string &key, uint32_t fallback) const {
+  auto it = this->header.find(key);
+  return it == this->header.end() ? fallback : strtoul(it->second.c_str(), nullptr, 10);
+}
+
+bool read_log_dump(std::istream &in, const std::string &kind, LogDump *out) {
+  const std::string header_marker = kind + " v1";
+  const std::string data_marker = kind + ":";
+  bool found = false;
+  bool damaged = false;
+  std::string line;
+  while (std::getline(in, line)) {
+    size_t at = line.find(header_marker);
+    if (at != std::string::npos) {
+      found = true;
+      damaged = false;
+      out->header.clear();
+      out->data.clear();
+      std::istringstream fields(line.substr(at + header_marker.size()));
+      std::string field;
+      while (fields >> field) {
+        size_t eq = field.find('=');
+        if (eq != std::string::npos)
+          out->header[field.substr(0, eq)] = field.substr(eq + 1);
+      }
+      continue;
+    }
+    at = line.find(data_marker);
+    if (!found || at == std::string::npos)
+      continue;
+    // hex up to the end of the line or the colour reset the logger appends
+    size_t pos = at + data_marker.size();
+    while (pos + 1 < line.size()) {
+      int hi = hex_value(line[pos]);
+      if (hi < 0)
+        break;
+      int lo = hex_value(line[pos + 1]);
+      if (lo < 0) {
+        damaged = true;
+        break;
+      }
+      out->data.push_back(static_cast<uint8_t>(hi << 4 | lo));
+      pos += 2;
+    }
+    if (pos + 1 == line.size() && hex_value(line[pos]) >= 0)
+      damaged = true;  // odd number of digits
+  }
+  return found && !damaged;
+}
+
+}  // namespace testing
+}  // namespace dlms_cosem
+}  // namespace esphome
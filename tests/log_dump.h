@@ -0,0 +1,31 @@
+#pragma once
+
+// Reads the hex dumps the component prints to the log (trace_dump(), capture_dump()) back into bytes.
+// Takes ESPHome log text as it comes from `esphome logs` or a serial console: colour codes, level and
+// tag prefixes and anything else on the line before the dump marker are ignored.
+
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace dlms_cosem {
+namespace testing {
+
+struct LogDump {
+  std::map<std::string, std::string> header;  // key=value pairs of the "<KIND> v1 ..." line
+  std::vector<uint8_t> data;
+
+  // header value as a number, fallback when the key is missing
+  uint32_t header_u32(const std::string &key, uint32_t fallback = 0) const;
+};
+
+// The last dump of this kind ("TRACE", "CAPTURE") in the log; false when there is none or its hex is
+// damaged. Lines of an earlier dump are discarded when a new header line starts.
+bool read_log_dump(std::istream &in, const std::string &kind, LogDump *out);
+
+}  // namespace testing
+}  // namespace dlms_cosem
+}  // namespace esphome
@@ -0,0 +1,390 @@
+#include "meter_emulator.h"
+
+#include "esphome/core/hal.h"
+#include "obis_index.h"
+
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+
+namespace esphome {
+namespace dlms_cosem {
+namespace testing {
+
+// HDLC control field
+static constexpr uint8_t HDLC_SNRM = 0x93;
+static constexpr uint8_t HDLC_DISC = 0x53;
+static constexpr uint8_t HDLC_UA = 0x73;
+static constexpr uint8_t HDLC_PF = 0x10;
+static constexpr uint8_t HDLC_FLAG = 0x7E;
+
+static const uint8_t LLC_REPLY[] = {0xE6, 0xE7, 0x00};
+
+// LN referencing, no security, conformance get/set/action/selective access/block transfer with get,
+// max PDU 256
+static const uint8_t AARE[] = {0x61, 0x29, 0xA1, 0x09, 0x06, 0x07, 0x60, 0x85, 0x74, 0x05, 0x08, 0x01, 0x01, 0xA2,
+                               0x03, 0x02, 0x01, 0x00, 0xA3, 0x05, 0xA1, 0x03, 0x02, 0x01, 0x00, 0xBE, 0x10, 0x04,
+                               0x0E, 0x08, 0x00, 0x06, 0x5F, 0x1F, 0x04, 0x00, 0x00, 0x10, 0x1D, 0x01, 0x00, 0x00,
+                               0x07};
+static const uint8_t RLRE[] = {0x63, 0x03, 0x80, 0x01, 0x00};
+
+bool MeterEmulator::Key::operator<(const Key &other) const {
+  return std::tie(this->class_id, this->obis[0], this->obis[1], this->obis[2], this->obis[3], this->obis[4],
+                  this->obis[5], this->attribute) < std::tie(other.class_id, other.obis[0], other.obis[1],
+                                                             other.obis[2], other.obis[3], other.obis[4],
+                                                             other.obis[5], other.attribute);
+}
+
+MeterEmulator::MeterEmulator(Config config) : config_(config), baud_rate_(config.baud_rate), rng_(config.seed) {}
+
+MeterEmulator::Key MeterEmulator::make_key_(uint16_t class_id, const char *obis, uint8_t attribute) {
+  Key key{class_id, {}, attribute};
+  obis_parse(obis, key.obis);
+  return key;
+}
+
+void MeterEmulator::add_object(uint16_t class_id, const char *obis, uint8_t attribute, std::vector<uint8_t> value) {
+  this->objects_[make_key_(class_id, obis, attribute)].value = std::move(value);
+}
+
+void MeterEmulator::add_register(const char *obis, std::vector<uint8_t> value, int8_t scaler, uint8_t unit) {
+  this->add_object(3, obis, 2, std::move(value));
+  this->add_object(3, obis, 3, scaler_unit(scaler, unit));
+}
+
+void MeterEmulator::add_access_error(uint16_t class_id, const char *obis, uint8_t attribute, uint8_t result) {
+  this->objects_[make_key_(class_id, obis, attribute)].access_result = result;
+}
+
+uint32_t MeterEmulator::get_requests(const char *obis, uint8_t attribute) const {
+  uint8_t bytes[6];
+  obis_parse(obis, bytes);
+  uint32_t n = 0;
+  for (const auto &it : this->objects_) {
+    if (memcmp(it.first.obis, bytes, 6) == 0 && it.first.attribute == attribute)
+      n += it.second.requests;
+  }
+  return n;
+}
+
+// ---------------------------------------------------------------- port side
+
+void MeterEmulator::release_() {
+  const uint64_t now = host::now_us();
+  if (this->ready_pos_ == this->ready_.size()) {
+    this->ready_.clear();
+    this->ready_pos_ = 0;
+  }
+  while (!this->tx_.empty() && this->tx_.front().at_us <= now) {
+    this->ready_.push_back(this->tx_.front().byte);
+    this->tx_.pop_front();
+  }
+}
+
+int MeterEmulator::available() {
+  this->release_();
+  return this->ready_.size() - this->ready_pos_;
+}
+
+bool MeterEmulator::read_array(uint8_t *data, size_t len) {
+  this->release_();
+  if (this->ready_.size() - this->ready_pos_ < len)
+    return false;
+  memcpy(data, this->ready_.data() + this->ready_pos_, len);
+  this->ready_pos_ += len;
+  return true;
+}
+
+void MeterEmulator::write_array(const uint8_t *data, size_t len) {
+  this->stats_.bytes_received += len;
+  this->rx_.insert(this->rx_.end(), data, data + len);
+  this->parse_frames_();
+}
+
+// ---------------------------------------------------------------- HDLC
+
+uint16_t MeterEmulator::fcs16(const uint8_t *data, size_t len) {
+  uint16_t fcs = 0xFFFF;
+  while (len--) {
+    fcs ^= *data++;
+    for (int i = 0; i < 8; i++)
+      fcs = (fcs & 1) ? (fcs >> 1) ^ 0x8408 : fcs >> 1;
+  }
+  return ~fcs;
+}
+
+std::vector<uint8_t> MeterEmulator::hdlc_frame(const std::vector<uint8_t> &dest, const std::vector<uint8_t> &src,
+                                               uint8_t control, const std::vector<uint8_t> &info, bool segmented) {
+  size_t length = 2 + dest.size() + src.size() + 1 + 2 + (info.empty() ? 0 : info.size() + 2);
+  std::vector<uint8_t> f = {HDLC_FLAG, static_cast<uint8_t>(0xA0 | (segmented ? 0x08 : 0) | ((length >> 8) & 0x07)),
+                            static_cast<uint8_t>(length & 0xFF)};
+  f.insert(f.end(), dest.begin(), dest.end());
+  f.insert(f.end(), src.begin(), src.end());
+  f.push_back(control);
+  uint16_t hcs = fcs16(f.data() + 1, f.size() - 1);
+  f.push_back(hcs & 0xFF);
+  f.push_back(hcs >> 8);
+  if (!info.empty()) {
+    f.insert(f.end(), info.begin(), info.end());
+    uint16_t fcs = fcs16(f.data() + 1, f.size() - 1);
+    f.push_back(fcs & 0xFF);
+    f.push_back(fcs >> 8);
+  }
+  f.push_back(HDLC_FLAG);
+  return f;
+}
+
+void MeterEmulator::parse_frames_() {
+  for (;;) {
+    auto flag = std::find(this->rx_.begin(), this->rx_.end(), HDLC_FLAG);
+    this->rx_.erase(this->rx_.begin(), flag);
+    if (this->rx_.size() < 3)
+      return;
+    if (this->rx_[1] == HDLC_FLAG || (this->rx_[1] & 0xF0) != 0xA0) {
+      // flag between frames, or not a frame start: resynchronize on the next flag
+      this->rx_.erase(this->rx_.begin());
+      continue;
+    }
+    size_t length = ((this->rx_[1] & 0x07) << 8) | this->rx_[2];
+    if (this->rx_.size() < length + 2)
+      return;
+    if (this->rx_[length + 1] != HDLC_FLAG) {
+      this->rx_.erase(this->rx_.begin());
+      continue;
+    }
+    this->handle_frame_(this->rx_.data() + 1, length);
+    // the closing flag may open the next frame
+    this->rx_.erase(this->rx_.begin(), this->rx_.begin() + length + 1);
+  }
+}
+
+void MeterEmulator::handle_frame_(const uint8_t *f, size_t len) {
+  // format (2), destination and source addresses (extension bit ends each), control, HCS [, info, FCS]
+  size_t pos = 2;
+  const size_t dest_start = pos;
+  while (pos < len && !(f[pos] & 0x01))
+    pos++;
+  const size_t src_start = ++pos;
+  while (pos < len && !(f[pos] & 0x01))
+    pos++;
+  const size_t control_pos = ++pos;
+  if (control_pos + 3 > len) {
+    this->stats_.fcs_errors++;
+    return;
+  }
+  const uint8_t control = f[control_pos];
+  const size_t header = control_pos + 1;
+  auto check = [&](size_t end) { return fcs16(f, end) == (f[end] | (f[end + 1] << 8)); };
+  const uint8_t *info = nullptr;
+  size_t info_len = 0;
+  if (len == header + 2) {
+    if (!check(header)) {
+      this->stats_.fcs_errors++;
+      return;
+    }
+  } else {
+    if (len < header + 4 || !check(header) || !check(len - 2)) {
+      this->stats_.fcs_errors++;
+      return;
+    }
+    info = f + header + 2;
+    info_len = len - header - 4;
+  }
+  this->stats_.frames_received++;
+  this->dest_.assign(f + src_start, f + control_pos);
+  this->src_.assign(f + dest_start, f + src_start);
+
+  if ((control & ~HDLC_PF) == (HDLC_SNRM & ~HDLC_PF)) {
+    this->stats_.sessions++;
+    this->vs_ = 0;
+    this->vr_ = 0;
+    this->last_reply_.clear();
+    const uint8_t hi = this->config_.max_info_field >> 8, lo = this->config_.max_info_field & 0xFF;
+    this->send_reply_(HDLC_UA, {0x81, 0x80, 0x14, 0x05, 0x02, hi, lo, 0x06, 0x02, hi, lo, 0x07, 0x04, 0x00, 0x00,
+                                0x00, 0x01, 0x08, 0x04, 0x00, 0x00, 0x00, 0x01});
+    return;
+  }
+  if ((control & ~HDLC_PF) == (HDLC_DISC & ~HDLC_PF)) {
+    this->vs_ = 0;
+    this->vr_ = 0;
+    this->last_reply_.clear();
+    this->send_reply_(HDLC_UA, {});
+    return;
+  }
+  if ((control & 0x01) == 0) {
+    // I frame
+    const uint8_t ns = (control >> 1) & 0x07;
+    if (ns == this->vr_) {
+      this->vr_ = (this->vr_ + 1) & 0x07;
+      auto reply = this->handle_apdu_(info, info_len);
+      if (!reply.empty())
+        this->send_i_frames_(reply);
+    } else if (ns == ((this->vr_ - 1) & 0x07) && !this->last_reply_.empty()) {
+      // our reply was lost and the client asks again: send the same frames
+      this->stats_.repeated_frames++;
+      if (this->drop_replies_ > 0) {
+        this->drop_replies_--;
+        this->stats_.replies_dropped++;
+        return;
+      }
+      for (const auto &frame : this->last_reply_)
+        this->queue_(frame);
+    }
+    return;
+  }
+  if ((control & 0x0F) == 0x01) {
+    // RR: nothing is held back, just acknowledge
+    this->send_reply_(static_cast<uint8_t>((this->vr_ << 5) | HDLC_PF | 0x01), {});
+  }
+}
+
+std::vector<uint8_t> MeterEmulator::handle_apdu_(const uint8_t *apdu, size_t len) {
+  if (len >= 3 && apdu[0] == 0xE6 && apdu[1] == 0xE6 && apdu[2] == 0x00) {
+    apdu += 3;
+    len -= 3;
+  }
+  std::vector<uint8_t> reply(LLC_REPLY, LLC_REPLY + sizeof(LLC_REPLY));
+  if (len == 0)
+    return {};
+  switch (apdu[0]) {
+    case 0x60:  // AARQ
+      reply.insert(reply.end(), AARE, AARE + sizeof(AARE));
+      break;
+    case 0x62:  // RLRQ
+      reply.insert(reply.end(), RLRE, RLRE + sizeof(RLRE));
+      break;
+    case 0xC0: {  // GET-Request
+      this->stats_.get_requests++;
+      const uint8_t invoke = len > 2 ? apdu[2] : 0;
+      reply.insert(reply.end(), {0xC4, 0x01, invoke});
+      if (len < 13 || apdu[1] != 0x01) {
+        reply.insert(reply.end(), {0x01, 0xFA});  // only GET-Request-Normal, other-reason
+        break;
+      }
+      Key key{static_cast<uint16_t>((apdu[3] << 8) | apdu[4]), {}, apdu[11]};
+      memcpy(key.obis, apdu + 5, 6);
+      auto it = this->objects_.find(key);
+      if (it == this->objects_.end()) {
+        reply.insert(reply.end(), {0x01, 0x04});  // object-undefined
+        break;
+      }
+      it->second.requests++;
+      if (it->second.access_result != 0) {
+        reply.insert(reply.end(), {0x01, it->second.access_result});
+      } else {
+        reply.push_back(0x00);
+        reply.insert(reply.end(), it->second.value.begin(), it->second.value.end());
+      }
+    } break;
+    default:
+      reply.insert(reply.end(), {0xD8, 0x01, 0x02});  // exception-response, service not supported
+      break;
+  }
+  return reply;
+}
+
+void MeterEmulator::send_reply_(uint8_t control, const std::vector<uint8_t> &info) {
+  if (this->drop_replies_ > 0) {
+    this->drop_replies_--;
+    this->stats_.replies_dropped++;
+    return;
+  }
+  this->queue_(hdlc_frame(this->dest_, this->src_, control, info));
+}
+
+void MeterEmulator::send_i_frames_(const std::vector<uint8_t> &info) {
+  // longer than the information field: segments sent back to back, the segmentation bit set on all but the last
+  const size_t max = std::max<size_t>(this->config_.max_info_field, 16);
+  this->last_reply_.clear();
+  for (size_t off = 0; off < info.size(); off += max) {
+    size_t n = std::min(max, info.size() - off);
+    uint8_t control = static_cast<uint8_t>((this->vr_ << 5) | HDLC_PF | (this->vs_ << 1));
+    this->vs_ = (this->vs_ + 1) & 0x07;
+    std::vector<uint8_t> chunk(info.begin() + off, info.begin() + off + n);
+    this->last_reply_.push_back(hdlc_frame(this->dest_, this->src_, control, chunk, off + n < info.size()));
+  }
+  if (this->drop_replies_ > 0) {
+    this->drop_replies_--;
+    this->stats_.replies_dropped++;
+    return;
+  }
+  for (const auto &frame : this->last_reply_)
+    this->queue_(frame);
+}
+
+void MeterEmulator::queue_(const std::vector<uint8_t> &frame) {
+  const uint64_t byte_us = 10000000ULL / std::max<uint32_t>(this->baud_rate_, 1);  // 8N1, 10 bits a byte
+  uint64_t at = std::max(this->tx_free_us_, host::now_us() + this->config_.turnaround_us);
+  std::uniform_int_distribution<uint32_t> jitter(0, this->config_.jitter_us);
+  std::uniform_real_distribution<double> error(0.0, 1.0);
+  std::uniform_int_distribution<int> bit(0, 7);
+  for (uint8_t b : frame) {
+    if (this->config_.jitter_us > 0)
+      at += jitter(this->rng_);
+    if (this->config_.byte_error_rate > 0.0 && error(this->rng_) < this->config_.byte_error_rate)
+      b ^= 1 << bit(this->rng_);
+    at += byte_us;
+    this->tx_.push_back({at, b});
+  }
+  this->tx_free_us_ = at;
+  this->stats_.frames_sent++;
+  this->stats_.bytes_sent += frame.size();
+}
+
+// ---------------------------------------------------------------- A-XDR values
+
+std::vector<uint8_t> MeterEmulator::uint16(uint16_t value) {
+  return {0x12, static_cast<uint8_t>(value >> 8), static_cast<uint8_t>(value)};
+}
+
+std::vector<uint8_t> MeterEmulator::uint32(uint32_t value) {
+  return {0x06, static_cast<uint8_t>(value >> 24), static_cast<uint8_t>(value >> 16), static_cast<uint8_t>(value >> 8),
+          static_cast<uint8_t>(value)};
+}
+
+std::vector<uint8_t> MeterEmulator::int16(int16_t value) {
+  auto v = uint16(static_cast<uint16_t>(value));
+  v[0] = 0x10;
+  return v;
+}
+
+std::vector<uint8_t> MeterEmulator::int32(int32_t value) {
+  auto v = uint32(static_cast<uint32_t>(value));
+  v[0] = 0x05;
+  return v;
+}
+
+std::vector<uint8_t> MeterEmulator::float32(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  auto v = uint32(bits);
+  v[0] = 0x17;
+  return v;
+}
+
+std::vector<uint8_t> MeterEmulator::octet_string(const std::string &value) {
+  std::vector<uint8_t> v = {0x09, static_cast<uint8_t>(value.size())};
+  v.insert(v.end(), value.begin(), value.end());
+  return v;
+}
+
+std::vector<uint8_t> MeterEmulator::visible_string(const std::string &value) {
+  auto v = octet_string(value);
+  v[0] = 0x0A;
+  return v;
+}
+
+std::vector<uint8_t> MeterEmulator::date_time(uint16_t year, uint8_t month, uint8_t day, uint8_t hour,
+                                              uint8_t minute, uint8_t second) {
+  // octet-string(12): year, month, day, day of week (not specified), time, hundredths, deviation, status
+  return {0x09,   0x0C,   static_cast<uint8_t>(year >> 8), static_cast<uint8_t>(year), month, day, 0xFF, hour,
+          minute, second, 0x00,                            0x80,                       0x00,  0x00};
+}
+
+std::vector<uint8_t> MeterEmulator::scaler_unit(int8_t scaler, uint8_t unit) {
+  return {0x02, 0x02, 0x0F, static_cast<uint8_t>(scaler), 0x16, unit};
+}
+
+}  // namespace testing
+}  // namespace dlms_cosem
+}  // namespace esphome
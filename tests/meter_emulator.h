@@ -0,0 +1,134 @@
+#pragma once
+
+// Software DLMS/COSEM meter behind a DlmsCosemPort: answers SNRM, AARQ, GET, RLRQ and DISC over HDLC
+// with configurable objects, turnaround, inter-byte jitter, bit errors, lost replies and frame size.
+// Time is the host shim's simulated clock, so sessions are repeatable and run faster than real time.
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "dlms_cosem_port.h"
+
+namespace esphome {
+namespace dlms_cosem {
+namespace testing {
+
+class MeterEmulator final : public DlmsCosemPort {
+ public:
+  struct Config {
+    uint32_t baud_rate{9600};
+    uint32_t turnaround_us{20000};  // end of request to first reply byte
+    uint32_t jitter_us{0};          // extra gap before each reply byte, uniform 0..jitter_us
+    double byte_error_rate{0.0};    // probability of one flipped bit in a reply byte
+    uint16_t max_info_field{128};   // HDLC information field limit, longer replies are segmented
+    uint32_t seed{1};
+  };
+
+  struct Stats {
+    uint32_t frames_received{0};
+    uint32_t frames_sent{0};
+    uint32_t bytes_received{0};
+    uint32_t bytes_sent{0};
+    uint32_t fcs_errors{0};       // request frames ignored for a bad HCS/FCS
+    uint32_t repeated_frames{0};  // requests sent again by the client, answered with the last reply
+    uint32_t replies_dropped{0};  // replies lost on purpose, see drop_replies()
+    uint32_t sessions{0};         // SNRMs
+    uint32_t get_requests{0};
+  };
+
+  MeterEmulator() : MeterEmulator(Config{}) {}
+  explicit MeterEmulator(Config config);
+
+  // value is the A-XDR encoded attribute, e.g. uint32(230)
+  void add_object(uint16_t class_id, const char *obis, uint8_t attribute, std::vector<uint8_t> value);
+  // register (class 3): value as attribute 2, scaler and unit as attribute 3
+  void add_register(const char *obis, std::vector<uint8_t> value, int8_t scaler, uint8_t unit);
+  // GET for this attribute is answered with a data-access-result
+  void add_access_error(uint16_t class_id, const char *obis, uint8_t attribute, uint8_t result);
+
+  // the next n replies are sent by the meter but lost on the line
+  void drop_replies(uint32_t n) { this->drop_replies_ += n; }
+
+  const Stats &stats() const { return this->stats_; }
+  uint32_t get_requests(const char *obis, uint8_t attribute) const;
+  uint32_t baud_rate() const { return this->baud_rate_; }
+
+  // DlmsCosemPort
+  int available() override;
+  bool read_byte(uint8_t *data) override { return this->read_array(data, 1); }
+  bool read_array(uint8_t *data, size_t len) override;
+  void write_array(const uint8_t *data, size_t len) override;
+  void set_baud_rate(uint32_t baud_rate) override { this->baud_rate_ = baud_rate; }
+
+  // HDLC helpers, also used by the tests to build requests
+  static uint16_t fcs16(const uint8_t *data, size_t len);
+  static std::vector<uint8_t> hdlc_frame(const std::vector<uint8_t> &dest, const std::vector<uint8_t> &src,
+                                         uint8_t control, const std::vector<uint8_t> &info, bool segmented = false);
+
+  // A-XDR encoders for object values
+  static std::vector<uint8_t> uint8(uint8_t value) { return {0x11, value}; }
+  static std::vector<uint8_t> uint16(uint16_t value);
+  static std::vector<uint8_t> uint32(uint32_t value);
+  static std::vector<uint8_t> int16(int16_t value);
+  static std::vector<uint8_t> int32(int32_t value);
+  static std::vector<uint8_t> float32(float value);
+  static std::vector<uint8_t> octet_string(const std::string &value);
+  static std::vector<uint8_t> visible_string(const std::string &value);
+  static std::vector<uint8_t> date_time(uint16_t year, uint8_t month, uint8_t day, uint8_t hour, uint8_t minute,
+                                        uint8_t second);
+  static std::vector<uint8_t> scaler_unit(int8_t scaler, uint8_t unit);
+
+ protected:
+  struct Key {
+    uint16_t class_id;
+    uint8_t obis[6];
+    uint8_t attribute;
+    bool operator<(const Key &other) const;
+  };
+  struct Object {
+    std::vector<uint8_t> value;
+    uint8_t access_result{0};
+    uint32_t requests{0};
+  };
+  struct TxByte {
+    uint64_t at_us;
+    uint8_t byte;
+  };
+
+  static Key make_key_(uint16_t class_id, const char *obis, uint8_t attribute);
+  void parse_frames_();
+  void handle_frame_(const uint8_t *frame, size_t len);
+  std::vector<uint8_t> handle_apdu_(const uint8_t *apdu, size_t len);
+  void send_reply_(uint8_t control, const std::vector<uint8_t> &info);
+  void send_i_frames_(const std::vector<uint8_t> &info);
+  void queue_(const std::vector<uint8_t> &frame);
+  void release_();
+
+  Config config_;
+  uint32_t baud_rate_;
+  std::mt19937 rng_;
+  std::map<Key, Object> objects_;
+  Stats stats_{};
+
+  std::vector<uint8_t> rx_;       // request bytes not parsed yet
+  std::deque<TxByte> tx_;         // reply bytes with the time they appear on the line
+  std::vector<uint8_t> ready_;    // reply bytes already on the line
+  size_t ready_pos_{0};
+  uint64_t tx_free_us_{0};        // when the line is free for the next reply byte
+
+  std::vector<uint8_t> dest_;     // reply addressing, swapped from the last request
+  std::vector<uint8_t> src_;
+  uint8_t vs_{0};                 // HDLC send and receive state variables
+  uint8_t vr_{0};
+  std::vector<std::vector<uint8_t>> last_reply_;  // frames of the last reply, sent again on a repeated request
+  uint32_t drop_replies_{0};
+};
+
+}  // namespace testing
+}  // namespace dlms_cosem
+}  // namespace esphome
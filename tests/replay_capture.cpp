@@ -0,0 +1,124 @@
+// Replays a pull session recorded on the device into the host-built component and checks it against
+// a baseline. Record with capture_size set and id(meter).capture_dump(), save the log, then:
+//
+//   replay_capture [options] <log file>
+//     -sensor=<class>:<obis>   numeric object to read (repeat); default: the objects requested in the capture
+//     -text=<class>:<obis>     text object to read (repeat)
+//     -client=N -server=N -password=S -baud=N   as in the device configuration
+//     -write-baseline=<file>   save values and session time of this run
+//     -baseline=<file>         compare with a saved run, exit code 1 on differences
+//     -tolerance=<percent>     how much slower than the baseline the session may be, default 10
+
+#include "log_dump.h"
+#include "replay_session.h"
+#include "esphome/core/log.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+using namespace esphome;
+using namespace esphome::dlms_cosem::testing;
+
+namespace {
+
+bool option(const char *arg, const char *name, const char **value) {
+  size_t n = strlen(name);
+  if (strncmp(arg, name, n) != 0 || arg[n] != '=')
+    return false;
+  *value = arg + n + 1;
+  return true;
+}
+
+bool parse_object(const char *arg, bool text, ReplayObject *out) {
+  const char *colon = strchr(arg, ':');
+  if (colon == nullptr)
+    return false;
+  *out = {static_cast<uint16_t>(atoi(arg)), colon + 1, text};
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  ReplayConfig config;
+  const char *log_file = nullptr, *baseline_file = nullptr, *write_file = nullptr;
+  double tolerance = 10.0;
+  for (int i = 1; i < argc; i++) {
+    const char *v;
+    ReplayObject object;
+    if (option(argv[i], "-sensor", &v) || option(argv[i], "-text", &v)) {
+      if (!parse_object(v, argv[i][1] == 't', &object)) {
+        fprintf(stderr, "Expected <class>:<obis>, got %s\n", v);
+        return 2;
+      }
+      config.objects.push_back(object);
+    } else if (option(argv[i], "-client", &v)) {
+      config.client_address = atoi(v);
+    } else if (option(argv[i], "-server", &v)) {
+      config.server_address = atoi(v);
+    } else if (option(argv[i], "-password", &v)) {
+      config.password = v;
+    } else if (option(argv[i], "-baud", &v)) {
+      config.baud_rate = strtoul(v, nullptr, 10);
+    } else if (option(argv[i], "-baseline", &v)) {
+      baseline_file = v;
+    } else if (option(argv[i], "-write-baseline", &v)) {
+      write_file = v;
+    } else if (option(argv[i], "-tolerance", &v)) {
+      tolerance = atof(v);
+    } else if (argv[i][0] != '-') {
+      log_file = argv[i];
+    } else {
+      fprintf(stderr, "Unknown option %s\n", argv[i]);
+      return 2;
+    }
+  }
+  if (log_file == nullptr) {
+    fprintf(stderr, "Usage: %s [options] <log file with capture_dump() output>\n", argv[0]);
+    return 2;
+  }
+
+  std::ifstream log(log_file);
+  LogDump dump;
+  if (!read_log_dump(log, "CAPTURE", &dump) || dump.data.empty()) {
+    fprintf(stderr, "No complete CAPTURE dump in %s\n", log_file);
+    return 2;
+  }
+  if (dump.header_u32("dropped") > 0)
+    fprintf(stderr, "Warning: %u bytes did not fit the capture buffer, the end of the session is missing\n",
+            dump.header_u32("dropped"));
+  if (config.objects.empty())
+    config.objects = objects_in_capture(dump.data);
+  if (config.objects.empty()) {
+    fprintf(stderr, "No GET requests found in the capture (ciphered?), list the objects with -sensor/-text\n");
+    return 2;
+  }
+
+  host::set_print_level(ESPHOME_LOG_LEVEL_WARN);
+  const auto run = replay_session(dump.data, config);
+  printf("session %.1f ms simulated, %zu TX bytes differ, %s\n", run.session_ms, run.tx_mismatches,
+         run.finished ? "capture played to the end" : "stopped before the end of the capture");
+  for (const auto &v : run.values)
+    printf("  %-20s %s\n", v.first.c_str(), v.second.empty() ? "(nothing published)" : v.second.c_str());
+
+  if (write_file != nullptr) {
+    std::ofstream out(write_file);
+    out << format_baseline(run);
+  }
+  if (baseline_file == nullptr)
+    return 0;
+  std::ifstream in(baseline_file);
+  ReplayResult baseline;
+  if (!read_baseline(in, &baseline)) {
+    fprintf(stderr, "Cannot read the baseline %s\n", baseline_file);
+    return 2;
+  }
+  const auto diffs = compare_with_baseline(baseline, run, tolerance);
+  printf("baseline: session %.1f ms, this run %+.1f%%\n", baseline.session_ms,
+         baseline.session_ms > 0 ? (run.session_ms / baseline.session_ms - 1.0) * 100.0 : 0.0);
+  for (const auto &d : diffs)
+    printf("  DIFF %s\n", d.c_str());
+  return diffs.empty() ? 0 : 1;
+}
@@ -0,0 +1,207 @@
+#include "replay_session.h"
+
+#include "dlms_cosem.h"
+#include "port_capture.h"
+#include "esphome/core/hal.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+
+namespace esphome {
+namespace dlms_cosem {
+namespace testing {
+
+namespace {
+
+constexpr uint64_t SESSION_LIMIT_US = 600000000ULL;  // give up on a replay that never ends
+constexpr uint32_t PUBLISH_MS = 2000;                // after the last recorded byte
+constexpr uint32_t BOOT_MS = 11000;                  // past the component's boot wait
+
+std::vector<uint8_t> tx_stream(const std::vector<uint8_t> &capture) {
+  std::vector<uint8_t> out;
+  for (size_t pos = 0; pos + CAPTURE_HEADER_SIZE <= capture.size();) {
+    const uint8_t *hdr = capture.data() + pos;
+    size_t len = std::min<size_t>(hdr[3], capture.size() - pos - CAPTURE_HEADER_SIZE);
+    if (hdr[2] == CAPTURE_TX)
+      out.insert(out.end(), hdr + CAPTURE_HEADER_SIZE, hdr + CAPTURE_HEADER_SIZE + len);
+    pos += CAPTURE_HEADER_SIZE + len;
+  }
+  return out;
+}
+
+// HDLC address field: bytes up to the one with the low bit set
+size_t skip_address(const std::vector<uint8_t> &d, size_t pos, size_t end) {
+  for (size_t n = 0; pos < end && n < 4; n++) {
+    if (d[pos++] & 0x01)
+      return pos;
+  }
+  return end;
+}
+
+std::string format_obis(const uint8_t *o) {
+  char buf[24];
+  snprintf(buf, sizeof(buf), "%u.%u.%u.%u.%u.%u", o[0], o[1], o[2], o[3], o[4], o[5]);
+  return buf;
+}
+
+}  // namespace
+
+std::vector<ReplayObject> objects_in_capture(const std::vector<uint8_t> &capture) {
+  static const uint8_t GET_REQUEST_NORMAL[] = {0xE6, 0xE6, 0x00, 0xC0, 0x01};
+  std::vector<ReplayObject> out;
+  const auto tx = tx_stream(capture);
+  for (size_t pos = 0; pos + 3 <= tx.size();) {
+    if (tx[pos] != 0x7E || (tx[pos + 1] & 0xF0) != 0xA0) {
+      pos++;
+      continue;
+    }
+    const size_t length = (tx[pos + 1] & 0x07) << 8 | tx[pos + 2];
+    const size_t end = std::min(tx.size(), pos + 1 + length);
+    size_t p = skip_address(tx, pos + 3, end);
+    p = skip_address(tx, p, end);
+    p += 1 + 2;  // control, HCS
+    // LLC, GET-Request-Normal, invoke id, class (2), OBIS (6), attribute
+    if (p + sizeof(GET_REQUEST_NORMAL) + 10 <= end && std::equal(std::begin(GET_REQUEST_NORMAL),
+                                                                std::end(GET_REQUEST_NORMAL), tx.begin() + p)) {
+      const uint8_t *req = tx.data() + p + sizeof(GET_REQUEST_NORMAL) + 1;
+      const uint16_t class_id = req[0] << 8 | req[1];
+      const std::string obis = format_obis(req + 2);
+      const bool known = std::any_of(out.begin(), out.end(), [&](const ReplayObject &o) { return o.obis == obis; });
+      if (req[8] == 2 && !known)
+        out.push_back({class_id, obis, false});
+    }
+    pos += 1 + length + 1;
+  }
+  return out;
+}
+
+ReplayResult replay_session(const std::vector<uint8_t> &capture, const ReplayConfig &config) {
+  DlmsCosemComponent hub;
+  auto port = std::make_unique<ReplayPort>(capture);
+  ReplayPort *replay = port.get();
+  hub.set_port(std::move(port));
+  hub.set_baud_rates(config.baud_rate, config.baud_rate);
+  hub.set_client_address(config.client_address);
+  hub.set_server_address(config.server_address);
+  if (!config.password.empty()) {
+    hub.set_auth_required(true);
+    hub.set_password(config.password);
+  }
+  hub.set_update_interval(3600000);
+
+  // one sensor per object, in the order of config.objects
+  std::vector<std::unique_ptr<DlmsCosemSensor>> sensors;
+  std::vector<std::unique_ptr<DlmsCosemTextSensor>> text_sensors;
+  for (const auto &o : config.objects) {
+    DlmsCosemSensorBase *base;
+    if (o.text) {
+      text_sensors.push_back(std::make_unique<DlmsCosemTextSensor>());
+      sensors.emplace_back();
+      base = text_sensors.back().get();
+    } else {
+      sensors.push_back(std::make_unique<DlmsCosemSensor>());
+      text_sensors.emplace_back();
+      base = sensors.back().get();
+    }
+    base->set_obis_code(o.obis.c_str());
+    base->set_obis_class(o.class_id);
+    hub.register_sensor(base);
+  }
+
+  ReplayResult result;
+  hub.call_setup();
+  // the poll right after setup() falls into the boot wait, the session starts with the next one
+  host::run_for(&hub, BOOT_MS);
+  hub.update();
+  const uint64_t start = host::now_us();
+  while (!replay->finished() && host::now_us() - start < SESSION_LIMIT_US)
+    host::run_for(&hub, 1);
+  result.session_ms = (host::now_us() - start) / 1000.0;
+  host::run_for(&hub, PUBLISH_MS);
+  result.finished = replay->finished();
+  result.tx_mismatches = replay->tx_mismatches();
+
+  for (size_t i = 0; i < config.objects.size(); i++) {
+    std::string state;
+    if (sensors[i] && !sensors[i]->published.empty()) {
+      char buf[32];
+      snprintf(buf, sizeof(buf), "%.9g", sensors[i]->published.back());
+      state = buf;
+    } else if (text_sensors[i] && !text_sensors[i]->published.empty()) {
+      state = text_sensors[i]->published.back();
+    }
+    result.values.emplace_back(config.objects[i].obis, state);
+  }
+  return result;
+}
+
+std::string format_baseline(const ReplayResult &result) {
+  std::ostringstream out;
+  char ms[32];
+  snprintf(ms, sizeof(ms), "%.1f", result.session_ms);
+  out << "# replay_capture baseline\n";
+  out << "session_ms " << ms << "\n";
+  out << "tx_mismatches " << result.tx_mismatches << "\n";
+  for (const auto &v : result.values)
+    out << "value " << v.first << " " << v.second << "\n";
+  return out.str();
+}
+
+bool read_baseline(std::istream &in, ReplayResult *out) {
+  bool have_time = false;
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty() || line[0] == '#')
+      continue;
+    std::istringstream fields(line);
+    std::string key;
+    fields >> key;
+    if (key == "session_ms") {
+      fields >> out->session_ms;
+      have_time = !fields.fail();
+    } else if (key == "tx_mismatches") {
+      fields >> out->tx_mismatches;
+    } else if (key == "value") {
+      std::string obis, state;
+      fields >> obis;
+      std::getline(fields >> std::ws, state);
+      out->values.emplace_back(obis, state);
+    }
+  }
+  out->finished = true;
+  return have_time;
+}
+
+std::vector<std::string> compare_with_baseline(const ReplayResult &baseline, const ReplayResult &run,
+                                               double tolerance_percent) {
+  std::vector<std::string> diffs;
+  char buf[160];
+  if (!run.finished)
+    diffs.push_back("the replay stopped before the end of the capture");
+  if (run.tx_mismatches > baseline.tx_mismatches) {
+    snprintf(buf, sizeof(buf), "%zu TX bytes differ from the capture, baseline %zu", run.tx_mismatches,
+             baseline.tx_mismatches);
+    diffs.push_back(buf);
+  }
+  if (run.session_ms > baseline.session_ms * (1.0 + tolerance_percent / 100.0)) {
+    snprintf(buf, sizeof(buf), "session %.1f ms, baseline %.1f ms (+%.1f%%)", run.session_ms, baseline.session_ms,
+             (run.session_ms / baseline.session_ms - 1.0) * 100.0);
+    diffs.push_back(buf);
+  }
+  for (const auto &b : baseline.values) {
+    auto it = std::find_if(run.values.begin(), run.values.end(), [&](const auto &v) { return v.first == b.first; });
+    if (it == run.values.end()) {
+      diffs.push_back(b.first + ": not replayed");
+    } else if (it->second != b.second) {
+      diffs.push_back(b.first + ": \"" + it->second + "\", baseline \"" + b.second + "\"");
+    }
+  }
+  return diffs;
+}
+
+}  // namespace testing
+}  // namespace dlms_cosem
+}  // namespace esphome
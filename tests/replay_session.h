@@ -0,0 +1,53 @@
+#pragma once
+
+// Replays a pull session captured on the device (capture_size, capture_dump()) into the host-built
+// component through ReplayPort, and compares the outcome with a baseline: what was published and
+// how long the session took in simulated time.
+
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace dlms_cosem {
+namespace testing {
+
+struct ReplayObject {
+  uint16_t class_id;
+  std::string obis;
+  bool text;
+};
+
+struct ReplayConfig {
+  std::vector<ReplayObject> objects;
+  uint16_t client_address{16};
+  uint16_t server_address{1};
+  std::string password;
+  uint32_t baud_rate{9600};
+};
+
+struct ReplayResult {
+  double session_ms{0};
+  size_t tx_mismatches{0};
+  bool finished{false};                                      // every recorded byte was played
+  std::vector<std::pair<std::string, std::string>> values;   // OBIS code, last published state
+};
+
+// the objects the component asked for (attribute 2 of plain GET requests in the TX frames), in order
+std::vector<ReplayObject> objects_in_capture(const std::vector<uint8_t> &capture);
+
+ReplayResult replay_session(const std::vector<uint8_t> &capture, const ReplayConfig &config);
+
+// baseline file: "session_ms <ms>", "tx_mismatches <n>", "value <obis> <state>" lines, '#' comments
+std::string format_baseline(const ReplayResult &result);
+bool read_baseline(std::istream &in, ReplayResult *out);
+
+// differences worth failing for: other values, TX mismatches, or a session more than
+// tolerance_percent slower than the baseline
+std::vector<std::string> compare_with_baseline(const ReplayResult &baseline, const ReplayResult &run,
+                                               double tolerance_percent);
+
+}  // namespace testing
+}  // namespace dlms_cosem
+}  // namespace esphome
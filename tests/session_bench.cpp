@@ -0,0 +1,80 @@
+// Pull session benchmark against the meter emulator: simulated session time, frames and bytes per
+// object and retries, for a number of objects over a clean and a noisy line.
+//
+//   session_bench [objects] [baud_rate] [byte_error_rate]
+
+#include "dlms_cosem.h"
+#include "meter_emulator.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::dlms_cosem;
+using namespace esphome::dlms_cosem::testing;
+
+int main(int argc, char **argv) {
+  const int objects = argc > 1 ? atoi(argv[1]) : 20;
+  MeterEmulator::Config config;
+  config.baud_rate = argc > 2 ? strtoul(argv[2], nullptr, 10) : 9600;
+  config.byte_error_rate = argc > 3 ? atof(argv[3]) : 0.0;
+  host::set_print_level(ESPHOME_LOG_LEVEL_WARN);
+
+  DlmsCosemComponent hub;
+  auto port = std::make_unique<MeterEmulator>(config);
+  MeterEmulator *meter = port.get();
+  hub.set_port(std::move(port));
+  hub.set_baud_rates(config.baud_rate, config.baud_rate);
+  hub.set_update_interval(3600000);
+
+  std::vector<std::unique_ptr<DlmsCosemSensor>> sensors;
+  for (int i = 0; i < objects; i++) {
+    char obis[24];
+    snprintf(obis, sizeof(obis), "1.0.%d.%d.0.255", 1 + i / 8, 1 + i % 8);
+    meter->add_register(obis, MeterEmulator::uint32(1000 + i), -1, 30);
+    auto s = std::make_unique<DlmsCosemSensor>();
+    s->set_obis_code(obis);
+    s->set_obis_class(3);
+    hub.register_sensor(s.get());
+    sensors.push_back(std::move(s));
+  }
+
+  hub.call_setup();
+  host::run_for(&hub, 11000);  // the component's boot wait, the poll right after setup() is ignored
+  hub.update();
+  const uint64_t sim_start = host::now_us();
+  const auto wall_start = std::chrono::steady_clock::now();
+  // one session: every object read once (or given up on), then release and disconnect
+  for (uint32_t reads = 0; reads < (uint32_t) objects && host::now_us() - sim_start < 600000000ULL;) {
+    host::run_for(&hub, 100);
+    reads = 0;
+    for (auto &s : sensors)
+      reads += s->telemetry().reads;
+  }
+  const double sim_ms = (host::now_us() - sim_start) / 1000.0;
+  host::run_for(&hub, 2000);
+  const double wall_ms =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wall_start).count();
+
+  uint32_t published = 0, retries = 0;
+  for (auto &s : sensors) {
+    published += s->published.size();
+    retries += s->telemetry().retries;
+  }
+  const auto &st = meter->stats();
+  printf("objects %d, baud %u, byte error rate %g\n", objects, config.baud_rate, config.byte_error_rate);
+  printf("  session       %.0f ms simulated, %.2f ms/object (host %.1f ms)\n", sim_ms, sim_ms / objects, wall_ms);
+  printf("  published     %u of %d, %u retries\n", published, objects, retries);
+  printf("  frames        %u sent / %u received, %.2f per object\n", st.frames_received, st.frames_sent,
+         double(st.frames_received + st.frames_sent) / objects);
+  printf("  bytes         %u sent / %u received, %.1f per object\n", st.bytes_received, st.bytes_sent,
+         double(st.bytes_received + st.bytes_sent) / objects);
+  printf("  meter         %u GET, %u repeated requests, %u bad request frames\n", st.get_requests,
+         st.repeated_frames, st.fcs_errors);
+  return published == (uint32_t) objects || config.byte_error_rate > 0.0 ? 0 : 1;
+}
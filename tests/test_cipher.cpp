@@ -0,0 +1,125 @@
+// Security suite 0 push decryption against the published DLMS example (Green Book, AES-GCM-128)
+
+#include "dlms_test.h"
+
+#include "dlms_cipher.h"
+#include "esphome/core/log.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::dlms_cosem;
+
+namespace {
+
+// EK 000102..0F, AK D0D1..DF, system title 4D4D4D0000BC614E, invocation counter 01234567,
+// plaintext C0 01 00 00 08 00 00 01 00 00 FF 02 00 (get-request for the clock)
+const uint8_t EK[16] = {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+                        0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F};
+const uint8_t AK[16] = {0xD0, 0xD1, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7,
+                        0xD8, 0xD9, 0xDA, 0xDB, 0xDC, 0xDD, 0xDE, 0xDF};
+const uint8_t PLAIN[] = {0xC0, 0x01, 0x00, 0x00, 0x08, 0x00, 0x00, 0x01, 0x00, 0x00, 0xFF, 0x02, 0x00};
+
+// general-glo-ciphering, SC 0x30 (authenticated and encrypted), ciphertext 4113..BC, tag 7D82..6B
+std::vector<uint8_t> glo_ciphered(uint8_t sc = 0x30) {
+  return {0xDB, 0x08, 0x4D, 0x4D, 0x4D, 0x00, 0x00, 0xBC, 0x61, 0x4E, 0x1E, sc,   0x01, 0x23, 0x45, 0x67,
+          0x41, 0x13, 0x12, 0xFF, 0x93, 0x5A, 0x47, 0x56, 0x68, 0x27, 0xC4, 0x67, 0xBC, 0x7D, 0x82, 0x5C,
+          0x3B, 0xE4, 0xA7, 0x7C, 0x3F, 0xCC, 0x05, 0x6B, 0x6B};
+}
+
+}  // namespace
+
+TEST_CASE(known_answer_authenticated_and_encrypted) {
+  DlmsCipher cipher;
+  cipher.set_decryption_key(EK);
+  cipher.set_authentication_key(AK);
+
+  auto apdu = glo_ciphered();
+  size_t plain_len = 0;
+  CHECK(cipher.decrypt_in_place(apdu.data(), apdu.size(), plain_len) == DlmsCipher::Result::OK);
+  CHECK_EQ(plain_len, sizeof(PLAIN));
+  CHECK(memcmp(apdu.data(), PLAIN, sizeof(PLAIN)) == 0);
+  CHECK_EQ(cipher.last_invocation_counter(), 0x01234567u);
+}
+
+TEST_CASE(tampered_ciphertext_or_tag_is_rejected) {
+  DlmsCipher cipher;
+  cipher.set_decryption_key(EK);
+  cipher.set_authentication_key(AK);
+
+  for (size_t pos : {16u, 28u, 29u, 40u}) {
+    auto apdu = glo_ciphered();
+    apdu[pos] ^= 0x01;
+    size_t plain_len = 0;
+    CHECK(cipher.decrypt_in_place(apdu.data(), apdu.size(), plain_len) == DlmsCipher::Result::AUTH_FAILED);
+    CHECK_EQ(plain_len, 0u);
+  }
+
+  // a different authentication key changes the AAD
+  DlmsCipher other;
+  uint8_t ak[16];
+  memcpy(ak, AK, sizeof(ak));
+  ak[0] ^= 0xFF;
+  other.set_decryption_key(EK);
+  other.set_authentication_key(ak);
+  auto apdu = glo_ciphered();
+  size_t plain_len = 0;
+  CHECK(other.decrypt_in_place(apdu.data(), apdu.size(), plain_len) == DlmsCipher::Result::AUTH_FAILED);
+}
+
+TEST_CASE(authenticated_apdu_without_authentication_key_is_dropped) {
+  DlmsCipher cipher;
+  cipher.set_decryption_key(EK);
+  host::clear_log();
+
+  for (int i = 0; i < 3; i++) {
+    auto apdu = glo_ciphered();
+    size_t plain_len = 0;
+    CHECK(cipher.decrypt_in_place(apdu.data(), apdu.size(), plain_len) == DlmsCipher::Result::AUTH_FAILED);
+    CHECK_EQ(plain_len, 0u);
+  }
+  // one warning, not one per telegram
+  CHECK_EQ(host::count_log(ESPHOME_LOG_LEVEL_WARN, "no authentication_key"), 1u);
+}
+
+TEST_CASE(encryption_only_apdu_needs_no_authentication_key) {
+  // SC 0x20: same keystream, no tag; the ciphertext is the first 13 bytes of the vector above
+  std::vector<uint8_t> apdu = {0xDB, 0x08, 0x4D, 0x4D, 0x4D, 0x00, 0x00, 0xBC, 0x61, 0x4E, 0x12, 0x20,
+                               0x01, 0x23, 0x45, 0x67, 0x41, 0x13, 0x12, 0xFF, 0x93, 0x5A, 0x47, 0x56,
+                               0x68, 0x27, 0xC4, 0x67, 0xBC};
+  DlmsCipher cipher;
+  cipher.set_decryption_key(EK);
+  size_t plain_len = 0;
+  CHECK(cipher.decrypt_in_place(apdu.data(), apdu.size(), plain_len) == DlmsCipher::Result::OK);
+  CHECK_EQ(plain_len, sizeof(PLAIN));
+  CHECK(memcmp(apdu.data(), PLAIN, sizeof(PLAIN)) == 0);
+}
+
+TEST_CASE(malformed_and_unsupported_apdus) {
+  DlmsCipher cipher;
+  cipher.set_decryption_key(EK);
+  cipher.set_authentication_key(AK);
+  size_t plain_len = 0;
+
+  auto truncated = glo_ciphered();
+  truncated.resize(20);
+  CHECK(cipher.decrypt_in_place(truncated.data(), truncated.size(), plain_len) == DlmsCipher::Result::MALFORMED);
+
+  // authentication only (SC 0x10) and other suites are not supported
+  auto auth_only = glo_ciphered(0x10);
+  CHECK(cipher.decrypt_in_place(auth_only.data(), auth_only.size(), plain_len) == DlmsCipher::Result::UNSUPPORTED);
+  auto suite1 = glo_ciphered(0x31);
+  CHECK(cipher.decrypt_in_place(suite1.data(), suite1.size(), plain_len) == DlmsCipher::Result::UNSUPPORTED);
+
+  // general-ded-ciphering is not tried with the global key, even when it would authenticate
+  auto ded = glo_ciphered();
+  ded[0] = DLMS_GENERAL_DED_CIPHERING;
+  host::clear_log();
+  CHECK(cipher.decrypt_in_place(ded.data(), ded.size(), plain_len) == DlmsCipher::Result::UNSUPPORTED);
+  CHECK_EQ(plain_len, 0u);
+  CHECK_EQ(host::count_log(ESPHOME_LOG_LEVEL_WARN, "general-ded-ciphering"), 1u);
+
+  uint8_t plain[] = {0x0F, 0x00, 0x00, 0x00, 0x01};
+  CHECK(cipher.decrypt_in_place(plain, sizeof(plain), plain_len) == DlmsCipher::Result::NOT_CIPHERED);
+}
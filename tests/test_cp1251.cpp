@@ -0,0 +1,83 @@
+// CP1251 to UTF-8: the whole code page against iconv, the ASCII word path, truncation
+
+#include "dlms_test.h"
+
+#include "cp1251.h"
+
+#include <cstring>
+#include <iconv.h>
+#include <string>
+
+using namespace esphome::dlms_cosem;
+
+namespace {
+
+std::string convert(const std::string &cp1251, size_t dst_size = 1024) {
+  std::string out(dst_size, '\x7F');
+  size_t n = cp1251_to_utf8(reinterpret_cast<const uint8_t *>(cp1251.data()), cp1251.size(), out.data(), dst_size);
+  CHECK(n < dst_size);
+  CHECK_EQ(out[n], '\0');
+  out.resize(n);
+  return out;
+}
+
+// glibc's converter as the reference, empty when it does not map the byte
+std::string iconv_utf8(uint8_t c) {
+  iconv_t cd = iconv_open("UTF-8", "CP1251");
+  if (cd == (iconv_t) -1)
+    return "?";
+  char in[1] = {static_cast<char>(c)}, out[8];
+  char *pin = in, *pout = out;
+  size_t in_left = 1, out_left = sizeof(out);
+  size_t r = iconv(cd, &pin, &in_left, &pout, &out_left);
+  iconv_close(cd);
+  return r == (size_t) -1 ? std::string() : std::string(out, pout - out);
+}
+
+}  // namespace
+
+TEST_CASE(meter_type_string) {
+  // "Счетчик Нартис I100-W112 № 5" as a Nartis meter reports its type
+  const std::string cp1251 = "\xD1\xF7\xE5\xF2\xF7\xE8\xEA \xCD\xE0\xF0\xF2\xE8\xF1 I100-W112 \xB9 5";
+  CHECK_EQ(convert(cp1251), std::string("Счетчик Нартис I100-W112 № 5"));
+  CHECK_EQ(convert("\xA8\xB8"), std::string("Ёё"));
+}
+
+TEST_CASE(every_byte_matches_iconv) {
+  if (iconv_utf8('A') != "A") {
+    fprintf(stderr, "no CP1251 in iconv, skipped\n");
+    return;
+  }
+  for (int c = 1; c < 256; c++) {
+    const std::string expected = c == 0x98 ? std::string("\xEF\xBF\xBD") : iconv_utf8(c);  // unassigned: U+FFFD
+    const std::string got = convert(std::string(1, static_cast<char>(c)));
+    if (got != expected)
+      dlms_test::fail(__FILE__, __LINE__, "byte " + std::to_string(c) + " converts differently from iconv");
+  }
+}
+
+TEST_CASE(ascii_runs_at_any_alignment) {
+  // the 4-byte path must hand over to the byte path wherever a high byte sits in the word
+  for (size_t lead = 0; lead < 9; lead++) {
+    for (size_t tail = 0; tail < 9; tail++) {
+      std::string in = std::string(lead, 'a') + "\xC0" + std::string(tail, 'z');
+      CHECK_EQ(convert(in), std::string(lead, 'a') + "А" + std::string(tail, 'z'));
+    }
+  }
+  CHECK_EQ(convert(std::string(200, 'x')), std::string(200, 'x'));
+}
+
+TEST_CASE(truncation_keeps_whole_sequences) {
+  // 3 ASCII bytes fit a 6-byte buffer with room for one 2-byte letter, the next one is cut
+  CHECK_EQ(convert("abc\xC0\xC1", 6), std::string("abcА"));
+  CHECK_EQ(convert("abc\xC0\xC1", 5), std::string("abc"));
+  // a 3-byte sequence is never split
+  CHECK_EQ(convert("ab\xB9", 5), std::string("ab"));
+  CHECK_EQ(convert("ab\xB9", 6), std::string("ab№"));
+  CHECK_EQ(convert(std::string(10, 'q'), 8), std::string(7, 'q'));
+
+  char one[1] = {'x'};
+  CHECK_EQ(cp1251_to_utf8(reinterpret_cast<const uint8_t *>("abc"), 3, one, 1), size_t(0));
+  CHECK_EQ(one[0], '\0');
+  CHECK_EQ(cp1251_to_utf8(nullptr, 0, one, 0), size_t(0));
+}
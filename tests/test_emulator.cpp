@@ -0,0 +1,180 @@
+// Meter emulator: HDLC framing, GET replies, lost and repeated frames, segmentation, line timing
+
+#include "dlms_test.h"
+
+#include "meter_emulator.h"
+#include "esphome/core/hal.h"
+
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::dlms_cosem::testing;
+
+namespace {
+
+const std::vector<uint8_t> METER = {0x03};   // server address 1
+const std::vector<uint8_t> CLIENT = {0x21};  // public client, SAP 16
+
+// everything the meter puts on the line within the next ms
+std::vector<uint8_t> drain(MeterEmulator &meter, uint32_t ms = 1000) {
+  host::advance_ms(ms);
+  std::vector<uint8_t> out(meter.available());
+  if (!out.empty())
+    meter.read_array(out.data(), out.size());
+  return out;
+}
+
+void send(MeterEmulator &meter, const std::vector<uint8_t> &frame) { meter.write_array(frame.data(), frame.size()); }
+
+std::vector<uint8_t> get_request(uint8_t invoke, uint16_t class_id, std::vector<uint8_t> obis, uint8_t attribute) {
+  std::vector<uint8_t> apdu = {0xE6, 0xE6, 0x00, 0xC0, 0x01, invoke, static_cast<uint8_t>(class_id >> 8),
+                               static_cast<uint8_t>(class_id)};
+  apdu.insert(apdu.end(), obis.begin(), obis.end());
+  apdu.insert(apdu.end(), {attribute, 0x00});
+  return apdu;
+}
+
+uint8_t i_control(uint8_t nr, uint8_t ns) { return static_cast<uint8_t>((nr << 5) | 0x10 | (ns << 1)); }
+
+// SNRM and UA, the meter is ready for the first I frame afterwards
+void connect(MeterEmulator &meter) {
+  send(meter, MeterEmulator::hdlc_frame(METER, CLIENT, 0x93, {}));
+  drain(meter);
+}
+
+}  // namespace
+
+TEST_CASE(snrm_frame_matches_reference) {
+  const std::vector<uint8_t> expected = {0x7E, 0xA0, 0x07, 0x03, 0x21, 0x93, 0x0F, 0x01, 0x7E};
+  CHECK(MeterEmulator::hdlc_frame(METER, CLIENT, 0x93, {}) == expected);
+}
+
+TEST_CASE(ua_swaps_addresses_and_takes_line_time) {
+  MeterEmulator::Config config;
+  config.baud_rate = 9600;
+  config.turnaround_us = 20000;
+  MeterEmulator meter(config);
+  send(meter, MeterEmulator::hdlc_frame(METER, CLIENT, 0x93, {}));
+
+  // nothing before the turnaround, the whole frame only after its last byte went over the line
+  host::advance_ms(19);
+  CHECK_EQ(meter.available(), 0);
+  auto ua = drain(meter, 100);
+  CHECK_EQ(ua.size(), size_t(34));
+  CHECK_EQ(ua[3], uint8_t(0x21));
+  CHECK_EQ(ua[4], uint8_t(0x03));
+  CHECK_EQ(ua[5], uint8_t(0x73));
+  // information field length proposal in the UA parameters
+  CHECK_EQ(ua[13], uint8_t(0x00));
+  CHECK_EQ(ua[14], uint8_t(128));
+  CHECK_EQ(meter.stats().sessions, 1u);
+}
+
+TEST_CASE(get_reply_carries_value_and_sequence_numbers) {
+  MeterEmulator meter;
+  meter.add_register("1.0.1.8.0.255", MeterEmulator::uint32(123456), -1, 30);
+  connect(meter);
+
+  send(meter, MeterEmulator::hdlc_frame(METER, CLIENT, i_control(0, 0),
+                                        get_request(0xC1, 3, {1, 0, 1, 8, 0, 255}, 2)));
+  auto reply = drain(meter);
+  const std::vector<uint8_t> info = {0xE6, 0xE7, 0x00, 0xC4, 0x01, 0xC1, 0x00, 0x06, 0x00, 0x01, 0xE2, 0x40};
+  CHECK_EQ(reply[5], i_control(1, 0));
+  CHECK(std::vector<uint8_t>(reply.begin() + 8, reply.end() - 3) == info);
+  CHECK_EQ(meter.get_requests("1.0.1.8.0.255", 2), 1u);
+
+  send(meter, MeterEmulator::hdlc_frame(METER, CLIENT, i_control(1, 1),
+                                        get_request(0xC1, 3, {1, 0, 1, 8, 0, 255}, 3)));
+  reply = drain(meter);
+  CHECK_EQ(reply[5], i_control(2, 1));
+  CHECK_EQ(reply[reply.size() - 4], uint8_t(30));
+  CHECK_EQ(meter.get_requests("1.0.1.8.0.255", 3), 1u);
+}
+
+TEST_CASE(missing_object_and_access_error) {
+  MeterEmulator meter;
+  meter.add_access_error(3, "1.0.32.7.0.255", 2, 0x03);
+  connect(meter);
+
+  send(meter, MeterEmulator::hdlc_frame(METER, CLIENT, i_control(0, 0),
+                                        get_request(0xC1, 3, {1, 0, 32, 7, 0, 255}, 2)));
+  auto reply = drain(meter);
+  CHECK_EQ(reply[reply.size() - 5], uint8_t(0x01));
+  CHECK_EQ(reply[reply.size() - 4], uint8_t(0x03));
+
+  send(meter, MeterEmulator::hdlc_frame(METER, CLIENT, i_control(1, 1),
+                                        get_request(0xC1, 3, {1, 0, 99, 7, 0, 255}, 2)));
+  reply = drain(meter);
+  CHECK_EQ(reply[reply.size() - 4], uint8_t(0x04));
+}
+
+TEST_CASE(lost_reply_is_sent_again_for_repeated_request) {
+  MeterEmulator meter;
+  meter.add_register("1.0.1.8.0.255", MeterEmulator::uint32(1), 0, 30);
+  connect(meter);
+
+  auto request = MeterEmulator::hdlc_frame(METER, CLIENT, i_control(0, 0),
+                                           get_request(0xC1, 3, {1, 0, 1, 8, 0, 255}, 2));
+  meter.drop_replies(1);
+  send(meter, request);
+  CHECK(drain(meter).empty());
+  CHECK_EQ(meter.stats().replies_dropped, 1u);
+
+  // same N(S): the meter does not read the object again, it repeats its last reply
+  send(meter, request);
+  auto reply = drain(meter);
+  CHECK(!reply.empty());
+  CHECK_EQ(reply[5], i_control(1, 0));
+  CHECK_EQ(meter.stats().repeated_frames, 1u);
+  CHECK_EQ(meter.get_requests("1.0.1.8.0.255", 2), 1u);
+}
+
+TEST_CASE(bad_fcs_is_ignored) {
+  MeterEmulator meter;
+  connect(meter);
+  auto request = MeterEmulator::hdlc_frame(METER, CLIENT, i_control(0, 0),
+                                           get_request(0xC1, 3, {1, 0, 1, 8, 0, 255}, 2));
+  request[request.size() - 2] ^= 0x01;
+  send(meter, request);
+  CHECK(drain(meter).empty());
+  CHECK_EQ(meter.stats().fcs_errors, 1u);
+  CHECK_EQ(meter.stats().get_requests, 0u);
+}
+
+TEST_CASE(long_reply_is_segmented) {
+  MeterEmulator::Config config;
+  config.max_info_field = 32;
+  MeterEmulator meter(config);
+  meter.add_object(1, "0.0.96.1.0.255", 2, MeterEmulator::visible_string(std::string(60, 'x')));
+  connect(meter);
+
+  send(meter, MeterEmulator::hdlc_frame(METER, CLIENT, i_control(0, 0),
+                                        get_request(0xC1, 1, {0, 0, 96, 1, 0, 255}, 2)));
+  auto reply = drain(meter);
+  // 3 LLC + 4 GET header + 2 + 60 string bytes = 69: three frames, segmentation bit on the first two
+  std::vector<size_t> starts;
+  for (size_t pos = 0; pos < reply.size(); pos += ((reply[pos + 1] & 0x07) << 8 | reply[pos + 2]) + 2)
+    starts.push_back(pos);
+  CHECK_EQ(starts.size(), size_t(3));
+  if (starts.size() == 3) {
+    CHECK_EQ(reply[starts[0] + 1] & 0x08, 0x08);
+    CHECK_EQ(reply[starts[1] + 1] & 0x08, 0x08);
+    CHECK_EQ(reply[starts[2] + 1] & 0x08, 0x00);
+    CHECK_EQ(reply[starts[0] + 5], i_control(1, 0));
+    CHECK_EQ(reply[starts[1] + 5], i_control(1, 1));
+    CHECK_EQ(reply[starts[2] + 5], i_control(1, 2));
+  }
+}
+
+TEST_CASE(bit_errors_follow_the_seed) {
+  MeterEmulator::Config config;
+  config.byte_error_rate = 0.2;
+  config.seed = 7;
+  MeterEmulator a(config), b(config), clean;
+  for (auto *meter : {&a, &b, &clean})
+    send(*meter, MeterEmulator::hdlc_frame(METER, CLIENT, 0x93, {}));
+  auto ra = drain(a), rb = drain(b), rc = drain(clean);
+  CHECK(ra == rb);
+  CHECK(ra != rc);
+  CHECK_EQ(ra.size(), rc.size());
+}
@@ -0,0 +1,206 @@
+// Value formatting into fixed buffers: floats as std::ostream printed them, truncation; which text
+// values a text sensor transcodes from CP1251; GET reply values decoded as push values are
+
+#include "dlms_test.h"
+
+#include "axdr_parser.h"
+#include "dlms_cosem_helpers.h"
+#include "dlms_cosem_sensor.h"
+
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <vector>
+
+using namespace esphome;
+using namespace esphome::dlms_cosem;
+
+namespace {
+
+std::string float32_text(float f) {
+  uint32_t u;
+  memcpy(&u, &f, sizeof(u));
+  const uint8_t be[4] = {static_cast<uint8_t>(u >> 24), static_cast<uint8_t>(u >> 16), static_cast<uint8_t>(u >> 8),
+                         static_cast<uint8_t>(u)};
+  char buf[DLMS_VALUE_STRING_SIZE];
+  size_t len = dlms_data_to_chars(buf, sizeof(buf), DLMS_DATA_TYPE_FLOAT32, be, sizeof(be));
+  CHECK_EQ(len, strlen(buf));
+  return buf;
+}
+
+std::string ostream_text(float f) {
+  std::ostringstream ss;
+  ss << f;
+  return ss.str();
+}
+
+}  // namespace
+
+TEST_CASE(float_has_six_significant_digits) {
+  CHECK_EQ(float32_text(230.1f), std::string("230.1"));
+  CHECK_EQ(float32_text(12345.678f), std::string("12345.7"));
+  CHECK_EQ(float32_text(0.0001234f), std::string("0.0001234"));
+  CHECK_EQ(float32_text(1.5e-5f), std::string("1.5e-05"));
+  CHECK_EQ(float32_text(123456789.0f), std::string("1.23457e+08"));
+  CHECK_EQ(float32_text(-2.0f), std::string("-2"));
+}
+
+TEST_CASE(float_matches_ostream_formatting) {
+  std::mt19937 rng(41);
+  int differ = 0;
+  for (int i = 0; i < 20000; i++) {
+    uint32_t u = rng();
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    if (float32_text(f) != ostream_text(f))
+      differ++;
+  }
+  CHECK_EQ(differ, 0);
+}
+
+TEST_CASE(float_is_truncated_to_the_buffer) {
+  char buf[4];
+  CHECK_EQ(dlms_format_float(buf, sizeof(buf), 12345.6), size_t(3));
+  CHECK_EQ(std::string(buf), std::string("123"));
+  CHECK_EQ(dlms_format_float(buf, 0, 1.0), size_t(0));
+}
+
+TEST_CASE(text_sensor_transcodes_only_raw_strings) {
+  DlmsCosemTextSensor sensor;
+  sensor.set_obis_code("0.0.96.1.1.255");
+  const char cp1251[] = "\xD1\xF7\xE5\xF2";  // "Счет"
+  sensor.set_value(cp1251, DLMS_DATA_TYPE_OCTET_STRING, true);
+  sensor.publish();
+  sensor.set_value(cp1251, DLMS_DATA_TYPE_STRING, true);
+  sensor.publish();
+  // already UTF-8, or text the component formatted itself: left alone
+  sensor.set_value("Сч", DLMS_DATA_TYPE_STRING_UTF8, true);
+  sensor.publish();
+  sensor.set_value("2026-10-19 12:00:00", DLMS_DATA_TYPE_DATETIME, true);
+  sensor.publish();
+  // the hub setting off: raw bytes pass through
+  sensor.set_value(cp1251, DLMS_DATA_TYPE_OCTET_STRING, false);
+  sensor.publish();
+
+  CHECK_EQ(sensor.published.size(), size_t(5));
+  if (sensor.published.size() == 5) {
+    CHECK_EQ(sensor.published[0], std::string("Счет"));
+    CHECK_EQ(sensor.published[1], std::string("Счет"));
+    CHECK_EQ(sensor.published[2], std::string("Сч"));
+    CHECK_EQ(sensor.published[3], std::string("2026-10-19 12:00:00"));
+    CHECK_EQ(sensor.published[4], std::string(cp1251));
+  }
+
+  // a per-sensor setting overrides the hub
+  DlmsCosemTextSensor keep;
+  keep.set_cp1251_conversion_required(false);
+  keep.set_value(cp1251, DLMS_DATA_TYPE_OCTET_STRING, true);
+  keep.publish();
+  CHECK(!keep.published.empty() && keep.published.back() == std::string(cp1251));
+}
+
+namespace {
+
+struct Decoded {
+  DLMS_DATA_TYPE type{DLMS_DATA_TYPE_NONE};
+  std::vector<uint8_t> value;
+  std::string text;
+  double number{NAN};
+};
+
+Decoded decoded(DLMS_DATA_TYPE type, const uint8_t *value, size_t len) {
+  Decoded d;
+  d.type = type;
+  d.value.assign(value, value + len);
+  char buf[DLMS_VALUE_STRING_SIZE];
+  d.text.assign(buf, dlms_data_to_chars(buf, sizeof(buf), type, value, len));
+  DlmsNumber n;
+  if (dlms_data_as_number(type, value, len, &n))
+    d.number = n.to_double();
+  return d;
+}
+
+// the value as a GET reply leaves it in gxReplyData::data: bare A-XDR, type tag first
+Decoded pull(const std::vector<uint8_t> &value) {
+  DlmsGetResult res;
+  if (!dlms_parse_data_value(value.data(), value.size(), &res))
+    return {};
+  return decoded(res.type, value.data() + res.offset, res.length);
+}
+
+// the same value in a push telegram: a structure of class id, OBIS, attribute and value
+Decoded push(const std::vector<uint8_t> &value) {
+  std::vector<uint8_t> apdu = {0x0F, 0x00, 0x00, 0x12, 0x34, 0x00, 0x01, 0x01, 0x02, 0x04, 0x12, 0x00,
+                               0x03, 0x09, 0x06, 0x01, 0x00, 0x01, 0x08, 0x00, 0xFF, 0x0F, 0x02};
+  for (uint8_t b : value)
+    apdu.push_back(b);
+  gxByteBuffer buf{};
+  buf.data = apdu.data();
+  buf.size = apdu.size();
+  buf.capacity = apdu.size();
+  Decoded d;
+  CosemObjectFoundCallback fn = [&](uint16_t, const uint8_t *, DLMS_DATA_TYPE type, const uint8_t *v, uint8_t len,
+                                    const int8_t *, const uint8_t *) { d = decoded(type, v, len); };
+  AxdrStreamParser parser(&buf, fn, false);
+  parser.register_pattern_dsl("T1", "TC,TO,TS,TV");
+  parser.begin_frame();
+  parser.parse();
+  return d;
+}
+
+}  // namespace
+
+TEST_CASE(get_reply_decodes_like_push) {
+  const std::vector<std::vector<uint8_t>> values = {
+      {0x06, 0x00, 0x00, 0x15, 0x7C},                    // double-long-unsigned
+      {0x05, 0xFF, 0xFF, 0xFF, 0x85},                    // double-long, negative
+      {0x12, 0x08, 0xFB},                                // long-unsigned
+      {0x10, 0xFF, 0xFE},                                // long
+      {0x11, 0x05},                                      // unsigned
+      {0x0F, 0xFE},                                      // integer
+      {0x16, 0x1E},                                      // enum
+      {0x03, 0x01},                                      // boolean
+      {0x15, 0x00, 0x00, 0x00, 0x02, 0x54, 0x0B, 0xE3, 0xFF},  // long64-unsigned
+      {0x17, 0x43, 0x66, 0x1A, 0x3D},                    // float32 230.102
+      {0x18, 0x40, 0x6C, 0xC3, 0x33, 0x33, 0x33, 0x33, 0x33},  // float64 230.1
+      {0x09, 0x08, '1', '2', '3', '4', '5', '6', '7', '8'},   // octet-string
+      {0x0A, 0x04, 'A', 'B', 'C', 'D'},                  // visible-string
+      {0x19, 0x07, 0xEA, 0x0A, 0x13, 0xFF, 0x0D, 0x1E, 0x00, 0x00, 0xFF, 0x88, 0x80},  // date-time
+  };
+  for (const auto &v : values) {
+    const Decoded a = pull(v), b = push(v);
+    const std::string what = "value type " + std::to_string(v[0]);
+    if (a.type != v[0] || b.type != v[0]) {
+      dlms_test::fail(__FILE__, __LINE__, what + ": not decoded on both paths");
+      continue;
+    }
+    if (a.value != b.value || a.text != b.text)
+      dlms_test::fail(__FILE__, __LINE__, what + ": \"" + a.text + "\" from GET, \"" + b.text + "\" from push");
+    if (!(a.number == b.number || (std::isnan(a.number) && std::isnan(b.number))))
+      dlms_test::fail(__FILE__, __LINE__, what + ": numbers differ");
+  }
+  CHECK_EQ(pull({0x06, 0x00, 0x00, 0x15, 0x7C}).number, 5500.0);
+}
+
+TEST_CASE(get_reply_scaler_unit_and_fallbacks) {
+  // attribute 3 of a register: structure {integer scaler, enum unit}
+  const std::vector<uint8_t> scaler_unit = {0x02, 0x02, 0x0F, 0xFF, 0x16, 0x1E};
+  DlmsGetResult res;
+  CHECK(dlms_parse_data_value(scaler_unit.data(), scaler_unit.size(), &res));
+  int8_t scaler = 0;
+  uint8_t unit = 0;
+  CHECK(dlms_parse_scaler_unit(scaler_unit.data(), res, &scaler, &unit));
+  CHECK_EQ(scaler, int8_t(-1));
+  CHECK_EQ(unit, uint8_t(30));
+
+  // left to Gurux: a full Get-Response header, a truncated value, a trailing byte, compact arrays
+  const std::vector<uint8_t> with_header = {0xC4, 0x01, 0xC1, 0x00, 0x06, 0x00, 0x00, 0x15, 0x7C};
+  CHECK(!dlms_parse_data_value(with_header.data(), with_header.size(), &res));
+  const std::vector<uint8_t> truncated = {0x09, 0x08, '1', '2'};
+  CHECK(!dlms_parse_data_value(truncated.data(), truncated.size(), &res));
+  const std::vector<uint8_t> trailing = {0x11, 0x05, 0x00};
+  CHECK(!dlms_parse_data_value(trailing.data(), trailing.size(), &res));
+  const std::vector<uint8_t> compact = {0x13, 0x02, 0x12, 0x00, 0x02, 0x00, 0x01};
+  CHECK(!dlms_parse_data_value(compact.data(), compact.size(), &res));
+  CHECK(!dlms_parse_data_value(nullptr, 0, &res));
+}
@@ -0,0 +1,16 @@
+#include "dlms_test.h"
+
+int main(int argc, char **argv) {
+  int ran = 0;
+  for (const auto &c : dlms_test::cases()) {
+    // optional argument: run only the cases whose name contains it
+    if (argc > 1 && std::string(c.name).find(argv[1]) == std::string::npos)
+      continue;
+    int before = dlms_test::failures();
+    c.fn();
+    fprintf(stderr, "%s %s\n", dlms_test::failures() == before ? "[ OK ]" : "[FAIL]", c.name);
+    ran++;
+  }
+  fprintf(stderr, "%d cases, %d failed checks\n", ran, dlms_test::failures());
+  return dlms_test::failures() == 0 ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+// DlmsCosemPort implementations on the host: POSIX serial over a pty, capture wrapper
+
+#include "dlms_test.h"
+
+#include "dlms_cosem_port.h"
+#include "port_capture.h"
+#include "esphome/core/log.h"
+
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <pty.h>
+#include <termios.h>
+#include <unistd.h>
+
+using namespace esphome;
+using namespace esphome::dlms_cosem;
+
+namespace {
+
+// pty pair in raw mode; the component opens the slave side by name, the test talks through the master
+struct Pty {
+  int master{-1};
+  int slave{-1};
+  char name[128]{};
+
+  Pty() {
+    struct termios tio {};
+    cfmakeraw(&tio);
+    openpty(&this->master, &this->slave, this->name, &tio, nullptr);
+    fcntl(this->master, F_SETFL, O_NONBLOCK);
+  }
+  ~Pty() {
+    close(this->master);
+    close(this->slave);
+  }
+};
+
+}  // namespace
+
+TEST_CASE(posix_port_round_trip) {
+  Pty pty;
+  PosixSerialPort port(pty.name);
+  CHECK(port.open());
+
+  const uint8_t request[] = {0x7E, 0xA0, 0x07, 0x03, 0x21, 0x93, 0x0F, 0x01, 0x7E};
+  port.write_array(request, sizeof(request));
+  uint8_t got[sizeof(request)] = {};
+  usleep(10000);
+  CHECK_EQ(read(pty.master, got, sizeof(got)), (ssize_t) sizeof(request));
+  CHECK(memcmp(got, request, sizeof(request)) == 0);
+
+  const uint8_t reply[] = {0x7E, 0xA0, 0x1E, 0x21};
+  CHECK_EQ(write(pty.master, reply, sizeof(reply)), (ssize_t) sizeof(reply));
+  usleep(10000);
+  CHECK_EQ(port.available(), (int) sizeof(reply));
+  uint8_t b = 0;
+  CHECK(port.read_byte(&b));
+  CHECK_EQ(b, 0x7E);
+  uint8_t rest[3];
+  CHECK(port.read_array(rest, 3));
+  CHECK(memcmp(rest, reply + 1, 3) == 0);
+  CHECK_EQ(port.available(), 0);
+  CHECK(!port.read_byte(&b));
+}
+
+TEST_CASE(posix_port_write_waits_instead_of_spinning) {
+  Pty pty;
+  PosixSerialPort port(pty.name);
+  CHECK(port.open());
+  port.set_write_timeout_ms(100);
+  host::clear_log();
+
+  // nobody reads the master side, the pty buffer fills up and write() returns EAGAIN
+  std::vector<uint8_t> big(1 << 20, 0x55);
+  auto started = std::chrono::steady_clock::now();
+  clock_t cpu_started = clock();
+  port.write_array(big.data(), big.size());
+  auto elapsed = std::chrono::steady_clock::now() - started;
+  double cpu_ms = 1000.0 * (clock() - cpu_started) / CLOCKS_PER_SEC;
+
+  CHECK(elapsed >= std::chrono::milliseconds(90));
+  CHECK(elapsed < std::chrono::seconds(2));
+  // waiting in poll() costs no CPU, the old EAGAIN loop used all of it
+  CHECK(cpu_ms < 50.0);
+  CHECK_EQ(host::count_log(ESPHOME_LOG_LEVEL_WARN, "timed out"), 1u);
+}
+
+TEST_CASE(posix_port_missing_device) {
+  PosixSerialPort port("/nonexistent/tty");
+  CHECK(!port.open());
+  CHECK_EQ(port.available(), 0);
+}
+
+TEST_CASE(capture_port_shares_bus_of_wrapped_port) {
+  Pty pty;
+  auto inner = make_unique<PosixSerialPort>(pty.name);
+  const void *bus = inner->bus_id();
+  CapturePort capture(std::move(inner), 256);
+  CHECK(capture.bus_id() == bus);
+
+  PosixSerialPort other(pty.name);
+  CHECK(other.bus_id() != bus);
+}
@@ -0,0 +1,118 @@
+// Record and replay: a session against the meter emulator captured through CapturePort, printed with
+// capture_dump(), read back from the log and played into a fresh component
+
+#include "dlms_test.h"
+
+#include "dlms_cosem.h"
+#include "log_dump.h"
+#include "meter_emulator.h"
+#include "replay_session.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#include <memory>
+#include <sstream>
+
+using namespace esphome;
+using namespace esphome::dlms_cosem;
+using namespace esphome::dlms_cosem::testing;
+
+namespace {
+
+// one live session with capture on, returns the capture as read back from the log
+LogDump record_session(std::vector<float> *published) {
+  DlmsCosemComponent hub;
+  auto port = std::make_unique<MeterEmulator>();
+  MeterEmulator *meter = port.get();
+  meter->add_register("1.0.1.8.0.255", MeterEmulator::uint32(123456), -1, 30);
+  meter->add_register("1.0.32.7.0.255", MeterEmulator::uint16(2301), -1, 35);
+  hub.set_port(std::move(port));
+  hub.set_update_interval(3600000);
+  hub.set_capture_size(4096);
+  DlmsCosemSensor energy, voltage;
+  energy.set_obis_code("1.0.1.8.0.255");
+  energy.set_obis_class(3);
+  voltage.set_obis_code("1.0.32.7.0.255");
+  voltage.set_obis_class(3);
+  hub.register_sensor(&energy);
+  hub.register_sensor(&voltage);
+  hub.call_setup();
+  host::run_for(&hub, 11000);  // boot wait
+  hub.update();
+  host::run_for(&hub, 20000);
+  published->push_back(energy.published.empty() ? NAN : energy.published.back());
+  published->push_back(voltage.published.empty() ? NAN : voltage.published.back());
+
+  host::clear_log();
+  hub.capture_dump();
+  std::ostringstream log;
+  for (const auto &line : host::log_lines())
+    log << "[09:30:00][I][" << line.tag << ":605]: " << line.message << "\n";
+  std::istringstream in(log.str());
+  LogDump dump;
+  CHECK(read_log_dump(in, "CAPTURE", &dump));
+  CHECK_EQ(dump.header_u32("dropped"), 0u);
+  return dump;
+}
+
+}  // namespace
+
+TEST_CASE(replay_publishes_what_the_live_session_did) {
+  std::vector<float> live;
+  auto dump = record_session(&live);
+  CHECK(!dump.data.empty());
+
+  ReplayConfig config;
+  config.objects = objects_in_capture(dump.data);
+  CHECK_EQ(config.objects.size(), size_t(2));
+  if (config.objects.size() == 2) {
+    CHECK_EQ(config.objects[0].obis, std::string("1.0.1.8.0.255"));
+    CHECK_EQ(config.objects[0].class_id, uint16_t(3));
+    CHECK_EQ(config.objects[1].obis, std::string("1.0.32.7.0.255"));
+  }
+
+  auto run = replay_session(dump.data, config);
+  CHECK(run.finished);
+  CHECK_EQ(run.tx_mismatches, size_t(0));
+  CHECK(run.session_ms > 0);
+  CHECK_EQ(run.values.size(), size_t(2));
+  if (run.values.size() == 2 && live.size() == 2) {
+    CHECK_NEAR(atof(run.values[0].second.c_str()), live[0], 0.01);
+    CHECK_NEAR(atof(run.values[1].second.c_str()), live[1], 0.01);
+  }
+
+  // the same capture gives the same session, so a baseline from it compares clean
+  auto again = replay_session(dump.data, config);
+  CHECK_NEAR(again.session_ms, run.session_ms, 0.001);
+  std::istringstream text(format_baseline(run));
+  ReplayResult baseline;
+  CHECK(read_baseline(text, &baseline));
+  CHECK(compare_with_baseline(baseline, again, 0.0).empty());
+}
+
+TEST_CASE(baseline_reports_other_values_and_slower_sessions) {
+  ReplayResult baseline, run;
+  baseline.session_ms = 1000;
+  baseline.values = {{"1.0.1.8.0.255", "12345.6"}, {"0.0.96.1.0.255", "ABC 123"}};
+  run = baseline;
+  run.finished = true;
+  CHECK(compare_with_baseline(baseline, run, 10).empty());
+
+  run.session_ms = 1080;
+  CHECK(compare_with_baseline(baseline, run, 10).empty());
+  run.session_ms = 1200;
+  CHECK_EQ(compare_with_baseline(baseline, run, 10).size(), size_t(1));
+
+  run.session_ms = 900;
+  run.values[1].second = "ABC 124";
+  auto diffs = compare_with_baseline(baseline, run, 10);
+  CHECK_EQ(diffs.size(), size_t(1));
+  if (!diffs.empty())
+    CHECK(diffs[0].find("0.0.96.1.0.255") == 0);
+
+  // values with spaces survive the baseline file
+  std::istringstream text(format_baseline(baseline));
+  ReplayResult read;
+  CHECK(read_baseline(text, &read));
+  CHECK(read.values == baseline.values);
+}
@@ -0,0 +1,232 @@
+// Whole pull sessions of the component against the meter emulator: values, scaler and unit, lost
+// replies sent again, access errors, a noisy line and the read_now action
+
+#include "dlms_test.h"
+
+#include "automation.h"
+#include "dlms_cosem.h"
+#include "meter_emulator.h"
+#include "esphome/core/hal.h"
+
+#include <memory>
+#include <string>
+
+using namespace esphome;
+using namespace esphome::dlms_cosem;
+using namespace esphome::dlms_cosem::testing;
+
+namespace {
+
+constexpr uint32_t BOOT_MS = 11000;  // past the component's 10 s boot wait
+
+struct Bench {
+  DlmsCosemComponent hub;
+  MeterEmulator *meter;
+  std::vector<std::unique_ptr<DlmsCosemSensor>> sensors;
+
+  explicit Bench(MeterEmulator::Config config = {}) {
+    auto port = std::make_unique<MeterEmulator>(config);
+    this->meter = port.get();
+    this->hub.set_port(std::move(port));
+    this->hub.set_baud_rates(config.baud_rate, config.baud_rate);
+    this->hub.set_update_interval(60000);
+  }
+
+  DlmsCosemSensor *add_sensor(const char *obis, uint16_t class_id = 3) {
+    auto s = std::make_unique<DlmsCosemSensor>();
+    s->set_obis_code(obis);
+    s->set_obis_class(class_id);
+    s->set_attribute(2);
+    this->hub.register_sensor(s.get());
+    this->sensors.push_back(std::move(s));
+    return this->sensors.back().get();
+  }
+
+  // setup and the boot wait: the poll ESPHome makes right after setup() comes too early, the first
+  // session starts with the next update()
+  void boot() {
+    this->hub.call_setup();
+    host::run_for(&this->hub, BOOT_MS);
+  }
+
+  // boot, then one poll and enough time for it to finish
+  void run_session(uint32_t ms = 20000) {
+    this->boot();
+    this->hub.update();
+    host::run_for(&this->hub, ms);
+  }
+};
+
+}  // namespace
+
+TEST_CASE(session_reads_registers_with_scaler) {
+  Bench bench;
+  bench.meter->add_register("1.0.1.8.0.255", MeterEmulator::uint32(123456), -1, 30);
+  bench.meter->add_register("1.0.32.7.0.255", MeterEmulator::uint16(2301), -1, 35);
+  auto *energy = bench.add_sensor("1.0.1.8.0.255");
+  auto *voltage = bench.add_sensor("1.0.32.7.0.255");
+  bench.run_session();
+
+  CHECK_EQ(energy->published.size(), size_t(1));
+  CHECK_EQ(voltage->published.size(), size_t(1));
+  if (!energy->published.empty())
+    CHECK_NEAR(energy->published[0], 12345.6, 0.01);
+  if (!voltage->published.empty())
+    CHECK_NEAR(voltage->published[0], 230.1, 0.01);
+  CHECK_EQ(bench.meter->stats().sessions, 1u);
+  CHECK_EQ(energy->telemetry().reads, 1u);
+  CHECK_EQ(energy->telemetry().retries, 0u);
+  CHECK_EQ(energy->telemetry().error_count(), 0u);
+}
+
+TEST_CASE(lost_reply_is_requested_again) {
+  Bench bench;
+  bench.meter->add_register("1.0.1.8.0.255", MeterEmulator::uint32(1000), 0, 30);
+  auto *energy = bench.add_sensor("1.0.1.8.0.255");
+  bench.boot();
+  const uint64_t start = host::now_us();
+  bench.hub.update();
+  // lose the value reply: SNRM, AARQ and the scaler/unit reply go through
+  host::run_for(&bench.hub, 1);
+  while (bench.meter->get_requests("1.0.1.8.0.255", 3) == 0 && host::now_us() - start < 10000000)
+    host::run_for(&bench.hub, 1);
+  bench.meter->drop_replies(1);
+  host::run_for(&bench.hub, 20000);
+
+  CHECK_EQ(energy->published.size(), size_t(1));
+  if (!energy->published.empty())
+    CHECK_NEAR(energy->published[0], 1000.0, 0.001);
+  CHECK_EQ(bench.meter->stats().replies_dropped, 1u);
+  CHECK_EQ(bench.meter->stats().repeated_frames, 1u);
+  CHECK_EQ(energy->telemetry().retries, 1u);
+  CHECK_EQ(energy->telemetry().error_count(), 0u);
+}
+
+TEST_CASE(access_error_is_counted_per_object) {
+  Bench bench;
+  bench.meter->add_register("1.0.1.8.0.255", MeterEmulator::uint32(5), 0, 30);
+  bench.meter->add_access_error(3, "1.0.32.7.0.255", 3, 0x03);
+  auto *energy = bench.add_sensor("1.0.1.8.0.255");
+  auto *voltage = bench.add_sensor("1.0.32.7.0.255");
+  bench.run_session();
+
+  CHECK_EQ(energy->published.size(), size_t(1));
+  CHECK(voltage->published.empty());
+  CHECK(voltage->telemetry().error_count() > 0);
+  // an error reply is a valid reply, nothing is sent again
+  CHECK_EQ(voltage->telemetry().retries, 0u);
+}
+
+TEST_CASE(noisy_line_still_completes) {
+  MeterEmulator::Config config;
+  config.byte_error_rate = 0.002;
+  config.jitter_us = 200;
+  config.seed = 3;
+  Bench bench(config);
+  for (int i = 0; i < 8; i++) {
+    char obis[24];
+    snprintf(obis, sizeof(obis), "1.0.%d.8.0.255", i + 1);
+    bench.meter->add_register(obis, MeterEmulator::uint32(1000 + i), 0, 30);
+    bench.add_sensor(obis);
+  }
+  bench.run_session(60000);
+
+  uint32_t published = 0, retries = 0;
+  for (auto &s : bench.sensors) {
+    published += s->published.size();
+    retries += s->telemetry().retries;
+  }
+  // corrupted replies are either sent again or counted as frame errors, never published with a wrong value
+  for (size_t i = 0; i < bench.sensors.size(); i++) {
+    for (float v : bench.sensors[i]->published)
+      CHECK_NEAR(v, 1000.0 + i, 0.001);
+  }
+  CHECK(published > 0);
+  printf("noisy line: %u of %zu published, %u retries, %u bad request frames\n", published, bench.sensors.size(),
+         retries, bench.meter->stats().fcs_errors);
+}
+
+TEST_CASE(read_now_action_reports_value_and_errors) {
+  Bench bench;
+  bench.meter->add_register("1.0.1.7.0.255", MeterEmulator::uint32(1234), -1, 27);
+  bench.meter->add_access_error(3, "1.0.32.7.0.255", 2, 0x03);
+  auto *power = bench.add_sensor("1.0.1.7.0.255");
+  bench.run_session();
+  const size_t published = power->published.size();
+
+  ReadNowAction<> action;
+  action.set_parent(&bench.hub);
+  Trigger<float, std::string> on_value;
+  Trigger<int> on_error;
+  std::vector<std::pair<float, std::string>> values;
+  std::vector<int> errors;
+  on_value.add_callback([&](float x, std::string text) { values.emplace_back(x, text); });
+  on_error.add_callback([&](int error) { errors.push_back(error); });
+  action.set_value_trigger(&on_value);
+  action.set_error_trigger(&on_error);
+
+  // the code may come from a lambda
+  action.set_obis_code([]() -> std::string { return "1.0.1.7.0.255"; });
+  action.play();
+  host::run_for(&bench.hub, 10000);
+  CHECK_EQ(values.size(), size_t(1));
+  if (!values.empty()) {
+    CHECK_NEAR(values[0].first, 1234.0, 0.001);  // raw, no scaler
+    CHECK_EQ(values[0].second, std::string("1234"));
+  }
+  CHECK_EQ(power->published.size(), published + 1);
+
+  action.set_obis_code(std::string("1.0.32.7.0.255"));
+  action.play();
+  host::run_for(&bench.hub, 10000);
+  CHECK_EQ(errors.size(), size_t(1));
+
+  // refused right away
+  action.set_obis_code(std::string("1.0.32.7.0"));
+  action.play();
+  CHECK_EQ(errors.size(), size_t(2));
+  CHECK_EQ(values.size(), size_t(1));
+}
+
+TEST_CASE(fast_poll_settings_logged_only_with_a_trigger) {
+  Bench bench;
+  bench.meter->add_register("1.0.1.7.0.255", MeterEmulator::uint32(5000), 0, 27);
+  auto *power = bench.add_sensor("1.0.1.7.0.255");
+  host::clear_log();
+  bench.hub.dump_config();
+  bench.run_session();  // logs its statistics at the end
+  CHECK_EQ(host::count_log(ESPHOME_LOG_LEVEL_CONFIG, "Fast poll"), 0u);
+  CHECK_EQ(host::count_log(ESPHOME_LOG_LEVEL_VERBOSE, "Fast poll bursts"), 0u);
+
+  power->set_fast_poll(NAN, 1000, NAN, 1000);
+  power->add_fast_poll_target(1, 0, 1, 7, 0, 255);
+  host::clear_log();
+  bench.hub.dump_config();
+  bench.hub.update();
+  host::run_for(&bench.hub, 20000);
+  CHECK_EQ(host::count_log(ESPHOME_LOG_LEVEL_CONFIG, "Fast poll"), 1u);
+  CHECK(host::count_log(ESPHOME_LOG_LEVEL_VERBOSE, "Fast poll bursts") >= 1u);
+}
+
+TEST_CASE(fast_poll_only_for_objects_that_are_read) {
+  Bench bench;
+  bench.hub.set_fast_poll(5000, 1.0f);
+  bench.meter->add_register("1.0.1.7.0.255", MeterEmulator::uint32(5000), 0, 27);
+  bench.meter->add_register("1.0.32.7.0.255", MeterEmulator::uint16(230), 0, 35);
+  auto *power = bench.add_sensor("1.0.1.7.0.255");
+  auto *voltage = bench.add_sensor("1.0.32.7.0.255");
+  // the power trigger names an object no sensor reads
+  power->set_fast_poll(1000, NAN, NAN, 60000);
+  power->add_fast_poll_target(1, 0, 99, 7, 0, 255);
+  bench.run_session(30000);
+  CHECK_EQ(bench.meter->stats().sessions, 1u);
+  CHECK_EQ(voltage->published.size(), size_t(1));
+
+  // the voltage trigger does name a read object: fast sessions follow
+  voltage->set_fast_poll(200, NAN, NAN, 60000);
+  voltage->add_fast_poll_target(1, 0, 32, 7, 0, 255);
+  bench.hub.update();  // its read starts the burst
+  host::run_for(&bench.hub, 30000);
+  CHECK(bench.meter->stats().sessions > 3u);
+  CHECK(voltage->published.size() > 3u);
+}
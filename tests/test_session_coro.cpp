@@ -0,0 +1,120 @@
+// Session script coroutines: frames come from the owner's pool and never from the heap, a frame that
+// does not fit (or has no pool) gives an empty task, and the script runs one co_await at a time
+
+#include "dlms_test.h"
+
+#include "session_coro.h"
+
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace esphome::dlms_cosem;
+
+namespace {
+
+size_t heap_allocations = 0;
+
+struct Step {
+  bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> /*script*/) noexcept {}
+  void await_resume() const noexcept {}
+};
+
+struct Owner {
+  CoroutineFramePool frames;
+  std::vector<int> trace;
+
+  SessionTask start(int steps) {
+    return start_session_script(this->frames, [this, steps]() { return this->script(steps); });
+  }
+
+  SessionTask script(int steps) {
+    for (int i = 0; i < steps; i++) {
+      this->trace.push_back(i);
+      co_await Step{};
+    }
+    this->trace.push_back(-1);
+  }
+
+  // a local that cannot fit in the pool
+  SessionTask big_script() {
+    volatile char scratch[CoroutineFramePool::SIZE * 2];
+    scratch[0] = 1;
+    co_await Step{};
+    this->trace.push_back(scratch[0]);
+  }
+};
+
+}  // namespace
+
+void *operator new(size_t size) {
+  heap_allocations++;
+  if (void *p = std::malloc(size))
+    return p;
+  throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t /*size*/) noexcept { std::free(p); }
+
+TEST_CASE(script_runs_one_step_per_resume) {
+  Owner owner;
+  owner.trace.reserve(8);
+  const size_t heap_before = heap_allocations;
+  SessionTask task = owner.start(2);
+  CHECK(static_cast<bool>(task));
+  CHECK(owner.frames.busy());
+  CHECK(owner.frames.last_request() <= CoroutineFramePool::capacity());
+  CHECK(owner.trace.empty());  // starts suspended
+
+  CHECK(!task.resume());
+  CHECK_EQ(owner.trace.size(), size_t(1));
+  CHECK(!task.resume());
+  CHECK(task.resume());
+  CHECK_EQ(owner.trace.size(), size_t(3));
+  CHECK_EQ(owner.trace.back(), -1);
+  CHECK(task.resume());  // finished scripts stay finished
+
+  task.reset();
+  CHECK(!owner.frames.busy());
+  CHECK_EQ(heap_allocations, heap_before);
+}
+
+TEST_CASE(frame_that_does_not_fit_gives_empty_task) {
+  Owner owner;
+  const size_t heap_before = heap_allocations;
+  SessionTask task = start_session_script(owner.frames, [&owner]() { return owner.big_script(); });
+  CHECK(!task);
+  CHECK(task.done());
+  CHECK(owner.frames.last_request() > CoroutineFramePool::capacity());
+  CHECK(!owner.frames.busy());
+  CHECK_EQ(heap_allocations, heap_before);
+}
+
+TEST_CASE(one_frame_per_owner_at_a_time) {
+  Owner owner;
+  SessionTask first = owner.start(1);
+  SessionTask second = owner.start(1);
+  CHECK(static_cast<bool>(first));
+  CHECK(!second);
+
+  // a script destroyed while suspended gives its frame back
+  first.resume();
+  first = SessionTask();
+  CHECK(!owner.frames.busy());
+  second = owner.start(1);
+  CHECK(static_cast<bool>(second));
+
+  Owner other;
+  SessionTask third = other.start(1);
+  CHECK(static_cast<bool>(third));
+}
+
+TEST_CASE(script_started_without_a_pool_is_empty) {
+  Owner owner;
+  const size_t heap_before = heap_allocations;
+  SessionTask task = owner.script(1);
+  CHECK(!task);
+  CHECK(!owner.frames.busy());
+  CHECK_EQ(heap_allocations, heap_before);
+}
@@ -0,0 +1,104 @@
+// Session trace: records printed by SessionTrace::dump() and read back from the log by the host decoder
+
+#include "dlms_test.h"
+
+#include "log_dump.h"
+#include "session_trace.h"
+#include "trace_decoder.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#include <sstream>
+
+using namespace esphome;
+using namespace esphome::dlms_cosem;
+using namespace esphome::dlms_cosem::testing;
+
+namespace {
+
+constexpr uint32_t PUSH_BUILD_STATES = 21;  // STATE_COUNT with ENABLE_DLMS_COSEM_PUSH_MODE
+
+// the dump as it reaches `esphome logs`: level and tag before the message
+std::string dump_to_log(const SessionTrace &trace, size_t state_count) {
+  host::clear_log();
+  trace.dump("dlms_cosem", state_count);
+  std::ostringstream log;
+  log << "[12:00:00][D][sensor:094]: unrelated line\n";
+  for (const auto &line : host::log_lines())
+    log << "[12:00:01][I][" << line.tag << ":123]: " << line.message << "\x1b[0m\n";
+  return log.str();
+}
+
+}  // namespace
+
+TEST_CASE(dump_reads_back_record_for_record) {
+  SessionTrace trace;
+  trace.init(4);
+  const uint8_t snrm[] = {0x7E, 0xA0, 0x07, 0x03, 0x21, 0x93, 0x0F, 0x01, 0x7E};
+  trace.add(SessionTrace::Event::STATE, 1, 2, 59000000);
+  host::advance_us(120);
+  trace.add_frame(SessionTrace::Event::TX, snrm, sizeof(snrm));
+  host::advance_ms(2000);
+  trace.add(SessionTrace::Event::TIMEOUT, 9, 0, 2000);
+
+  std::istringstream log(dump_to_log(trace, PUSH_BUILD_STATES));
+  LogDump dump;
+  CHECK(read_log_dump(log, "TRACE", &dump));
+  CHECK_EQ(dump.header_u32("count"), 3u);
+  CHECK_EQ(dump.header_u32("states"), PUSH_BUILD_STATES);
+  auto records = trace_records(dump);
+  CHECK_EQ(records.size(), size_t(3));
+  if (records.size() == 3) {
+    CHECK_EQ(records[0].arg32, 59000000u);
+    CHECK_EQ(records[1].time_us - records[0].time_us, 120u);
+    CHECK_EQ(records[1].arg16, uint16_t(9));
+    CHECK_EQ(records[1].arg32, 0xA0070321u);
+    CHECK_EQ(records[2].event, uint8_t(SessionTrace::Event::TIMEOUT));
+    CHECK_EQ(records[2].arg8, uint8_t(9));
+  }
+
+  auto lines = decode_trace(dump);
+  CHECK_EQ(lines.size(), size_t(4));
+  if (lines.size() == 4) {
+    CHECK(lines[0].find("IDLE -> TRY_LOCK_BUS") != std::string::npos);
+    CHECK(lines[1].find("TX       9 bytes, frame a0 07 03 21") != std::string::npos);
+    CHECK(lines[2].find("TIMEOUT  waiting for BUFFERS_RCV, 2000 ms") != std::string::npos);
+    CHECK(lines[2].find("2000.120 ms") != std::string::npos);
+  }
+}
+
+TEST_CASE(ring_keeps_newest_records_in_order) {
+  SessionTrace trace;
+  trace.init(3);
+  for (uint32_t i = 0; i < 7; i++)
+    trace.add(SessionTrace::Event::PUSH, 0, 100 + i, i);
+  std::istringstream log(dump_to_log(trace, PUSH_BUILD_STATES));
+  LogDump dump;
+  CHECK(read_log_dump(log, "TRACE", &dump));
+  auto records = trace_records(dump);
+  CHECK_EQ(records.size(), size_t(3));
+  for (size_t i = 0; i < records.size(); i++)
+    CHECK_EQ(records[i].arg32, uint32_t(4 + i));
+}
+
+TEST_CASE(state_numbering_follows_push_mode) {
+  CHECK_EQ(std::string(trace_state_name(17, 20)), std::string("DISCONNECT_REQ"));
+  CHECK_EQ(std::string(trace_state_name(18, 20)), std::string("SESSION_SCRIPT"));
+  CHECK_EQ(std::string(trace_state_name(19, 20)), std::string("PUBLISH"));
+  CHECK_EQ(std::string(trace_state_name(19, 21)), std::string("PUSH_DATA_PROCESS"));
+  CHECK_EQ(std::string(trace_state_name(20, 21)), std::string("PUBLISH"));
+  CHECK(trace_state_name(19, 0) == nullptr);
+}
+
+TEST_CASE(damaged_or_missing_dump_is_rejected) {
+  LogDump dump;
+  std::istringstream none("[I][dlms_cosem]: CAPTURE v1 bytes=4 dropped=0\n[I][dlms_cosem]: CAPTURE:00000101\n");
+  CHECK(!read_log_dump(none, "TRACE", &dump));
+  std::istringstream odd("TRACE v1 size=12 count=1 now=5 states=20\nTRACE:0102030\n");
+  CHECK(!read_log_dump(odd, "TRACE", &dump));
+  // a second dump replaces the first
+  std::istringstream two("TRACE v1 size=12 count=1 now=1\nTRACE:000000000100000000000000\n"
+                         "TRACE v1 size=12 count=0 now=2\n");
+  CHECK(read_log_dump(two, "TRACE", &dump));
+  CHECK(dump.data.empty());
+}
@@ -0,0 +1,38 @@
+// Prints the session trace from a device log as a timeline. Give it the log with the output of
+// trace_dump() (`esphome logs`, a serial console capture); the last dump in it is decoded.
+//
+//   trace_decode [log_file]     (reads stdin without a file)
+
+#include "trace_decoder.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+
+using namespace esphome::dlms_cosem::testing;
+
+int main(int argc, char **argv) {
+  LogDump dump;
+  bool ok;
+  if (argc > 1) {
+    std::ifstream in(argv[1]);
+    if (!in) {
+      fprintf(stderr, "Cannot open %s\n", argv[1]);
+      return 1;
+    }
+    ok = read_log_dump(in, "TRACE", &dump);
+  } else {
+    ok = read_log_dump(std::cin, "TRACE", &dump);
+  }
+  if (!ok) {
+    fprintf(stderr, "No complete TRACE dump in the log\n");
+    return 1;
+  }
+  if (dump.data.size() != dump.header_u32("count") * dump.header_u32("size", 12))
+    fprintf(stderr, "Warning: %zu bytes of trace, header says %u records\n", dump.data.size(), dump.header_u32("count"));
+  if (!dump.header.count("states"))
+    fprintf(stderr, "Warning: no state count in the header, states past DISCONNECT_REQ are shown as numbers\n");
+  for (const auto &line : decode_trace(dump))
+    printf("%s\n", line.c_str());
+  return 0;
+}
@@ -0,0 +1,117 @@
+#include "trace_decoder.h"
+
+#include <cstdarg>
+#include <cstdio>
+
+namespace esphome {
+namespace dlms_cosem {
+namespace testing {
+
+namespace {
+
+// SessionTrace::Event
+enum : uint8_t { STATE = 1, TX = 2, RX = 3, ERROR = 4, TIMEOUT = 5, PUSH = 6 };
+
+constexpr size_t RECORD_SIZE = 12;
+
+// DlmsCosemComponent::State up to SESSION_SCRIPT; PUSH_DATA_PROCESS only exists in push mode builds
+const char *const STATES[] = {"NOT_INITIALIZED", "IDLE",           "TRY_LOCK_BUS",    "WAIT",
+                              "COMMS_TX",        "COMMS_RX",       "MISSION_FAILED",  "OPEN_SESSION",
+                              "BUFFERS_REQ",     "BUFFERS_RCV",    "ASSOCIATION_REQ", "ASSOCIATION_RCV",
+                              "DATA_ENQ_UNIT",   "DATA_ENQ",       "DATA_RECV",       "DATA_NEXT",
+                              "SESSION_RELEASE", "DISCONNECT_REQ", "SESSION_SCRIPT"};
+constexpr uint32_t COMMON_STATES = sizeof(STATES) / sizeof(STATES[0]);
+
+uint32_t le32(const uint8_t *p) { return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t) p[3] << 24; }
+
+std::string format(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+std::string format(const char *fmt, ...) {
+  char buf[160];
+  va_list args;
+  va_start(args, fmt);
+  vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  return buf;
+}
+
+std::string state(uint32_t value, uint32_t state_count) {
+  const char *name = trace_state_name(value, state_count);
+  return name != nullptr ? name : format("state %u", value);
+}
+
+}  // namespace
+
+std::vector<TraceRecord> trace_records(const LogDump &dump) {
+  std::vector<TraceRecord> out;
+  const size_t size = dump.header_u32("size", RECORD_SIZE);
+  if (size != RECORD_SIZE)
+    return out;
+  for (size_t pos = 0; pos + RECORD_SIZE <= dump.data.size(); pos += RECORD_SIZE) {
+    const uint8_t *p = dump.data.data() + pos;
+    out.push_back({le32(p), p[4], p[5], static_cast<uint16_t>(p[6] | p[7] << 8), le32(p + 8)});
+  }
+  return out;
+}
+
+const char *trace_state_name(uint32_t state, uint32_t state_count) {
+  if (state < COMMON_STATES)
+    return STATES[state];
+  if (state_count == COMMON_STATES + 1 && state == COMMON_STATES)
+    return "PUBLISH";
+  if (state_count == COMMON_STATES + 2 && state == COMMON_STATES)
+    return "PUSH_DATA_PROCESS";
+  if (state_count == COMMON_STATES + 2 && state == COMMON_STATES + 1)
+    return "PUBLISH";
+  return nullptr;  // unknown build (no states= in the header) or a damaged record
+}
+
+std::vector<std::string> decode_trace(const LogDump &dump) {
+  std::vector<std::string> lines;
+  const auto records = trace_records(dump);
+  if (records.empty())
+    return lines;
+  const uint32_t states = dump.header_u32("states");
+
+  // micros() wraps after 71 minutes: add up differences instead of using the raw values
+  uint64_t t = 0;
+  uint32_t prev = records.front().time_us;
+  for (const auto &r : records) {
+    const uint32_t delta = r.time_us - prev;
+    t += delta;
+    prev = r.time_us;
+    std::string what;
+    switch (r.event) {
+      case STATE:
+        what = format("STATE    %s -> %s, %.3f ms in %s", state(r.arg8, states).c_str(),
+                      state(r.arg16, states).c_str(), r.arg32 / 1000.0, state(r.arg8, states).c_str());
+        break;
+      case TX:
+      case RX:
+        what = format("%s       %u bytes, frame %02x %02x %02x %02x", r.event == TX ? "TX" : "RX", r.arg16,
+                      r.arg32 >> 24, (r.arg32 >> 16) & 0xFF, (r.arg32 >> 8) & 0xFF, r.arg32 & 0xFF);
+        break;
+      case ERROR:
+        what = format("ERROR    in %s, code %d (0x%x)", state(r.arg8, states).c_str(), (int32_t) r.arg32, r.arg32);
+        if (r.arg16 != 0)
+          what += format(", %u bytes received", r.arg16);
+        break;
+      case TIMEOUT:
+        what = format("TIMEOUT  waiting for %s, %u ms since last RX", state(r.arg8, states).c_str(), r.arg32);
+        break;
+      case PUSH:
+        what = format("PUSH     %u bytes, telegram %u", r.arg16, r.arg32);
+        break;
+      default:
+        what = format("event %u  %02x %04x %08x", r.event, r.arg8, r.arg16, r.arg32);
+        break;
+    }
+    lines.push_back(format("%12.3f ms  +%9.3f  ", t / 1000.0, delta / 1000.0) + what);
+  }
+  if (dump.header.count("now"))
+    lines.push_back(format("dumped %.3f ms after the last record", (dump.header_u32("now") - prev) / 1000.0));
+  return lines;
+}
+
+}  // namespace testing
+}  // namespace dlms_cosem
+}  // namespace esphome
@@ -0,0 +1,33 @@
+#pragma once
+
+// Decodes the session trace printed by trace_dump() (see SessionTrace) into a readable timeline
+
+#include "log_dump.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace esphome {
+namespace dlms_cosem {
+namespace testing {
+
+struct TraceRecord {
+  uint32_t time_us;
+  uint8_t event;
+  uint8_t arg8;
+  uint16_t arg16;
+  uint32_t arg32;
+};
+
+std::vector<TraceRecord> trace_records(const LogDump &dump);
+
+// DlmsCosemComponent::State name for the state numbering of a build with state_count states
+const char *trace_state_name(uint32_t state, uint32_t state_count);
+
+// one line per record: time since the first record and since the previous one, event and arguments
+std::vector<std::string> decode_trace(const LogDump &dump);
+
+}  // namespace testing
+}  // namespace dlms_cosem
+}  // namespace esphome